@@ -10,6 +10,7 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  RealTime profile applied at the start of Do.
  *
  * Classification : Unclassified
  *
@@ -43,6 +44,7 @@ using namespace libconfig;
 
 /// Local Includes.
 #include "Barometer.hh"
+#include "RealTime.hh"
 #include "smIPC.hh"
 #include "H5Logger.hh"
 #include "SerialIO.h"
@@ -96,6 +98,7 @@ Barometer::Barometer(const char* ConfigFile) : CObject()
     fIPC        = NULL;
     fIO         = NULL;
     fSerialPort = strdup("/dev/ttyUSB0");
+    fRT         = new RealTime();
 
     if(!ConfigFile)
     {
@@ -171,6 +174,7 @@ Barometer::~Barometer(void)
     free(fConfigFileName);
 
     free(fSerialPort);
+    delete fRT;
 
     /* Clean up */
     delete f5Logger;
@@ -212,6 +216,8 @@ void Barometer::Do(void)
     double                pressure = 0.0;
     GGA                   *pGGA = NULL;
 
+    fRT->Apply();
+
     fRun = true;
     while(fRun)
     {
@@ -401,6 +407,7 @@ bool Barometer::ReadConfiguration(void)
 	MM.lookupValue("Logging",   fLogging);
 	MM.lookupValue("Debug",     Debug);
 	MM.lookupValue("Port",      Port);
+	fRT->ReadConfiguration(MM);
 	SetDebug(Debug);
 
 	free(fSerialPort);
@@ -474,6 +481,7 @@ bool Barometer::WriteConfiguration(void)
     MM.add("Debug",     Setting::TypeInt)     = 0;
     MM.add("Logging",   Setting::TypeBoolean)     = true;
     MM.add("Port",      Setting::TypeString)      = fSerialPort;
+    fRT->WriteConfiguration(MM);
 
     // Write out the new configuration.
     try
@@ -10,6 +10,7 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  RealTime profile from the configuration.
  *
  * Classification : Unclassified
  *
@@ -27,6 +28,7 @@ class FileName;
 class PreciseTime;
 class SerialIO;
 class BARO_IPC;
+class RealTime;
 
 class Barometer : public CObject
 {
@@ -99,6 +101,9 @@ private:
      */
     char            *fConfigFileName;
 
+    /*! Scheduling, affinity and memory locking for the Do loop. */
+    RealTime        *fRT;
+
     /*!
      * Serial IO to sensor. 
      */
@@ -9,6 +9,9 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  Position from GGA_Snap, no LAM. 
+ * 17-Oct-26  CBL  Position from GPS_Fix. 
+ * 17-Oct-26  CBL  GPS_Fix layout checked against the registry. 
  *
  * Classification : Unclassified
  *
@@ -67,6 +70,7 @@ BARO_IPC::BARO_IPC(void) : CObject()
 
     pSM          = NULL;
     pSM_Position = NULL;
+    fFix         = NULL;
     fSM_Filename = NULL;
     fGGA         = NULL;
 
@@ -85,12 +89,14 @@ BARO_IPC::BARO_IPC(void) : CObject()
     }
 
 
-    // Connect to GGA message if available. 
-    pSM_Position = new SharedMem2("GGA"); 
-    if (pSM_Position->CheckError())
+    // Connect to the GPS fix, GGA, if available. 
+    pSM_Position = new SMSnapshot("GPS_Fix"); 
+    if (pSM_Position->CheckError() ||
+	(pSM_Position->RecordSize() != GPSFix::Size()) ||
+	!pSM_Position->Expect(GPSFix::Schema()))
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
-			 "GGA data SM failed.");
+			 "GPS_Fix SM failed.");
 	delete pSM_Position;
 	pSM_Position = 0;
 	SET_DEBUG_STACK;
@@ -98,7 +104,8 @@ BARO_IPC::BARO_IPC(void) : CObject()
     }
     else
     {
-	plogger->Log("# GGA SM successfully attached.\n");
+	plogger->Log("# GPS_Fix SM successfully attached.\n");
+	fFix = new GPSFix();
     }
     fGGA = new GGA();
 
@@ -161,12 +168,12 @@ GGA* BARO_IPC::GetPosition(void) const
     SET_DEBUG_STACK;
     if (fGGA && pSM_Position)
     {
-	/* Is the data "new" */
-	if (pSM_Position->GetLAM())
-	{
-	    pSM_Position->GetData(fGGA->DataPointer());
-	    pSM_Position->ClearLAM();
-	}
+	/*
+	 * Only copies if the generation moved since our last look,
+	 * other readers of GPS_Fix are not affected.
+	 */
+	if (pSM_Position->Get(fFix->Buffer()))
+	    fFix->Unpack(fGGA, NULL, NULL, NULL);
     }
     SET_DEBUG_STACK;
     return fGGA;
@@ -198,6 +205,7 @@ BARO_IPC::~BARO_IPC(void)
     SET_DEBUG_STACK;
     delete pSM;
     delete pSM_Position;
+    delete fFix;
     delete fGGA;
     SET_DEBUG_STACK;
 }
@@ -1,51 +1,244 @@
 """@Commands
-  Interface using the POSIX interface of shared memory for attaching
-  to the commands. This inherits from the base class of
-  SharedMem2.py.
+  Client for the libPiDA SMCommandQueue command queues, GPS_CmdQ by
+  default. Any number of clients can Send at once, each command gets
+  a request ID and its own reply, nothing is overwritten.
 
   Allow the parent process to consume the current filename and
   send commands to the GPS. The starting one is to change filenames.
 
+  Layout, see libPiDA/SMSegment.hh and libPiDA/SMCommandQueue.hh
+     0   uint32 Magic, Type, Version, Reserved, uint64 Size,
+         uint32 Wake, Waiters
+     64  uint64 Tail, Head, uint32 Capacity, Replies
+     128 Capacity request slots of 256 bytes
+         uint64 Seq, uint64 ID, int32 Client, uint32 Length, 232s Text
+         Replies reply slots of 536 bytes
+         uint64 Seq, uint64 ID, int32 Status, uint32 Length, 512s Text
+
+  Claiming a request slot is a compare and swap on Tail, python has
+  no atomics of its own so libatomic is called through ctypes.
+
      Modified  By   Reason
      --------  --   ------
      22-Feb-26 CBL  Original
+     17-Oct-26 CBL  SMCommandQueue GPS_CmdQ in place of the single
+                    GPS_Commands buffer.
+     17-Oct-26 CBL  Acquire fence between the reply copy and the
+                    second Seq load, as SMCommandQueue::Reply.
 
 
   References:
-  https://www.programiz.com/python-programming/inheritance
+  https://pypi.org/project/posix_ipc/
+  https://docs.python.org/3/library/ctypes.html
 
-  Unit Tested: 
+  Unit Tested:
 
  ====================================================================
 """
-from PySM.SharedMem2 import SharedMem2
-import math
-import numpy as np
+import ctypes
+import ctypes.util
+import mmap
+import os
+import platform
+import struct
+import time
+# 3rd party modules
+import posix_ipc
+
+# __atomic memory orders
+_RELAXED = 0
+_ACQUIRE = 2
+_RELEASE = 3
+_SEQ_CST = 5
+
+# futex(2) system call number and FUTEX_WAKE
+_SYS_futex = {'x86_64': 202, 'aarch64': 98,
+              'armv7l': 240, 'armv6l': 240}.get(platform.machine())
+_FUTEX_WAKE = 1
 
-class Commands(SharedMem2):
+
+class _Atomic:
+    """
+    The libatomic calls used here. Looked up by string, written as
+    attributes inside a class python would mangle the __atomic names.
+    """
     def __init__(self):
-        # 512 total bytes used for base class
-        # At the moment this is setup to send messages
-        # not necessarily recieve replies. I should 
-        #
-        params = {'name':'GPS_Commands', 'size': 512, 'server': False}
-        # self is implied when using super.
-        super().__init__(params)
-        self.filename    = 'NONE'
-        self.fSuccess    = False
+        lib = ctypes.CDLL(ctypes.util.find_library('atomic'))
+        self.Load8  = self.Bind(lib, '__atomic_load_8', ctypes.c_uint64,
+                                [ctypes.c_void_p, ctypes.c_int])
+        self.Store8 = self.Bind(lib, '__atomic_store_8', None,
+                                [ctypes.c_void_p, ctypes.c_uint64,
+                                 ctypes.c_int])
+        self.CAS8   = self.Bind(lib, '__atomic_compare_exchange_8',
+                                ctypes.c_bool,
+                                [ctypes.c_void_p, ctypes.c_void_p,
+                                 ctypes.c_uint64, ctypes.c_int, ctypes.c_int])
+        self.Add4   = self.Bind(lib, '__atomic_fetch_add_4', ctypes.c_uint32,
+                                [ctypes.c_void_p, ctypes.c_uint32,
+                                 ctypes.c_int])
+        self.Load4  = self.Bind(lib, '__atomic_load_4', ctypes.c_uint32,
+                                [ctypes.c_void_p, ctypes.c_int])
+        self.Fence  = self.Bind(lib, 'atomic_thread_fence', None,
+                                [ctypes.c_int])
+
+    @staticmethod
+    def Bind(lib, name, restype, argtypes):
+        f = getattr(lib, name)
+        f.restype  = restype
+        f.argtypes = argtypes
+        return f
+
+
+class Commands:
+    MAGIC         = 0x41446950
+    TYPE_COMMAND  = 3
+    VERSION       = 1
+    HEADER        = 64
+    QUEUE_HEADER  = 64
+    REQUEST_SLOT  = 256
+    REPLY_SLOT    = 536
+    COMMAND_TEXT  = 232
+
+    def __init__(self, name='GPS_CmdQ'):
+        """@brief attach to the command queue name.
+        @param name is the name of the queue segment.
+        """
+        self.SM_name  = name
+        self.error    = 0
+        self.Mapfile  = None
+        self.Base     = None
+        self.filename = 'NONE'
+        self.fSuccess = False
+
+        try:
+            memory = posix_ipc.SharedMemory('/' + name)
+            self.Mapfile = mmap.mmap(memory.fd, memory.size)
+            memory.close_fd()
+        except:
+            print('Error attaching to command queue: ', name)
+            self.error = -1
+            return
+
+        magic, seg_type, version = struct.unpack_from('<III', self.Mapfile, 0)
+        if (magic != self.MAGIC or seg_type != self.TYPE_COMMAND or
+            version != self.VERSION):
+            print('Not an SMCommandQueue: ', name)
+            self.error = -2
+            return
+
+        self.Atomic = _Atomic()
+        self.Libc = ctypes.CDLL(None, use_errno=True)
+
+        self.Base = ctypes.addressof(ctypes.c_char.from_buffer(self.Mapfile))
+        queue = self.HEADER
+        self.Tail = self.Base + queue
+        self.Capacity, self.Replies = struct.unpack_from('<II', self.Mapfile,
+                                                         queue + 16)
+        self.Requests = queue + self.QUEUE_HEADER
+        self.ReplyArea = self.Requests + self.Capacity*self.REQUEST_SLOT
 
     def __del__(self):
-        super().__del__()
+        self.Base = None
+        if self.Mapfile is not None:
+            try:
+                self.Mapfile.close()
+            except BufferError:
+                # ctypes still holds the export, let it go with us.
+                pass
+
+    def NoError(self):
+        return (self.error == 0)
+
+    def Notify(self):
+        """ Bump Wake and wake a server blocked in Wait. """
+        wake = self.Base + 24
+        self.Atomic.Add4(wake, 1, _SEQ_CST)
+        if (self.Atomic.Load4(self.Base + 28, _SEQ_CST) != 0 and
+            _SYS_futex is not None):
+            self.Libc.syscall(_SYS_futex, ctypes.c_void_p(wake),
+                              _FUTEX_WAKE, 0x7fffffff, None, None, 0)
+
+    def Send(self, text):
+        """
+        Queue a command.
+        @param text - command string, e.g. 'CF'
+        @return request ID, 0 if the queue is full or not attached.
+        """
+        if self.error != 0:
+            return 0
+        data = text.encode('utf-8')[:self.COMMAND_TEXT-1]
+        pos  = self.Atomic.Load8(self.Tail, _RELAXED)
+        while True:
+            slot = self.Requests + (pos % self.Capacity)*self.REQUEST_SLOT
+            seq  = self.Atomic.Load8(self.Base + slot, _ACQUIRE)
+            if seq == pos:
+                expected = ctypes.c_uint64(pos)
+                if self.Atomic.CAS8(
+                        self.Tail, ctypes.addressof(expected), pos + 1,
+                        _RELAXED, _RELAXED):
+                    break
+                pos = expected.value
+            elif seq < pos:
+                return 0
+            else:
+                pos = self.Atomic.Load8(self.Tail, _RELAXED)
+
+        struct.pack_into('<QiI232s', self.Mapfile, slot + 8,
+                         pos + 1, os.getpid(), len(data), data)
+        self.Atomic.Store8(self.Base + slot, pos + 1, _RELEASE)
+        self.Notify()
+        return pos + 1
 
-    def Read(self):
+    def Reply(self, rid):
         """
-        not sure how to handle this yet to read and replies from commands
+        @param rid - request ID from Send
+        @return (status, text) if the server has answered, else None
         """
-        super().Read()
-        
-        self.UnpackDone()
-        if (self.debug):
-            print("SELF: ",self)
+        if self.error != 0 or rid == 0:
+            return None
+        slot = self.ReplyArea + (rid % self.Replies)*self.REPLY_SLOT
+        for i in range(100):
+            s1 = self.Atomic.Load8(self.Base + slot, _ACQUIRE)
+            if s1 & 1:
+                continue
+            ID, status, length = struct.unpack_from('<QiI', self.Mapfile,
+                                                    slot + 8)
+            text = self.Mapfile[slot+24:slot+24+min(length, 511)]
+            # An acquire load keeps later reads after it, not earlier
+            # ones, the fence keeps the copy ahead of s2.
+            self.Atomic.Fence(_ACQUIRE)
+            s2 = self.Atomic.Load8(self.Base + slot, _RELAXED)
+            if s1 != s2:
+                continue
+            if ID != rid:
+                return None
+            return (status, text.decode('utf-8', 'replace'))
+        return None
+
+    def WaitReply(self, rid, timeout=1.0):
+        """ Poll for the reply to rid, up to timeout seconds. """
+        end = time.monotonic() + timeout
+        while True:
+            rv = self.Reply(rid)
+            if rv is not None or time.monotonic() > end:
+                return rv
+            time.sleep(0.01)
+
+    def Write(self, value, length=0):
+        """
+        Send a command, the interface PiDA.py has always used.
+        length is ignored, kept so callers need not change.
+        """
+        rid = self.Send(value)
+        self.fSuccess = (rid != 0)
+        return rid
+
+    def GetFilename(self, timeout=1.0):
+        """ GF, ask GTOP for the current data file. """
+        rv = self.WaitReply(self.Send('GF'), timeout)
+        if rv is not None and rv[0] == 0:
+            self.filename = rv[1]
+        return self.filename
 
     def Print(self):
         print('Commands')
@@ -56,6 +249,7 @@ class Commands(SharedMem2):
         rep += "     Filename:" + self.filename + "\n"
         rep += " ------------------------------------------------" + "\n"
         return rep
-        
+
 # CF - Change Filename
 # GF - get filename
+# CM - Marker in the H5 file
@@ -6,6 +6,8 @@
      Modified  By   Reason
      --------  --   ------
      15-Dec-23 CBL  Original
+     17-Oct-26 CBL  IMUData::DataSize no longer counts a bool past
+                    the temperature, there never was one to read.
 
 
   References:
@@ -58,7 +60,7 @@ class IMU(SharedMem2):
         self.fGyro[1]    = self.Unpack('d')
         self.fGyro[2]    = self.Unpack('d')
         self.fTemperature= self.Unpack('d')
-        self.fSuccess    = self.Unpack('B')
+        self.fSuccess    = True
         
         self.UnpackDone()
         if (self.debug):
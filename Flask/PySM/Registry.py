@@ -0,0 +1,284 @@
+"""@Registry
+  Python reader for the libPiDA shared memory registry, PiDA_Registry.
+  Every producer lists its segments there with the record layout the
+  compiler worked out, SMSchema, so nothing here hard codes offsets.
+  Entries lists the live segments, Format builds the struct format of
+  a record and Snapshot reads the latest record of an SMSnapshot
+  segment, e.g. IMU_Snap or GPS_Fix, as a dictionary.
+
+  Layout, see libPiDA/SMRegistry.hh
+     0   uint32 Magic, Type, Version, Reserved, uint64 Size,
+         uint32 Wake, Waiters
+     64  uint32 Capacity, EntrySize, uint64 Changes
+     128 Capacity entries of EntrySize bytes
+         0   uint64 Seq, int32 PID, uint32 Type, 32s Segment,
+             24s Record, uint32 RecordSize, SchemaHash, NFields,
+             Reserved, double Rate, uint64 Updates, UpdateTime
+         128 32 fields, 24s Name, uint32 Offset, uint8 Type, Size,
+             uint16 Count
+
+     Modified  By   Reason
+     --------  --   ------
+     17-Oct-26 CBL  Original
+     17-Oct-26 CBL  PID -1, an entry being claimed, is skipped.
+
+
+  References:
+  https://pypi.org/project/posix_ipc/
+  https://docs.python.org/3/library/struct.html
+
+ ====================================================================
+"""
+import mmap
+import os
+import struct
+# 3rd party modules
+import posix_ipc
+
+MAGIC          = 0x41446950
+TYPE_SNAPSHOT  = 2
+TYPE_REGISTRY  = 4
+SEGMENT_TYPES  = {1: 'Ring', 2: 'Snapshot', 3: 'Command', 4: 'Registry'}
+
+# SMField types, with the element size they give the struct code.
+FIELD_BYTES, FIELD_INT, FIELD_UINT, FIELD_FLOAT, FIELD_BOOL, FIELD_CHAR = range(6)
+_CODES = {FIELD_INT:   {1: 'b', 2: 'h', 4: 'i', 8: 'q'},
+          FIELD_UINT:  {1: 'B', 2: 'H', 4: 'I', 8: 'Q'},
+          FIELD_FLOAT: {4: 'f', 8: 'd'},
+          FIELD_BOOL:  {1: '?'}}
+
+_ENTRY = struct.Struct('<QiI32s24sIIIIdQQ')
+_FIELD = struct.Struct('<24sIBBH')
+
+
+def _Text(raw):
+    return raw.split(b'\0', 1)[0].decode('utf-8', 'replace')
+
+
+def _Alive(pid):
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        pass
+    return pid > 0
+
+
+def _Map(name):
+    memory = posix_ipc.SharedMemory('/' + name)
+    try:
+        return mmap.mmap(memory.fd, memory.size)
+    finally:
+        memory.close_fd()
+
+
+def Format(entry):
+    """
+    Struct format and field names of a record.
+    @param entry - from Registry.Entries or Registry.Find
+    @return (format, names), arrays are one name with Count values.
+    """
+    fmt   = '<'
+    names = []
+    at    = 0
+    for f in sorted(entry['Fields'], key=lambda f: f['Offset']):
+        if f['Offset'] > at:
+            fmt += '%dx' % (f['Offset'] - at)
+        if f['Type'] == FIELD_CHAR or f['Type'] == FIELD_BYTES:
+            fmt += '%ds' % (f['Count'] * f['Size'])
+        else:
+            fmt += '%d%s' % (f['Count'], _CODES[f['Type']][f['Size']])
+        names.append((f['Name'], f['Count'], f['Type']))
+        at = f['Offset'] + f['Count'] * f['Size']
+    if entry['RecordSize'] > at:
+        fmt += '%dx' % (entry['RecordSize'] - at)
+    return fmt, names
+
+
+def Decode(entry, data, offset=0):
+    """
+    Unpack one record straight out of data, a buffer or the mmap.
+    @return dictionary, field name to value, arrays as tuples.
+    """
+    fmt, names = Format(entry)
+    values = struct.unpack_from(fmt, data, offset)
+    rv = {}
+    i  = 0
+    for name, count, ftype in names:
+        if ftype == FIELD_CHAR:
+            rv[name] = _Text(values[i])
+            i += 1
+        elif ftype == FIELD_BYTES:
+            rv[name] = values[i]
+            i += 1
+        elif count == 1:
+            rv[name] = values[i]
+            i += 1
+        else:
+            rv[name] = values[i:i+count]
+            i += count
+    return rv
+
+
+class Registry:
+    NAME     = 'PiDA_Registry'
+    VERSION  = 1
+    HEADER   = 64
+
+    def __init__(self):
+        """@brief attach to the registry. """
+        self.error   = 0
+        self.Mapfile = None
+        try:
+            self.Mapfile = _Map(self.NAME)
+        except:
+            print('Error attaching to registry: ', self.NAME)
+            self.error = -1
+            return
+        magic, seg_type, version = struct.unpack_from('<III', self.Mapfile, 0)
+        if (magic != MAGIC or seg_type != TYPE_REGISTRY or
+            version != self.VERSION):
+            print('Not an SMRegistry: ', self.NAME)
+            self.error = -2
+            return
+        self.Capacity, self.EntrySize = struct.unpack_from('<II', self.Mapfile,
+                                                           self.HEADER)
+        self.Entries0 = 2*self.HEADER
+
+    def __del__(self):
+        if self.Mapfile is not None:
+            self.Mapfile.close()
+
+    def NoError(self):
+        return (self.error == 0)
+
+    def Changes(self):
+        """ Adds and Removes so far. """
+        return struct.unpack_from('<Q', self.Mapfile, self.HEADER + 8)[0]
+
+    def Entry(self, index):
+        """
+        Seqlock read of one entry.
+        @return dictionary, None if free or its producer is gone.
+        """
+        at = self.Entries0 + index*self.EntrySize
+        for i in range(100):
+            s1 = struct.unpack_from('<Q', self.Mapfile, at)[0]
+            if s1 & 1:
+                continue
+            raw = self.Mapfile[at:at+self.EntrySize]
+            s2 = struct.unpack_from('<Q', self.Mapfile, at)[0]
+            if s1 == s2:
+                break
+        else:
+            return None
+
+        (seq, pid, seg_type, segment, record, size, schema_hash, nfields,
+         reserved, rate, updates, update_time) = _ENTRY.unpack_from(raw, 0)
+        # -1 is an entry being claimed, kClaiming.
+        if pid <= 0 or not _Alive(pid):
+            return None
+        fields = []
+        for k in range(min(nfields, 32)):
+            name, offset, ftype, fsize, count = _FIELD.unpack_from(raw,
+                                                                   128 + 32*k)
+            fields.append({'Name': _Text(name), 'Offset': offset,
+                           'Type': ftype, 'Size': fsize, 'Count': count})
+        return {'Segment': _Text(segment), 'Record': _Text(record),
+                'PID': pid, 'Type': SEGMENT_TYPES.get(seg_type, seg_type),
+                'RecordSize': size, 'SchemaHash': schema_hash,
+                'Rate': rate, 'Updates': updates,
+                'UpdateTime': update_time*1.0e-9, 'Fields': fields}
+
+    def Entries(self):
+        """ Every live segment. """
+        if self.error != 0:
+            return []
+        rv = []
+        for i in range(self.Capacity):
+            e = self.Entry(i)
+            if e is not None:
+                rv.append(e)
+        return rv
+
+    def Find(self, segment):
+        """ The live entry of segment, None if not registered. """
+        for e in self.Entries():
+            if e['Segment'] == segment:
+                return e
+        return None
+
+    def Print(self):
+        print('Registry')
+        for e in self.Entries():
+            print(' %-12s %-8s %-8s %5d bytes %6.1f Hz %8d updates pid %d' %
+                  (e['Segment'], e['Type'], e['Record'], e['RecordSize'],
+                   e['Rate'], e['Updates'], e['PID']))
+
+
+class Snapshot:
+    """
+    Latest record of an SMSnapshot segment, decoded with the layout
+    its producer registered.
+    """
+    SNAP_HEADER = 64
+    VERSION     = 2
+
+    def __init__(self, segment, registry=None):
+        self.SM_name = segment
+        self.error   = 0
+        self.Mapfile = None
+        self.Last    = 0
+        registry = registry or Registry()
+        self.Entry = registry.Find(segment) if registry.NoError() else None
+        if self.Entry is None:
+            print('Not registered: ', segment)
+            self.error = -1
+            return
+        try:
+            self.Mapfile = _Map(segment)
+        except:
+            print('Error attaching to snapshot: ', segment)
+            self.error = -2
+            return
+        magic, seg_type, version = struct.unpack_from('<III', self.Mapfile, 0)
+        size = struct.unpack_from('<I', self.Mapfile, 64 + 16)[0]
+        if (magic != MAGIC or seg_type != TYPE_SNAPSHOT or
+            version != self.VERSION or size != self.Entry['RecordSize']):
+            print('Snapshot does not match its registry entry: ', segment)
+            self.error = -3
+            return
+        self.Record = 64 + self.SNAP_HEADER
+
+    def __del__(self):
+        if self.Mapfile is not None:
+            self.Mapfile.close()
+
+    def NoError(self):
+        return (self.error == 0)
+
+    def Generation(self):
+        return struct.unpack_from('<Q', self.Mapfile, 64)[0] >> 1
+
+    def IsNew(self):
+        return self.Generation() != self.Last
+
+    def Read(self):
+        """
+        Decode the record between two reads of Seq, again if a Put
+        overlapped it.
+        @return dictionary, None if the producer kept it busy.
+        """
+        if self.error != 0:
+            return None
+        for i in range(100):
+            s1 = struct.unpack_from('<Q', self.Mapfile, 64)[0]
+            if s1 & 1:
+                continue
+            rv = Decode(self.Entry, self.Mapfile, self.Record)
+            s2 = struct.unpack_from('<Q', self.Mapfile, 64)[0]
+            if s1 == s2:
+                self.Last = s1 >> 1
+                return rv
+        return None
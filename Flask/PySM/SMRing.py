@@ -0,0 +1,131 @@
+"""@SMRing
+  Python reader for the libPiDA SMRing shared memory rings, for
+  example IMU_Ring, GGA_Ring and RMC_Ring. Each reader keeps its own
+  cursor, Read returns every record written since the last call and
+  Missed counts the ones the producer overwrote first. Nothing is
+  written to the segment and no semaphore is used.
+
+  Layout, see libPiDA/SMSegment.hh and libPiDA/SMRing.hh
+     0   uint32 Magic, Type, Version, Reserved, uint64 Size
+     64  uint64 WriteSeq, uint32 RecordSize, Capacity, SlotSize
+     128 Capacity slots, uint64 Seq then the record
+
+     Modified  By   Reason
+     --------  --   ------
+     17-Oct-26 CBL  Original
+
+
+  References:
+  https://pypi.org/project/posix_ipc/
+
+ ====================================================================
+"""
+import mmap
+import struct
+# 3rd party modules
+import posix_ipc
+
+
+class SMRing:
+    MAGIC        = 0x41446950
+    TYPE_RING    = 1
+    VERSION      = 1
+    HEADER       = 64
+    RING_HEADER  = 64
+
+    def __init__(self, name):
+        """@brief attach to the ring name, the cursor starts at the
+        next record written.
+        @param name is the name of the ring segment.
+        """
+        self.SM_name  = name
+        self.error    = 0
+        self.Mapfile  = None
+        self.Cursor   = 0
+        self.Missed   = 0
+
+        try:
+            memory = posix_ipc.SharedMemory('/' + name)
+            self.Mapfile = mmap.mmap(memory.fd, memory.size)
+            memory.close_fd()
+        except:
+            print('Error attaching to ring: ', name)
+            self.error = -1
+            return
+
+        magic, seg_type, version = struct.unpack_from('<III', self.Mapfile, 0)
+        if (magic != self.MAGIC or seg_type != self.TYPE_RING or
+            version != self.VERSION):
+            print('Not an SMRing: ', name)
+            self.error = -2
+            return
+
+        base = self.HEADER
+        (self.RecordSize, self.Capacity,
+         self.SlotSize) = struct.unpack_from('<III', self.Mapfile, base + 8)
+        self.Slots = base + self.RING_HEADER
+        self.Cursor = self.WriteSeq()
+
+    def __del__(self):
+        if self.Mapfile is not None:
+            self.Mapfile.close()
+
+    def NoError(self):
+        return (self.error == 0)
+
+    def WriteSeq(self):
+        """ Records written by the producer. """
+        return struct.unpack_from('<Q', self.Mapfile, self.HEADER)[0]
+
+    def SeekOldest(self):
+        """ Back up to the oldest record still in the ring. """
+        w = self.WriteSeq()
+        self.Cursor = max(0, w - self.Capacity)
+
+    def Read(self, limit=None):
+        """
+        Return a list of the records, as bytes, written since the
+        last Read, oldest first. At most limit if given.
+        """
+        rv = []
+        while (limit is None) or (len(rv) < limit):
+            w = self.WriteSeq()
+            if self.Cursor >= w:
+                self.Cursor = w
+                break
+            if w - self.Cursor > self.Capacity:
+                self.Missed += w - self.Cursor - self.Capacity
+                self.Cursor  = w - self.Capacity
+            slot = self.Slots + (self.Cursor % self.Capacity)*self.SlotSize
+            s1   = struct.unpack_from('<Q', self.Mapfile, slot)[0]
+            data = None
+            if s1 == 2*self.Cursor + 2:
+                data = self.Mapfile[slot+8:slot+8+self.RecordSize]
+                s2   = struct.unpack_from('<Q', self.Mapfile, slot)[0]
+                if s2 != s1:
+                    data = None
+            self.Cursor += 1
+            if data is None:
+                self.Missed += 1
+            else:
+                rv.append(data)
+        return rv
+
+
+class IMURing(SMRing):
+    """
+    IMU_Ring, IMURaw records, see ICM-20948/IMURaw.hh
+    Each record is returned as
+    (time ns, (ax,ay,az), (gx,gy,gz), (mx,my,mz), temp, flags) in counts.
+    """
+    FORMAT = '<Q3h3h3hhH'
+
+    def __init__(self):
+        super().__init__('IMU_Ring')
+
+    def Samples(self, limit=None):
+        rv = []
+        for r in self.Read(limit):
+            v = struct.unpack(self.FORMAT, r)
+            rv.append((v[0], v[1:4], v[4:7], v[7:10], v[10], v[11]))
+        return rv
@@ -0,0 +1,197 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : GPSFix.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : One GPS epoch, the GGA, GSA, VTG and RMC that GTOP
+ *     publishes together in a single Update, packed into one record
+ *     so a reader gets all four from the same epoch with one read
+ *     of the GPS_Fix segment.
+ *
+ *     Record layout,
+ *
+ *         offset  0  uint32 Version  kVersion
+ *                 4  uint32 Mask     kFixGGA | kFixGSA | ... present
+ *                 8  uint64 Epoch    GTOP update count
+ *                16  uint64 RxRealTime  ns, CLOCK_REALTIME and
+ *                24  uint64 RxMonotonic CLOCK_MONOTONIC when the
+ *                                       first byte of the GGA was read
+ *                32  GGA data, GGA::DataSize() bytes
+ *                    GSA data
+ *                    VTG data
+ *                    RMC data
+ *
+ *     A message not present in the epoch is zero filled and its
+ *     Mask bit is clear, Unpack leaves the caller's copy alone.
+ *
+ * Restrictions/Limitations :
+ *     Same NMEA library, and so the same DataSize, on both sides.
+ *     Readers check Size() against the segment record size.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Schema for the registry. 
+ * 17-Oct-26  CBL  Receive stamps of the GGA, version 2. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __GPSFIX_hh_
+#define __GPSFIX_hh_
+#    include <stdint.h>
+#    include <cstring>
+#    include <time.h>
+#    include "NMEA_GPS.hh"
+#    include "SMSchema.hh"
+
+/// GPSFix - pack and unpack one epoch of NMEA messages.
+class GPSFix {
+public:
+    /*! Record layout version, bump on any change above. */
+    static const uint32_t kVersion = 2;
+
+    /*! Mask bits */
+    enum {kFixGGA=0x01, kFixGSA=0x02, kFixVTG=0x04, kFixRMC=0x08};
+
+    /*! Bytes in the packed record. */
+    static inline size_t Size(void)
+	{return sizeof(Header) + GGA::DataSize() + GSA::DataSize() +
+		VTG::DataSize() + RMC::DataSize();};
+
+    /*! Record layout, the NMEA messages as opaque bytes. */
+    static inline const SMSchema& Schema(void)
+	{
+	    static const size_t GSAAt = sizeof(Header) + GGA::DataSize();
+	    static const size_t VTGAt = GSAAt + GSA::DataSize();
+	    static const size_t RMCAt = VTGAt + VTG::DataSize();
+	    static const SMField kFields[] = {
+		SM_MEMBER(Header, Version, "Version"),
+		SM_MEMBER(Header, Mask,    "Mask"),
+		SM_MEMBER(Header, Epoch,   "Epoch"),
+		SM_MEMBER(Header, RxRealTime,  "RxRealTime"),
+		SM_MEMBER(Header, RxMonotonic, "RxMonotonic"),
+		SM_BYTES("GGA", sizeof(Header), GGA::DataSize()),
+		SM_BYTES("GSA", GSAAt, GSA::DataSize()),
+		SM_BYTES("VTG", VTGAt, VTG::DataSize()),
+		SM_BYTES("RMC", RMCAt, RMC::DataSize()),
+	    };
+	    static const SMSchema kSchema("GPSFix", kFields,
+					  SM_NFIELDS(kFields));
+	    return kSchema;
+	};
+
+    GPSFix(void) {fBuffer = new uint8_t[Size()]; memset(fBuffer, 0, Size());};
+    ~GPSFix(void) {delete [] fBuffer;};
+
+    /*! The packed record, hand it to Put or Get. */
+    inline uint8_t* Buffer(void) {return fBuffer;};
+
+    /*! Epoch and Mask of the record in the buffer. */
+    inline uint64_t Epoch(void) const {return Head()->Epoch;};
+    inline uint32_t Mask(void)  const {return Head()->Mask;};
+    /*! First byte of the GGA read, ns, 0 if not known. */
+    inline uint64_t RxRealTime(void)  const {return Head()->RxRealTime;};
+    inline uint64_t RxMonotonic(void) const {return Head()->RxMonotonic;};
+
+    /*!
+     * Description:
+     *   Producer. Pack one epoch, any message may be NULL.
+     *
+     * Arguments:
+     *   Epoch - update count
+     *   pGGA, pGSA, pVTG, pRMC - the messages of this epoch
+     *   RxReal, RxMono - first byte of the GGA read, may be NULL
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE
+     */
+    inline void Pack(uint64_t Epoch, GGA *pGGA, GSA *pGSA, VTG *pVTG,
+		     RMC *pRMC, const struct timespec *RxReal = NULL,
+		     const struct timespec *RxMono = NULL)
+	{
+	    uint8_t *p = fBuffer + sizeof(Header);
+	    Head()->Version     = kVersion;
+	    Head()->Mask        = 0;
+	    Head()->Epoch       = Epoch;
+	    Head()->RxRealTime  = NS(RxReal);
+	    Head()->RxMonotonic = NS(RxMono);
+	    Copy(p, pGGA ? pGGA->DataPointer() : NULL, GGA::DataSize(), kFixGGA);
+	    Copy(p, pGSA ? pGSA->DataPointer() : NULL, GSA::DataSize(), kFixGSA);
+	    Copy(p, pVTG ? pVTG->DataPointer() : NULL, VTG::DataSize(), kFixVTG);
+	    Copy(p, pRMC ? pRMC->DataPointer() : NULL, RMC::DataSize(), kFixRMC);
+	};
+
+    /*!
+     * Description:
+     *   Consumer. Copy the messages present in the buffer out to
+     *   the caller's objects, any of which may be NULL.
+     *
+     * Arguments:
+     *   pGGA, pGSA, pVTG, pRMC - destinations
+     *
+     * Returns:
+     *   false if the record is a different layout version.
+     *
+     * Errors:
+     *   NONE
+     */
+    inline bool Unpack(GGA *pGGA, GSA *pGSA, VTG *pVTG, RMC *pRMC) const
+	{
+	    const uint8_t *p = fBuffer + sizeof(Header);
+	    if (Head()->Version != kVersion)
+		return false;
+	    Extract(p, pGGA ? pGGA->DataPointer() : NULL, GGA::DataSize(), kFixGGA);
+	    Extract(p, pGSA ? pGSA->DataPointer() : NULL, GSA::DataSize(), kFixGSA);
+	    Extract(p, pVTG ? pVTG->DataPointer() : NULL, VTG::DataSize(), kFixVTG);
+	    Extract(p, pRMC ? pRMC->DataPointer() : NULL, RMC::DataSize(), kFixRMC);
+	    return true;
+	};
+
+private:
+    struct Header {
+	uint32_t Version;
+	uint32_t Mask;
+	uint64_t Epoch;
+	uint64_t RxRealTime;
+	uint64_t RxMonotonic;
+    };
+    uint8_t *fBuffer;
+
+    inline Header* Head(void) const {return (Header *) fBuffer;};
+
+    static inline uint64_t NS(const struct timespec *t)
+	{return t ? (uint64_t) t->tv_sec*1000000000ULL + t->tv_nsec : 0;};
+
+    inline void Copy(uint8_t *&p, void *Src, size_t n, uint32_t Bit)
+	{
+	    if (Src)
+	    {
+		memcpy(p, Src, n);
+		Head()->Mask |= Bit;
+	    }
+	    else
+	    {
+		memset(p, 0, n);
+	    }
+	    p += n;
+	};
+    inline void Extract(const uint8_t *&p, void *Dst, size_t n,
+			uint32_t Bit) const
+	{
+	    if (Dst && (Head()->Mask & Bit))
+		memcpy(Dst, p, n);
+	    p += n;
+	};
+
+    // Owns the buffer, no copies.
+    GPSFix(const GPSFix&);
+    GPSFix& operator=(const GPSFix&);
+};
+#endif
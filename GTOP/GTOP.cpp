@@ -22,6 +22,28 @@
  * 15-Nov-25    There have been some upgrades in the general NMEA_LIB
  * 07-Feb-26    Enable forced update in file number. 
  * 18-Mar-26    Put FLAG in H5 file
+ * 17-Oct-26    RealTime profile applied at the start of Do. 
+ * 17-Oct-26    Commands taken every pass of Do, not per fix. 
+ * 17-Oct-26    SerialFramer, a read per burst and sentences split in
+ *              place, replaces a read and a string copy per byte. 
+ * 17-Oct-26    Do blocks in epoll on the serial port, a timerfd for
+ *              commands and file roll over and a signalfd, each
+ *              sentence is parsed as soon as its '\n' arrives. 
+ * 17-Oct-26    Sentences checked by NMEASentence, bad checksums never
+ *              reach the parser, counts by type logged at the end. 
+ * 17-Oct-26    BaudRate and FixRate in the configuration, PMTK 
+ *              negotiates them once the port is open. 
+ * 17-Oct-26    No PMTK negotiation at the factory 9600 baud, 1 Hz. 
+ * 17-Oct-26    RXTIME resolution stated correctly. 
+ * 17-Oct-26    OpenEvents checks the timer and its epoll_ctl calls. 
+ * 17-Oct-26    GGA stamped when its first byte was read, RXTIME and
+ *              RXDT in the H5 file, the stamps go out in GPS_Fix. 
+ * 17-Oct-26    PPSDevice in the configuration, each kernel PPS edge
+ *              is paired with the next GGA and put in GPS_PPS. 
+ * 17-Oct-26    NMEA file written by NMEAArchive on its own thread, 
+ *              flushed once a second, optionally gzipped. Nothing is
+ *              written when LogNMEA is off, it used to go to an 
+ *              unopened stream. 
  * 
  * Classification : Unclassified
  *
@@ -42,6 +64,10 @@ using namespace std;
 #include <cstring>
 #include <cmath>
 #include <csignal>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
 #include <libconfig.h++>
 using namespace libconfig;
 
@@ -54,12 +80,18 @@ using namespace libconfig;
 #include "smIPC.hh"
 #include "EventCounter.hh"
 #include "serial.h"
+#include "RealTime.hh"
+#include "UserSignals.hh"
+#include "PMTK.hh"
+#include "PPS.hh"
+#include "NMEAArchive.hh"
 
 GTOP* GTOP::fGTOP;
 
 const char *SensorName="GPS";     // Sensor name. 
-const size_t NVar = 18;
-const size_t kMAXCHARCOUNT = 256;
+const size_t NVar = 20;
+/*! Timer tick, commands and file roll over are checked this often. */
+const long   kTickMS = 100;
 /**
  ******************************************************************
  *
@@ -92,10 +124,15 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
 
     /* Serial port is not yet open. */
     fNMEA_GPS  = NULL;
+    fFramer    = NULL;
+    fEpoll     = -1;
+    fTimer     = -1;
+    fSignal    = -1;
     fIPC       = NULL;
     fn         = NULL;
     f5Logger   = NULL;
     fConfigFileName = ConfigFile;
+    fRT        = new RealTime();
 
     /* Set some defaults. */
     fLatitude  = 41.3084;
@@ -107,6 +144,14 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
     fDisplay   = false;
     fResetType = 0;
     fLogNMEA   = false;
+    fNMEACompress = false;
+    fArchive   = NULL;
+    fnNMEA     = NULL;
+    fBaudRate  = 9600;
+    fFixRate   = 1;
+    fActualRate = 1.0;
+    fPPSDevice = "";
+    fPPS       = NULL;
 
     fGeoLatitude  = 41.3084;
     fGeoLongitude = -73.893;
@@ -143,7 +188,34 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
     {
         Logger->Log("# Opened serial port: %s\n", fSerialPortName.c_str());
 	fNMEA_GPS = new NMEA_GPS();
-	fCurrentLine.str("");
+	fFramer   = new SerialFramer(GetSerial_fd());
+	fCurrentLine.Data   = "";
+	fCurrentLine.Length = 0;
+	memset(&fGGARealTime,  0, sizeof(fGGARealTime));
+	memset(&fGGAMonotonic, 0, sizeof(fGGAMonotonic));
+	if (fFramer->CheckError())
+	{
+	    SetError(-1);
+	    return;
+	}
+	/*
+	 * Port speed and fix rate from the configuration. Falls back
+	 * to what the receiver will do, never fatal. At the factory
+	 * 9600 baud, 1 Hz the receiver is left as it is, no probing 
+	 * and its sentence set untouched. A receiver kept at another
+	 * speed by its backup battery needs BaudRate set to match.
+	 */
+	if ((fBaudRate != 9600) || (fFixRate != 1))
+	{
+	    PMTK Negotiate(fFramer);
+	    Negotiate.SetDebug(fDebug);
+	    Negotiate.Negotiate(fBaudRate, fFixRate);
+	    fActualRate = Negotiate.FixRate();
+	}
+	else
+	{
+	    fActualRate = 1.0;
+	}
     }
 
     /*
@@ -159,6 +231,7 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
 	SetError(-2); 
 	return;
     }
+    fIPC->SetRate(fActualRate);
     fEVCounter = new EventCounter(true);
     if(fEVCounter->Error() != 0)
     {
@@ -177,6 +250,25 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
     fEVCounter = NULL;
 #endif
 
+    /*
+     * PPS is optional, without it GTOP runs as before. 
+     */
+    if (fPPSDevice.length() > 0)
+    {
+	fPPS = new PPS(fPPSDevice.c_str());
+	if (fPPS->CheckError())
+	{
+	    Logger->LogError(__FILE__, __LINE__, 'W',
+			     "PPS not available, continuing without.");
+	    delete fPPS;
+	    fPPS = NULL;
+	}
+	else if (fIPC)
+	{
+	    fIPC->EnablePPS();
+	}
+    }
+
     if (fLogging)
     {
 	fn = new FileName("GTop", "h5", One_Day);
@@ -184,8 +276,15 @@ GTOP::GTOP(const string& ConfigFile) : CObject()
     }
     if (fLogNMEA)
     {
-	fnNMEA = new FileName("GTop","NMEA", One_Day);
-	fNMEAfd = ofstream(fnNMEA->GetName());
+	fnNMEA   = new FileName("GTop","NMEA", One_Day);
+	fArchive = new NMEAArchive(fnNMEA->GetName(), fNMEACompress);
+	if (fArchive->CheckError())
+	{
+	    Logger->LogError(__FILE__, __LINE__, 'W',
+			     "NMEA archive failed, not logging NMEA.");
+	    delete fArchive;
+	    fArchive = NULL;
+	}
     }
 
     SET_DEBUG_STACK;
@@ -229,6 +328,8 @@ GTOP::~GTOP(void)
 		       "Failed to write config file.\n");
     }
 
+    delete fRT;
+
     /* Shut down logging. */
     pLog->LogTime("stop logging\n");
     delete f5Logger;
@@ -238,12 +339,52 @@ GTOP::~GTOP(void)
     pLog->LogTime("Close up IPC\n");
     delete fIPC;
 
-    if (fLogNMEA)
+    // Writes out what is queued and closes the file. 
+    delete fArchive;
+    delete fnNMEA;
+    if (fFramer)
+    {
+	pLog->Log("# Serial %llu reads, %llu bytes, %llu lines, %llu overflows\n",
+		  (unsigned long long) fFramer->Reads(),
+		  (unsigned long long) fFramer->Bytes(),
+		  (unsigned long long) fFramer->Lines(),
+		  (unsigned long long) fFramer->Overflows());
+    }
+    for (int i = 0; i < NMEASentence::kNTypes; i++)
+    {
+	if (fSentence.Accepted(i) || fSentence.Rejected(i))
+	{
+	    pLog->Log("# NMEA %-5s %llu accepted, %llu rejected\n",
+		      NMEASentence::TypeName(i),
+		      (unsigned long long) fSentence.Accepted(i),
+		      (unsigned long long) fSentence.Rejected(i));
+	}
+    }
+    for (int i = 1; i < NMEASentence::kNReasons; i++)
     {
-	fNMEAfd.close();
-	delete fnNMEA;
+	if (fSentence.Reasons(i))
+	{
+	    pLog->Log("# NMEA rejected, %s %llu\n",
+		      NMEASentence::ReasonName(i),
+		      (unsigned long long) fSentence.Reasons(i));
+	}
     }
+    if (fPPS)
+    {
+	pLog->Log("# PPS %llu edges, %llu paired, %llu stale\n",
+		  (unsigned long long) fPPS->Edges(),
+		  (unsigned long long) fPPS->Paired(),
+		  (unsigned long long) fPPS->Stale());
+	delete fPPS;
+    }
+    delete fFramer;
     delete fNMEA_GPS;
+    if (fEpoll >= 0)
+	close(fEpoll);
+    if (fTimer >= 0)
+	close(fTimer);
+    if (fSignal >= 0)
+	close(fSignal);
 
     pLog->LogTime(" GTOP closed.\n");
     SET_DEBUG_STACK;
@@ -295,13 +436,17 @@ void GTOP::UpdateFileName(void)
  *
  * Function Name : Read
  *
- * Description : Read a character at a time.
+ * Description : Hand the next complete sentence already in the 
+ *     framer buffer to the parser, once NMEASentence has checked
+ *     it. No copy is made on the way. 
  *
- * Inputs :
+ * Inputs : NONE
  *
- * Returns :
+ * Returns : true if a sentence was parsed, fCurrentLine is it.
+ *     A GGA also sets fGGARealTime and fGGAMonotonic and is paired
+ *     with the last PPS edge. 
  *
- * Error Conditions :
+ * Error Conditions : bad sentences are skipped, counted in fSentence
  * 
  * Unit Tested on: 
  *
@@ -313,47 +458,253 @@ void GTOP::UpdateFileName(void)
 bool GTOP::Read(void)
 {
     SET_DEBUG_STACK;
-    const struct timespec sleeptime = {0L, 100000000L};
-    bool rv = false;
+    while (fFramer->Next(fCurrentLine))
+    {
+	if (fSentence.Parse(fCurrentLine.Data, fCurrentLine.Length))
+	{
+	    // The GGA opens the epoch, its arrival is the one kept. 
+	    if (fSentence.Type() == NMEASentence::kGGA)
+	    {
+		fGGARealTime  = fCurrentLine.RealTime;
+		fGGAMonotonic = fCurrentLine.Monotonic;
+	    }
+	    fNMEA_GPS->parse(fCurrentLine.Data);
+	    if (fPPS && (fSentence.Type() == NMEASentence::kGGA))
+	    {
+		PPSEdge();
+	    }
+	    return true;
+	}
+	if (fDebug)
+	{
+	    CLogger::GetThis()->Log("# NMEA %s: %s\n",
+			    NMEASentence::ReasonName(fSentence.Reason()),
+			    fCurrentLine.Data);
+	}
+    }
+    SET_DEBUG_STACK;
+    return false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Sentence
+ *
+ * Description : Log the sentence just parsed, publish the fix on 
+ *     the VTG that ends each epoch and update the display. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void GTOP::Sentence(void)
+{
+    SET_DEBUG_STACK;
+    GTOP_Display *pDisp  = GTOP_Display::GetThis();
 
-    // Loop over the serial port until we get a full line. 
-    char c = 0;
-    size_t n = read(GetSerial_fd(), &c, 1);
-    if (n == 0)
+    // Queued for the archive thread, never waits on the card. 
+    if (fArchive)
     {
-	nanosleep( &sleeptime, NULL);
-	rv = false;
+	fArchive->Append(fCurrentLine.Data, fCurrentLine.Length);
     }
-    else if (c == '\n') 
+    // This is the last message in the read sequence. 
+    if(fNMEA_GPS->LastID() == NMEA_GPS::kMESSAGE_VTG)
     {
-	// Represents an end of line. Null terminate then decode. 
-	// go ahead and decode what we have.
-	fNMEA_GPS->parse(fCurrentLine.str().c_str());
-	rv = true;
+	// VTG message is the last in the series. 
+	Update();
     }
-    else
+    if (pDisp != NULL)
+    {
+	pDisp->Update(fNMEA_GPS, fCurrentLine.Data);
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : PPSEdge
+ *
+ * Description : The GGA just parsed names the second the last PPS 
+ *     edge started, put the pair in GPS_PPS. Its whole seconds are
+ *     corrected for the time zone as PCDT is, see GPSDelta. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void GTOP::PPSEdge(void)
+{
+    SET_DEBUG_STACK;
+    const GGA *pGGA = fNMEA_GPS->pGGA();
+    PPSTime   Rec;
+
+    if (fPPS->Pair(fGGARealTime, (int64_t) pGGA->Seconds() - timezone,
+		   pGGA->Milli(), Rec))
+    {
+	if (fIPC)
+	{
+	    fIPC->PutPPS(Rec);
+	}
+	if (fDebug)
+	{
+	    CLogger::GetThis()->Log("# PPS %llu offset %lld ns, latency %lld ns\n",
+				    (unsigned long long) Rec.Sequence,
+				    (long long) Rec.Offset,
+				    (long long) Rec.Latency);
+	}
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Tick
+ *
+ * Description : Every kTickMS, roll the log files over if their 
+ *     interval is up and take any commands. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void GTOP::Tick(void)
+{
+    SET_DEBUG_STACK;
+    /* Check to see if the logging interval has rolled over. */
+    if (fn && fn->ChangeNames())
+    {
+	UpdateFileName();
+    }
+    if (fArchive && fnNMEA->ChangeNames())
+    {
+	fArchive->Rotate(fnNMEA->GetName());
+    }
+    // Commands are taken as they come, not once per fix. 
+    if (fIPC)
+    {
+	fIPC->ProcessCommands();
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : OpenEvents
+ *
+ * Description : An epoll set with the serial port, a kTickMS 
+ *     periodic timerfd and a signalfd for LoopSignals. SetSignals
+ *     blocked SIGUSR1 and SIGUSR2, SIGTERM and SIGINT are blocked 
+ *     here, until now they went to Terminate so the PMTK setup 
+ *     could be interrupted. The other threads started with them 
+ *     blocked, so they all come to the signalfd. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : logged
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool GTOP::OpenEvents(void)
+{
+    SET_DEBUG_STACK;
+    CLogger           *Logger = CLogger::GetThis();
+    struct itimerspec Period;
+    struct epoll_event ev;
+    sigset_t          Set;
+
+    fEpoll  = epoll_create1(EPOLL_CLOEXEC);
+    fTimer  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    LoopSignals(&Set);
+    pthread_sigmask(SIG_BLOCK, &Set, NULL);
+    fSignal = signalfd(-1, &Set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if ((fEpoll < 0) || (fTimer < 0) || (fSignal < 0))
+    {
+	Logger->Log("# GTOP event setup: %s\n", strerror(errno));
+	return false;
+    }
+
+    Period.it_interval.tv_sec  = kTickMS / 1000;
+    Period.it_interval.tv_nsec = (kTickMS % 1000) * 1000000L;
+    Period.it_value            = Period.it_interval;
+    if (timerfd_settime(fTimer, 0, &Period, NULL) < 0)
     {
-	/// buffer overflow situation. 
-	fCurrentLine << c;
-	if (fCurrentLine.str().length() >= kMAXCHARCOUNT)
-	    rv=false;
+	Logger->Log("# GTOP timer: %s\n", strerror(errno));
+	return false;
     }
 
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN;
+    ev.data.fd = fFramer->fd();
+    if (epoll_ctl(fEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0)
+    {
+	Logger->Log("# GTOP epoll serial: %s\n", strerror(errno));
+	return false;
+    }
+    ev.data.fd = fTimer;
+    if (epoll_ctl(fEpoll, EPOLL_CTL_ADD, fTimer, &ev) < 0)
+    {
+	Logger->Log("# GTOP epoll timer: %s\n", strerror(errno));
+	return false;
+    }
+    ev.data.fd = fSignal;
+    if (epoll_ctl(fEpoll, EPOLL_CTL_ADD, fSignal, &ev) < 0)
+    {
+	Logger->Log("# GTOP epoll signal: %s\n", strerror(errno));
+	return false;
+    }
     SET_DEBUG_STACK;
-    return rv;
+    return true;
 }
 /**
  ******************************************************************
  *
  * Function Name : Do
  *
- * Description : Doesn't doo much as you can see. 
+ * Description : Block in epoll until the serial port, the tick 
+ *     timer or a signal needs attention. Every sentence in a burst
+ *     is handled the moment its read returns. SIGUSR1 and SIGUSR2
+ *     go through UserSignal as before, SIGTERM and SIGINT stop 
+ *     the loop so the caller can clean up. 
  *
- * Inputs :
+ * Inputs : NONE
  *
- * Returns :
+ * Returns : NONE
  *
- * Error Conditions :
+ * Error Conditions : Loop ends if the events can not be set up.
  * 
  * Unit Tested on: 
  *
@@ -364,51 +715,116 @@ bool GTOP::Read(void)
  */
 void GTOP::Do(void)
 {
-    //const struct timespec sleeptime = {0L, 100000000L};
     SET_DEBUG_STACK;
     CLogger      *Logger = CLogger::GetThis();
-    GTOP_Display *pDisp  = GTOP_Display::GetThis();
+    struct epoll_event     Events[4];
+    struct signalfd_siginfo Info;
+    uint64_t     Expired;
+    int          i, n;
+
+    if (!OpenEvents())
+    {
+	return;
+    }
+
+    // Display thread is already running, it stays SCHED_OTHER. 
+    fRT->Apply();
 
     fRun = true;
     while( fRun)
     {
-	/* Check to see if the logging interval has rolled over. */
-	if (fn->ChangeNames())
+	n = epoll_wait(fEpoll, Events, 4, -1);
+	if (n < 0)
 	{
-	    UpdateFileName();
+	    if (errno == EINTR)
+		continue;
+	    Logger->Log("# GTOP epoll_wait: %s\n", strerror(errno));
+	    break;
 	}
-	if (fLogNMEA)
+	for (i = 0; i < n; i++)
 	{
-	    if (fnNMEA->ChangeNames())
+	    if (Events[i].data.fd == fFramer->fd())
 	    {
-		fNMEAfd.close();
-		fNMEAfd.open(fnNMEA->GetName());
+		if (fFramer->Fill() < 0)
+		{
+		    // Port gone, stop listening rather than spin on it.
+		    epoll_ctl(fEpoll, EPOLL_CTL_DEL, fFramer->fd(), NULL);
+		}
+		while (Read())
+		{
+		    Sentence();
+		}
 	    }
-	}
-	// Read serial data until we have a full sentance terminated with a \n
-	if(Read())
-	{
-	    //cout << "DEBUG, read a line: " << fCurrentLine.str() << endl;
-	    fNMEAfd << fCurrentLine.str() << endl;
-	    // This is the last message in the read sequence. 
-	    if(fNMEA_GPS->LastID() == NMEA_GPS::kMESSAGE_VTG)
+	    else if (Events[i].data.fd == fTimer)
 	    {
-		// VTG message is the last in the series. 
-		Update();
+		if (read(fTimer, &Expired, sizeof(Expired)) > 0)
+		    Tick();
 	    }
-	    if (pDisp != NULL)
+	    else if (Events[i].data.fd == fSignal)
 	    {
-		pDisp->Update(fNMEA_GPS, fCurrentLine.str());
+		while (read(fSignal, &Info, sizeof(Info)) == sizeof(Info))
+		{
+		    if ((Info.ssi_signo == SIGUSR1) || 
+			(Info.ssi_signo == SIGUSR2))
+		    {
+			UserSignal(Info.ssi_signo);
+		    }
+		    else
+		    {
+			Logger->Log("# Signal %d, stopping.\n", 
+				    Info.ssi_signo);
+			fRun = false;
+		    }
+		}
 	    }
-	    // reset the stream
-	    fCurrentLine.str("");
 	}
-	//nanosleep( &sleeptime, NULL);
     } // End of run do loop. 
     Logger->LogTime(" Loop terminated. \n");
     SET_DEBUG_STACK;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name : GPSDelta
+ *
+ * Description : Seconds between a computer clock time and the GGA
+ *     time, local time corrected as the PCDT column always was. 
+ *
+ * Inputs : 
+ *     pGGA - last GGA
+ *     PC   - computer time, CLOCK_REALTIME
+ *
+ * Returns : dt in seconds
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+static double GPSDelta(const GGA *pGGA, const struct timespec &PC)
+{
+    uint32_t idt = pGGA->Seconds();
+    double   dt;
+
+    if (idt > PC.tv_sec)
+    {
+	idt -= PC.tv_sec;
+	dt   = pGGA->Milli() - 1.0e-9 * (double)PC.tv_nsec;
+	dt  += (double) idt;
+    }
+    else
+    {
+	idt  = PC.tv_sec - idt;
+	dt   = 1.0e-9 * (double)PC.tv_nsec -  pGGA->Milli();
+	dt  += (double) idt;
+    }
+    return dt - timezone;
+}
 /**
  ******************************************************************
  *
@@ -443,7 +859,6 @@ void GTOP::Update(void)
     //const GSA*  pGSA;
     //const RMC*  pRMC;
     uint32_t Count; 
-    uint32_t idt;
     double   dt = 0.0;
 
     // Do IPC
@@ -467,20 +882,7 @@ void GTOP::Update(void)
 	double sec = tmnow->tm_sec + tmnow->tm_min*60.0 + 
 	    tmnow->tm_hour*3600.0;
 
-	idt      = pGGA->Seconds();
-	if (idt > PCTime.tv_sec)
-	{
-	    idt -= PCTime.tv_sec;
-	    dt   = pGGA->Milli() - 1.0e-9 * (double)PCTime.tv_nsec;
-	    dt  += (double) idt;
-	}
-	else
-	{
-	    idt  = PCTime.tv_sec - idt;
-	    dt   = 1.0e-9 * (double)PCTime.tv_nsec -  pGGA->Milli();
-	    dt  += (double) idt;
-	}
-	dt       -= timezone;
+	dt = GPSDelta(pGGA, PCTime);
 
 	const VTG *pVTG = fNMEA_GPS->pVTG();
 
@@ -508,6 +910,9 @@ void GTOP::Update(void)
 	f5Logger->FillInternalVector(pRMC->Delta(), 15);
 	f5Logger->FillInternalVector(sec, 16);
 	f5Logger->FillInternalVector(fFlag, 17);
+	f5Logger->FillInternalVector(fGGARealTime.tv_sec + 
+				     1.0e-9*fGGARealTime.tv_nsec, 18);
+	f5Logger->FillInternalVector(GPSDelta(pGGA, fGGARealTime), 19);
 	fFlag = 0; /* Reset flag after fill */
 	f5Logger->Fill();
     }
@@ -538,7 +943,7 @@ bool GTOP::OpenLogFile(void)
 {
     SET_DEBUG_STACK;
 //    const char *Names = "Time:Lat:Lon:Z:NSV:PDOP:HDOP:VDOP:TDOP:VE:VN:VZ";
-    const char *Names = "Time:Lat:Lon:Z:NSV:PDOP:HDOP:VDOP:TRUE:MAG:SMPS:MODE:CTime:EVCount:PCDT:RMCDT:TOD:FLAG";
+    const char *Names = "Time:Lat:Lon:Z:NSV:PDOP:HDOP:VDOP:TRUE:MAG:SMPS:MODE:CTime:EVCount:PCDT:RMCDT:TOD:FLAG:RXTIME:RXDT";
     /*
      *
      *  0) Time - Seconds since unix epoch from GGA message
@@ -560,6 +965,12 @@ bool GTOP::OpenLogFile(void)
      * 15) RMC DT - same but for RMC message
      * 16) TOD - Time of Day
      * 17) FLAG - integer encoded flag for processing information. 
+     * 18) RXTIME - computer time the first byte of the GGA was read,
+     *              seconds since unix epoch. The stamp is taken to
+     *              the ns but a double of epoch seconds keeps only
+     *              about 0.2 us, ample against the serial timing.
+     * 19) RXDT  - as PCDT but from RXTIME, free of the parse and 
+     *             the wait for the rest of the epoch
      */
     CLogger *pLogger  = CLogger::GetThis();
     /* Give me a file name.  */
@@ -659,6 +1070,11 @@ bool GTOP::ReadConfiguration(void)
 	GPS.lookupValue("Logging",   fLogging);
 	GPS.lookupValue("ResetType", fResetType);
 	GPS.lookupValue("LogNMEA",   fLogNMEA);
+	GPS.lookupValue("NMEACompress", fNMEACompress);
+	GPS.lookupValue("BaudRate",  fBaudRate);
+	GPS.lookupValue("FixRate",   fFixRate);
+	GPS.lookupValue("PPSDevice", fPPSDevice);
+	fRT->ReadConfiguration(GPS);
 
 	SetDebug(Debug);
 
@@ -739,6 +1155,11 @@ bool GTOP::WriteConfiguration(void)
     GPS.add("Logging",   Setting::TypeBoolean) = fLogging;
     GPS.add("ResetType", Setting::TypeInt)     = fResetType;
     GPS.add("LogNMEA",   Setting::TypeBoolean) = fLogNMEA;
+    GPS.add("NMEACompress", Setting::TypeBoolean) = fNMEACompress;
+    GPS.add("BaudRate",  Setting::TypeInt)     = fBaudRate;
+    GPS.add("FixRate",   Setting::TypeInt)     = fFixRate;
+    GPS.add("PPSDevice", Setting::TypeString)  = fPPSDevice;
+    fRT->WriteConfiguration(GPS);
 
     // These are somewhat residual. 
     Geodetic.add("Latitude",  Setting::TypeFloat) = fGeoLatitude;
@@ -11,6 +11,14 @@
  *
  * Change Descriptions :
  * 18-Mar-26   Added in Flag variable for data processing. 
+ * 17-Oct-26   RealTime profile from the configuration. 
+ * 17-Oct-26   SerialFramer replaces the character at a time read. 
+ * 17-Oct-26   Do blocks in epoll on the port, a timerfd and a signalfd.
+ * 17-Oct-26   NMEASentence checks each sentence before the parser. 
+ * 17-Oct-26   BaudRate and FixRate, negotiated with PMTK. 
+ * 17-Oct-26   First byte receive stamps of the GGA. 
+ * 17-Oct-26   PPSDevice, edges paired with the GGA into GPS_PPS. 
+ * 17-Oct-26   NMEAArchive replaces the NMEA ofstream, NMEACompress. 
  *
  * Classification : Unclassified
  *
@@ -32,7 +40,12 @@
 #  include "smIPC.hh"
 #  include "H5Logger.hh"
 #  include "filename.hh"
+#  include "SerialFramer.hh"
+#  include "NMEASentence.hh"
 class EventCounter;
+class RealTime;
+class PPS;
+class NMEAArchive;
 
 class GTOP : public CObject
 {
@@ -90,6 +103,15 @@ public:
 
     inline void SetFlag(uint32_t value) {fFlag = value;};
 
+    /*!
+     * When the first byte of the last GGA was read, the start of the
+     * epoch, CLOCK_REALTIME and CLOCK_MONOTONIC. 
+     */
+    inline const struct timespec& GGARealTime(void)  const 
+	{return fGGARealTime;};
+    inline const struct timespec& GGAMonotonic(void) const 
+	{return fGGAMonotonic;};
+
     /**
      * Control bits - control verbosity of output
      */
@@ -127,6 +149,9 @@ private:
      */
     std::string  fConfigFileName;
 
+    /*! Scheduling, affinity and memory locking for the Do loop. */
+    RealTime     *fRT;
+
     /*!
      * Event counter 
      */
@@ -146,17 +171,52 @@ private:
     bool   fDisplay;       /*! Turn curses display on. */
     bool   fLogging;       /*! Turn logging on. */
     int    fResetType;     /*! 1 - soft reset, 2 Hard reset */
-    std::stringstream  fCurrentLine; /*! Last line read from GPS serial port. */
+    SerialFramer *fFramer;   /*! Buffered, line framed serial port. */
+    int    fEpoll;         /*! Do waits here, on the three below.   */
+    int    fTimer;         /*! timerfd, kTickMS for commands, files. */
+    int    fSignal;        /*! signalfd, LoopSignals.               */
+    SerialLine   fCurrentLine; /*! Last line read from GPS serial port. */
+    NMEASentence fSentence;    /*! Checksum, fields and counts of it.   */
+    struct timespec fGGARealTime;  /*! First byte of the last GGA.    */
+    struct timespec fGGAMonotonic;
     bool   fLogNMEA;       /*! Log to a NMEA file if set. */
-    ofstream fNMEAfd; 
+    bool   fNMEACompress;  /*! gzip the NMEA file.       */
+    int    fBaudRate;      /*! Port speed to ask the receiver for.  */
+    int    fFixRate;       /*! Fixes a second to ask for, 1 to 10.  */
+    double fActualRate;    /*! Fixes a second it agreed to.         */
+    std::string fPPSDevice; /*! /dev/ppsN, empty for none.          */
+    PPS    *fPPS;          /*! Kernel PPS edges, NULL if none.      */
+    NMEAArchive *fArchive; /*! NMEA file writer, NULL if not logging. */
     uint32_t fFlag;         /*! bit packed data processing flag. */
 
     /* Private functions. =============================================   */
     /*!
-     * Read - read data from the serial port. 
+     * Read - next good sentence already buffered from the serial port
+     * into fCurrentLine and the parser, bad ones are counted and
+     * skipped. 
      */
     bool Read(void);
 
+    /*!
+     * Log, publish and display the sentence Read just parsed. 
+     */
+    void Sentence(void);
+
+    /*!
+     * Pair the last PPS edge with the GGA just parsed, publish it. 
+     */
+    void PPSEdge(void);
+
+    /*!
+     * Timer tick, file name roll over and commands. 
+     */
+    void Tick(void);
+
+    /*!
+     * Set up the epoll, timerfd and signalfd that Do waits on. 
+     */
+    bool OpenEvents(void);
+
     /*!
      * Open the data logger. 
      */
@@ -11,6 +11,7 @@
  * Change Descriptions :
  * 19-Feb-22 CBL  Updated to class structure
  * 07-Feb-26 CBL  Updated to enable user enabled file change
+ * 17-Oct-26 CBL  Update takes the sentence in place, no string copy. 
  *
  * Classification : Unclassified
  *
@@ -275,7 +276,7 @@ void GTOP_Display::main_frame(void)
  *
  *******************************************************************
  */
-void GTOP_Display::Update(NMEA_GPS *pGPS, const string& Message)
+void GTOP_Display::Update(NMEA_GPS *pGPS, const char *Message)
 {
     SET_DEBUG_STACK;
 
@@ -288,7 +289,7 @@ void GTOP_Display::Update(NMEA_GPS *pGPS, const string& Message)
     float t;
 
     if (fDisplayData)
-	WriteMsgToScreen(Message.c_str());
+	WriteMsgToScreen(Message);
 
     switch (fCurrentScreen)
     {
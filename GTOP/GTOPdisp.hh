@@ -11,6 +11,7 @@
  *
  * Change Descriptions :
  * 19-Feb-22   CBL Made into class. 
+ * 17-Oct-26   CBL Update takes a const char *, the framer line. 
  *
  * Classification : Unclassified
  *
@@ -99,7 +100,7 @@ public:
     /**
      * Call this to update the display when the frame is complete. 
      */
-    void Update(NMEA_GPS *, const std::string& message);
+    void Update(NMEA_GPS *, const char *message);
 
     void WriteMsgToScreen(const char *s);
     int  checkKeys(void);
@@ -0,0 +1,465 @@
+/********************************************************************
+ *
+ * Module Name : NMEAArchive.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Raw NMEA log on a writer thread.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26   CBL   Writer started with every signal blocked. 
+ * 17-Oct-26   CBL   fsync after every flush. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <ctime>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "NMEAArchive.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Now
+ *
+ * Description : CLOCK_MONOTONIC, s.
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static double Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1.0e-9*t.tv_nsec;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : NMEAArchive constructor
+ *
+ * Description : Open the first file here so a bad path is reported
+ *     to the caller, then start the writer. GTOP makes this before
+ *     Do applies the RealTime profile, which is per thread, so the
+ *     writer stays at normal priority on any CPU. It is started 
+ *     with every signal blocked, they are for the caller's thread.
+ *
+ * Inputs :
+ *     Name     - first file
+ *     Compress - gzip
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : SetError(-1), logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+NMEAArchive::NMEAArchive(const char *Name, bool Compress) : CObject()
+{
+    SET_DEBUG_STACK;
+    sigset_t Set, Old;
+
+    SetName("NMEAArchive");
+    SetError();
+    fCompress      = Compress;
+    fFile          = NULL;
+    fFD            = -1;
+    fWriterStarted = false;
+    fWriterRun     = false;
+    fDropped       = 0;
+    fLines         = 0;
+    fBytes         = 0;
+    fFlushes       = 0;
+    fErrors        = 0;
+    memset(&fEntry, 0, sizeof(fEntry));
+
+    if (!Open(Name))
+    {
+	SetError(-1);
+	return;
+    }
+    fWriterRun = true;
+    sigfillset(&Set);
+    pthread_sigmask(SIG_BLOCK, &Set, &Old);
+    if (pthread_create(&fWriter, NULL, WriterThread, this) == 0)
+    {
+	fWriterStarted = true;
+    }
+    else
+    {
+	fWriterRun = false;
+	CLogger::GetThis()->LogError(__FILE__, __LINE__, 'W',
+				     "NMEA archive thread failed.\n");
+	SetError(-1);
+    }
+    pthread_sigmask(SIG_SETMASK, &Old, NULL);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : NMEAArchive destructor
+ *
+ * Description : Stop the writer, it drains the queue and closes the
+ *     file on the way out.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+NMEAArchive::~NMEAArchive(void)
+{
+    SET_DEBUG_STACK;
+    if (fWriterStarted)
+    {
+	fWriterRun = false;
+	pthread_join(fWriter, NULL);
+	fWriterStarted = false;
+	CLogger::GetThis()->Log(
+	    "# NMEA archive %llu lines, %llu bytes, %llu flushes, %llu dropped, %llu errors\n",
+	    (unsigned long long) fLines, (unsigned long long) fBytes,
+	    (unsigned long long) fFlushes, (unsigned long long) fDropped,
+	    (unsigned long long) fErrors);
+    }
+    Close();
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Append
+ *
+ * Description : Copy the line and its '\n' into a queue slot. No
+ *     lock, no system call.
+ *
+ * Inputs :
+ *     Line   - sentence
+ *     Length - bytes
+ *
+ * Returns : true if queued
+ *
+ * Error Conditions : full queue, counted in fDropped
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool NMEAArchive::Append(const char *Line, size_t Length)
+{
+    if (Length > kMaxLine)
+	Length = kMaxLine;
+    memcpy(fEntry.Data, Line, Length);
+    fEntry.Data[Length] = '\n';
+    fEntry.Length       = (uint16_t)(Length + 1);
+    fEntry.Rotate       = false;
+    if (!fQueue.Push(fEntry))
+    {
+	fDropped++;
+	return false;
+    }
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Rotate
+ *
+ * Description : Queue the next file name behind the lines.
+ *
+ * Inputs : Name - next file
+ *
+ * Returns : true if queued
+ *
+ * Error Conditions : name too long or queue full, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool NMEAArchive::Rotate(const char *Name)
+{
+    SET_DEBUG_STACK;
+    size_t Length = strlen(Name);
+
+    if (Length > kMaxLine)
+    {
+	CLogger::GetThis()->Log("# NMEA archive name too long: %s\n", Name);
+	return false;
+    }
+    memcpy(fEntry.Data, Name, Length + 1);
+    fEntry.Length = (uint16_t) Length;
+    fEntry.Rotate = true;
+    if (!fQueue.Push(fEntry))
+    {
+	CLogger::GetThis()->Log("# NMEA archive queue full, %s not started\n",
+				Name);
+	return false;
+    }
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Open
+ *
+ * Description : open, then gzdopen, compressed or transparent, with
+ *     a large buffer so zlib only writes when it fills or is
+ *     flushed. The descriptor is kept for Flush's fsync.
+ *
+ * Inputs : Name - file, .gz added when compressing
+ *
+ * Returns : true if open
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool NMEAArchive::Open(const char *Name)
+{
+    SET_DEBUG_STACK;
+    fName = Name;
+    if (fCompress)
+	fName += ".gz";
+
+    fFD = open(fName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+	       0644);
+    if (fFD < 0)
+    {
+	CLogger::GetThis()->Log("# NMEA archive could not open %s: %s\n",
+				fName.c_str(), strerror(errno));
+	fErrors++;
+	return false;
+    }
+    fFile = gzdopen(fFD, fCompress ? "wb6" : "wbT");
+    if (fFile == NULL)
+    {
+	CLogger::GetThis()->Log("# NMEA archive could not open %s\n",
+				fName.c_str());
+	close(fFD);
+	fFD = -1;
+	fErrors++;
+	return false;
+    }
+    gzbuffer(fFile, kBufferSize);
+    CLogger::GetThis()->Log("# NMEA archive %s\n", fName.c_str());
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Close
+ *
+ * Description : gzclose writes what is buffered and the trailer,
+ *     and closes the descriptor.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : counted in fErrors
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void NMEAArchive::Close(void)
+{
+    if (fFile)
+    {
+	if (gzclose(fFile) != Z_OK)
+	    fErrors++;
+	fFile = NULL;
+	fFD   = -1;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Flush
+ *
+ * Description : Push zlib's buffer to the file. Z_SYNC_FLUSH ends
+ *     the deflate block on a byte boundary, so a gzip file is
+ *     readable up to here even if it is never closed. gzflush only
+ *     gets it to the kernel, fsync puts it on the card. This is
+ *     the writer thread, the receive thread never waits on it.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : counted in fErrors
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void NMEAArchive::Flush(void)
+{
+    if (fFile)
+    {
+	if (gzflush(fFile, Z_SYNC_FLUSH) != Z_OK)
+	    fErrors++;
+	else if (fsync(fFD) < 0)
+	    fErrors++;
+	fFlushes++;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WriterThread
+ *
+ * Description : pthread entry point, arg is the NMEAArchive.
+ *
+ * Inputs : arg - NMEAArchive pointer
+ *
+ * Returns : NULL
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void* NMEAArchive::WriterThread(void *arg)
+{
+    ((NMEAArchive *) arg)->Writer();
+    return NULL;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Writer
+ *
+ * Description :
+ *    Writer thread. Empty the queue into zlib, flush every
+ *    kFlushSeconds, sleep a little when there was nothing. On stop
+ *    the queue is drained and the file closed before returning.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : write errors counted in fErrors
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void NMEAArchive::Writer(void)
+{
+    SET_DEBUG_STACK;
+    const struct timespec Idle = {0L, 50000000L};  // 50ms
+    Entry   e;
+    size_t  n;
+    double  Last = Now();
+    bool    Run, Pending = false;
+
+    do
+    {
+	// Read the flag first so nothing pushed before Stop is missed.
+	Run = fWriterRun;
+
+	for (n = 0; fQueue.Pop(e); n++)
+	{
+	    if (e.Rotate)
+	    {
+		Close();
+		Open(e.Data);
+		Last    = Now();
+		Pending = false;
+	    }
+	    else if (fFile)
+	    {
+		if (gzwrite(fFile, e.Data, e.Length) != (int) e.Length)
+		{
+		    fErrors++;
+		}
+		else
+		{
+		    fLines++;
+		    fBytes += e.Length;
+		    Pending = true;
+		}
+	    }
+	}
+
+	// Nothing new, nothing to flush, an empty sync block costs bytes.
+	if (Pending && (Now() - Last >= kFlushSeconds))
+	{
+	    Flush();
+	    Last    = Now();
+	    Pending = false;
+	}
+
+	if ((n == 0) && Run)
+	{
+	    nanosleep(&Idle, NULL);
+	}
+    } while (Run);
+    Close();
+    SET_DEBUG_STACK;
+}
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : NMEAArchive.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Raw NMEA log written off the receive thread. Append
+ *     copies a sentence into a lock free queue and returns, a writer
+ *     thread takes them off into zlib's buffer and pushes that to
+ *     the file every kFlushSeconds, or when it fills. The SD card
+ *     sees a write a second, not a write per sentence, and a slow
+ *     one holds up only the writer while the queue takes up the
+ *     slack.
+ *
+ *     Compress gzips the file, name.gz, block ended on every flush
+ *     so it reads back to there. Otherwise the file is plain text
+ *     as before. Every flush is followed by an fsync, so a crash or
+ *     power cut loses at most the last second.
+ *
+ *     Rotate goes through the same queue, so every line appended
+ *     before it is in the old file and none after.
+ *
+ * Restrictions/Limitations :
+ *     One thread may Append and Rotate. Lines longer than kMaxLine
+ *     are cut. A full queue drops lines, counted, never waits.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  fsync after each flush, the file opened here and
+ *                 handed to gzdopen for the descriptor.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __NMEAARCHIVE_hh_
+#define __NMEAARCHIVE_hh_
+#  include <stdint.h>
+#  include <pthread.h>
+#  include <atomic>
+#  include <string>
+#  include <zlib.h>
+#  include "CObject.hh"
+#  include "SPSCQueue.hh"
+
+/// NMEAArchive - buffered raw NMEA file on its own thread.
+class NMEAArchive : public CObject
+{
+public:
+    /*! Longest line kept, SerialFramer hands out no more. */
+    static const size_t kMaxLine     = 255;
+    /*! Lines queued, ~12 s of every sentence at 10 Hz. */
+    static const size_t kQueueSize   = 1024;
+    /*! zlib buffer, several flush intervals at 115200 baud. */
+    static const unsigned kBufferSize = 64*1024;
+    /*! Push to the file at least this often, s. */
+    static constexpr double kFlushSeconds = 1.0;
+
+    /*!
+     * Description:
+     *   Open the first file and start the writer.
+     *
+     * Arguments:
+     *   Name     - file name, .gz is added if compressing
+     *   Compress - gzip
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   logged, SetError(-1) if the file or thread failed.
+     */
+    NMEAArchive(const char *Name, bool Compress);
+
+    /*! Write everything queued, close and stop the writer. */
+    ~NMEAArchive(void);
+
+    /*!
+     * Description:
+     *   Queue one sentence, the '\n' is added.
+     *
+     * Arguments:
+     *   Line   - sentence, no line ending
+     *   Length - bytes
+     *
+     * Returns:
+     *   true if queued, false if the queue was full.
+     *
+     * Errors:
+     *   NONE
+     */
+    bool Append(const char *Line, size_t Length);
+
+    /*!
+     * Description:
+     *   Close the current file and start Name, after the lines
+     *   already queued.
+     *
+     * Arguments:
+     *   Name - next file, .gz is added if compressing
+     *
+     * Returns:
+     *   true if queued.
+     *
+     * Errors:
+     *   false if the queue was full or the name too long, the
+     *   current file carries on.
+     */
+    bool Rotate(const char *Name);
+
+    inline uint64_t Dropped(void) const {return fDropped;};
+
+private:
+    /*! One queue slot, a sentence or the next file name. */
+    struct Entry {
+	uint16_t Length;
+	bool     Rotate;
+	char     Data[kMaxLine+1];
+    };
+
+    SPSCQueue<Entry, kQueueSize> fQueue;
+    Entry             fEntry;      // producer's scratch
+    bool              fCompress;
+    gzFile            fFile;       // writer thread only, once started
+    int               fFD;         // fFile's descriptor, for fsync
+    std::string       fName;
+    pthread_t         fWriter;
+    bool              fWriterStarted;
+    std::atomic<bool> fWriterRun;
+
+    uint64_t          fDropped;    // producer
+    uint64_t          fLines;      // writer
+    uint64_t          fBytes;
+    uint64_t          fFlushes;
+    uint64_t          fErrors;
+
+    bool   Open(const char *Name);
+    void   Close(void);
+    void   Flush(void);
+    void   Writer(void);
+    static void* WriterThread(void *arg);
+};
+#endif
@@ -0,0 +1,257 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : NMEABench.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Per sentence cost of the GTOP serial front end,
+ *     before and after SerialFramer and NMEASentence. One epoch of
+ *     GGA, GSA, 3 GSV, RMC and VTG is written to a pipe and read
+ *     back the two ways,
+ *
+ *         byte    read() a byte at a time into a stringstream,
+ *                 str() after every byte, parse(str().c_str()) and a
+ *                 string copy for the display, as GTOP::Read did.
+ *         framed  SerialFramer Fill/Next, NMEASentence::Parse, then
+ *                 parse on the line in place.
+ *
+ *     NMEA_GPS::parse is included unless -x, so the numbers are
+ *     what GTOP pays per sentence. The last line scales them to a
+ *     10 Hz fix rate with every sentence enabled, see PMTK.
+ *
+ *     make -f Makefile.bench
+ *     ./NMEABench -n 20000
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  CPU at 10 Hz.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+// System includes.
+#include <iostream>
+using namespace std;
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+
+/// Local Includes.
+#include "NMEA_GPS.hh"
+#include "SerialFramer.hh"
+#include "NMEASentence.hh"
+
+/*! One epoch, the checksums are filled in by MakeEpoch. */
+static const char *kEpoch[] = {
+    "$GPGGA,123519.000,4118.5040,N,07353.5800,W,1,08,0.9,88.7,M,-34.2,M,,",
+    "$GPGSA,A,3,04,05,09,12,24,25,29,31,,,,,1.8,0.9,1.5",
+    "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00",
+    "$GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00",
+    "$GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,,",
+    "$GPRMC,123519.000,A,4118.5040,N,07353.5800,W,0.13,309.62,171026,,,A",
+    "$GPVTG,309.62,T,,M,0.13,N,0.2,K,A"
+};
+static const size_t kNEpoch = sizeof(kEpoch)/sizeof(kEpoch[0]);
+
+static size_t Epochs   = 10000;
+static bool   DoParse  = true;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MakeEpoch, Now
+ *
+ * Description : The epoch as the receiver sends it, *hh\r\n on each
+ *     sentence. Monotonic ns.
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static string MakeEpoch(void)
+{
+    string rv;
+    char   tail[8];
+
+    for (size_t i = 0; i < kNEpoch; i++)
+    {
+	snprintf(tail, sizeof(tail), "*%02X\r\n",
+		 NMEASentence::Checksum(kEpoch[i]+1, strlen(kEpoch[i])-1));
+	rv += kEpoch[i];
+	rv += tail;
+    }
+    return rv;
+}
+static inline double Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1.0e9*t.tv_sec + t.tv_nsec;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ByteAtATime
+ *
+ * Description : The old GTOP::Read, minus the sleep.
+ *
+ * Returns : sentences parsed
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static size_t ByteAtATime(int fd[2], const string &Epoch, NMEA_GPS *pGPS,
+			  double &ns)
+{
+    stringstream Line;
+    string       Display;
+    size_t       n = 0, len = 0;
+    char         c;
+    double       t0 = Now();
+
+    for (size_t e = 0; e < Epochs; e++)
+    {
+	if (write(fd[1], Epoch.data(), Epoch.size()) < 0)
+	    return 0;
+	for (size_t i = 0; i < Epoch.size(); i++)
+	{
+	    if (read(fd[0], &c, 1) != 1)
+		return 0;
+	    if (c == '\n')
+	    {
+		if (DoParse)
+		    pGPS->parse(Line.str().c_str());
+		Display = Line.str();
+		Line.str("");
+		n++;
+	    }
+	    else
+	    {
+		Line << c;
+		len += Line.str().length();
+	    }
+	}
+    }
+    ns = (Now() - t0)/(double) n;
+    return (len > 0) ? n : 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Framed
+ *
+ * Description : The new path, GTOP::Read on SerialFramer and
+ *     NMEASentence.
+ *
+ * Returns : sentences parsed
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static size_t Framed(int fd[2], const string &Epoch, NMEA_GPS *pGPS,
+		     double &ns)
+{
+    SerialFramer Framer(fd[0]);
+    NMEASentence Sentence;
+    SerialLine   Line;
+    size_t       n = 0;
+    double       t0 = Now();
+
+    for (size_t e = 0; e < Epochs; e++)
+    {
+	if (write(fd[1], Epoch.data(), Epoch.size()) < 0)
+	    return 0;
+	while (Framer.Fill() > 0)
+	{
+	    while (Framer.Next(Line))
+	    {
+		if (Sentence.Parse(Line.Data, Line.Length))
+		{
+		    if (DoParse)
+			pGPS->parse(Line.Data);
+		    n++;
+		}
+	    }
+	}
+    }
+    ns = (Now() - t0)/(double) n;
+    printf("framed: %llu reads for %zu epochs, %llu rejected\n",
+	   (unsigned long long) Framer.Reads(), Epochs,
+	   (unsigned long long) (Sentence.Reasons(NMEASentence::kNoStart) +
+				 Sentence.Reasons(NMEASentence::kNoChecksum) +
+				 Sentence.Reasons(NMEASentence::kBadChecksum) +
+				 Sentence.Reasons(NMEASentence::kTooShort)));
+    return n;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : main
+ *
+ * Description : -n epochs, -x leave out NMEA_GPS::parse
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+int main(int argc, char **argv)
+{
+    NMEA_GPS *pGPS  = new NMEA_GPS();
+    string   Epoch  = MakeEpoch();
+    int      fd[2];
+    int      option;
+    size_t   nOld, nNew;
+    double   Old = 0.0, New = 0.0;
+
+    while ((option = getopt(argc, argv, "n:xh")) != -1)
+    {
+	switch (option)
+	{
+	case 'n':
+	    Epochs = strtoul(optarg, NULL, 10);
+	    break;
+	case 'x':
+	    DoParse = false;
+	    break;
+	default:
+	    printf("NMEABench [-n epochs] [-x no NMEA_GPS::parse]\n");
+	    return 1;
+	}
+    }
+    if (pipe(fd) < 0)
+    {
+	perror("pipe");
+	return 1;
+    }
+
+    nOld = ByteAtATime(fd, Epoch, pGPS, Old);
+    nNew = Framed(fd, Epoch, pGPS, New);
+    if ((nOld == 0) || (nOld != nNew))
+    {
+	printf("Sentence counts differ, byte %zu framed %zu\n", nOld, nNew);
+	return 1;
+    }
+    printf("%zu sentences, %zu bytes an epoch, NMEA_GPS::parse %s\n",
+	   nNew, Epoch.size(), DoParse ? "included" : "left out");
+    printf("byte   %9.1f ns/sentence\n", Old);
+    printf("framed %9.1f ns/sentence, %.1fx\n", New, Old/New);
+    // What a 10 Hz fix rate with every sentence enabled costs.
+    printf("10 Hz, %zu sentences a fix: byte %.3f%%, framed %.3f%% of a CPU\n",
+	   kNEpoch, 1.0e-7*Old*kNEpoch*10.0, 1.0e-7*New*kNEpoch*10.0);
+    delete pGPS;
+    return 0;
+}
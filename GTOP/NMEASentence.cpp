@@ -0,0 +1,293 @@
+/********************************************************************
+ *
+ * Module Name : NMEASentence.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Check and split NMEA sentences in place.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <cstring>
+
+// Local Includes.
+#include "NMEASentence.hh"
+
+static const char *kTypeNames[NMEASentence::kNTypes] =
+    {"GGA", "GSA", "GSV", "RMC", "VTG", "GLL", "ZDA", "PMTK", "Other"};
+
+static const char *kReasonNames[NMEASentence::kNReasons] =
+    {"ok", "no start", "no checksum", "bad checksum", "too short"};
+
+/*! Hex digit values, 0xFF if not one. Upper and lower case. */
+static const uint8_t kHex[256] = {
+#define X 0xFF
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, 0,1,2,3,4,5,6,7,8,9,X,X,X,X,X,X,
+    X,10,11,12,13,14,15,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,10,11,12,13,14,15,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,
+    X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X, X,X,X,X,X,X,X,X,X,X,X,X,X,X,X,X
+#undef X
+};
+
+/**
+ ******************************************************************
+ *
+ * Function Name : NMEASentence constructor
+ *
+ * Description : Zero the counters.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+NMEASentence::NMEASentence(void)
+{
+    fType    = kOther;
+    fReason  = kOK;
+    fNFields = 0;
+    memset(fFields,   0, sizeof(fFields));
+    memset(fAccepted, 0, sizeof(fAccepted));
+    memset(fRejected, 0, sizeof(fRejected));
+    memset(fReasons,  0, sizeof(fReasons));
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Checksum
+ *
+ * Description : XOR eight bytes at a time, fold the word down to a
+ *     byte, then the odd bytes at the end.
+ *
+ * Inputs :
+ *     Data   - first byte after the '$'
+ *     Length - up to the '*'
+ *
+ * Returns : checksum
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint8_t NMEASentence::Checksum(const char *Data, size_t Length)
+{
+    uint64_t w = 0, v;
+    uint8_t  rv;
+    size_t   i = 0;
+
+    for (; i + 8 <= Length; i += 8)
+    {
+	memcpy(&v, Data + i, 8);
+	w ^= v;
+    }
+    w ^= w >> 32;
+    w ^= w >> 16;
+    w ^= w >> 8;
+    rv = (uint8_t) w;
+    for (; i < Length; i++)
+	rv ^= (uint8_t) Data[i];
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Classify
+ *
+ * Description : Type from the address field, $ttXXX or $PMTKnnn.
+ *
+ * Inputs :
+ *     Address - after the '$'
+ *     Length  - of the address
+ *
+ * Returns : kGGA ... kOther
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int NMEASentence::Classify(const char *Address, size_t Length)
+{
+    const char *s;
+
+    if ((Length >= 4) && (memcmp(Address, "PMTK", 4) == 0))
+	return kPMTK;
+    if (Length != 5)
+	return kOther;
+    s = Address + 2;
+    switch (s[0])
+    {
+    case 'G':
+	if ((s[1] == 'G') && (s[2] == 'A')) return kGGA;
+	if ((s[1] == 'S') && (s[2] == 'A')) return kGSA;
+	if ((s[1] == 'S') && (s[2] == 'V')) return kGSV;
+	if ((s[1] == 'L') && (s[2] == 'L')) return kGLL;
+	break;
+    case 'R':
+	if ((s[1] == 'M') && (s[2] == 'C')) return kRMC;
+	break;
+    case 'V':
+	if ((s[1] == 'T') && (s[2] == 'G')) return kVTG;
+	break;
+    case 'Z':
+	if ((s[1] == 'D') && (s[2] == 'A')) return kZDA;
+	break;
+    }
+    return kOther;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Reject
+ *
+ * Description : Count a rejected sentence.
+ *
+ * Inputs : Reason - kNoStart ...
+ *
+ * Returns : false, for Parse to return.
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool NMEASentence::Reject(int Reason)
+{
+    fReason = Reason;
+    fReasons[Reason]++;
+    fRejected[fType]++;
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Parse
+ *
+ * Description : '$', address, fields, '*', two hex digits. Commas
+ *     are found with memchr, each field is a view.
+ *
+ * Inputs :
+ *     Data   - the sentence
+ *     Length - bytes, no line ending
+ *
+ * Returns : true if good
+ *
+ * Error Conditions : Reason() and the counters
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool NMEASentence::Parse(const char *Data, size_t Length)
+{
+    const char *Body, *Star, *End, *p, *comma;
+    uint8_t    hi, lo;
+
+    fType    = kOther;
+    fReason  = kOK;
+    fNFields = 0;
+
+    if ((Length < 1) || (Data[0] != '$'))
+	return Reject(kNoStart);
+
+    Body = Data + 1;
+    End  = Data + Length;
+    comma = (const char *) memchr(Body, ',', End - Body);
+    fType = Classify(Body, (comma ? comma : End) - Body);
+
+    if ((Length < 4) || (End[-3] != '*'))
+	return Reject(kNoChecksum);
+    Star = End - 3;
+    hi   = kHex[(uint8_t) End[-2]];
+    lo   = kHex[(uint8_t) End[-1]];
+    if ((hi | lo) & 0xF0)
+	return Reject(kNoChecksum);
+    if (Checksum(Body, Star - Body) != ((hi << 4) | lo))
+	return Reject(kBadChecksum);
+
+    for (p = Body; fNFields < kMaxFields; p = comma + 1)
+    {
+	comma = (const char *) memchr(p, ',', Star - p);
+	fFields[fNFields].Data   = p;
+	fFields[fNFields].Length = (uint16_t)((comma ? comma : Star) - p);
+	fNFields++;
+	if (comma == NULL)
+	    break;
+    }
+    if (fNFields < 2)
+	return Reject(kTooShort);
+
+    fAccepted[fType]++;
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : TypeName, ReasonName
+ *
+ * Description : For the log.
+ *
+ * Inputs : Type or Reason
+ *
+ * Returns : name
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const char* NMEASentence::TypeName(int Type)
+{
+    return ((Type >= 0) && (Type < kNTypes)) ? kTypeNames[Type] : "?";
+}
+const char* NMEASentence::ReasonName(int Reason)
+{
+    return ((Reason >= 0) && (Reason < kNReasons)) ? kReasonNames[Reason]
+	: "?";
+}
@@ -0,0 +1,108 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : NMEASentence.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Front end to NMEA_GPS::parse. A sentence from the
+ *     SerialFramer buffer is checked, $ start, *hh checksum over
+ *     everything between, and split at the commas into views,
+ *     without copying or allocating. Only sentences that pass go on
+ *     to the parser. Accepted and rejected sentences are counted by
+ *     type and rejection reason.
+ *
+ *     The checksum XOR runs eight bytes at a time, the hex digits
+ *     come from a table.
+ *
+ * Restrictions/Limitations :
+ *     Fields are views into the caller's buffer, good as long as it
+ *     is. kMaxFields fields, the rest are not split out.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     NMEA 0183 v3.01, section 5.3, sentence structure.
+ *
+ *******************************************************************
+ */
+#ifndef __NMEASENTENCE_hh_
+#define __NMEASENTENCE_hh_
+#  include <stddef.h>
+#  include <stdint.h>
+
+/// NMEASentence - check and split one NMEA sentence in place.
+class NMEASentence
+{
+public:
+    /*! Sentence types counted, by the three letters after the talker. */
+    enum {kGGA=0, kGSA, kGSV, kRMC, kVTG, kGLL, kZDA, kPMTK, kOther,
+	  kNTypes};
+
+    /*! Why a sentence was turned away. */
+    enum {kOK=0, kNoStart, kNoChecksum, kBadChecksum, kTooShort,
+	  kNReasons};
+
+    /*! Fields split out, GSV has 20. */
+    static const size_t kMaxFields = 32;
+
+    /*! One field, not null terminated. */
+    struct Field {
+	const char *Data;
+	uint16_t    Length;
+    };
+
+    NMEASentence(void);
+
+    /*!
+     * Description:
+     *   Check and split a sentence.
+     *
+     * Arguments:
+     *   Data   - '$' to the last checksum digit, no line ending
+     *   Length - bytes
+     *
+     * Returns:
+     *   true if it is well formed and the checksum matches.
+     *
+     * Errors:
+     *   Reason() says why not, the counters are bumped.
+     */
+    bool Parse(const char *Data, size_t Length);
+
+    /*! Type of the last sentence, kOther if not one of ours. */
+    inline int      Type(void)    const {return fType;};
+    /*! Reason the last sentence was rejected, kOK if it was not. */
+    inline int      Reason(void)  const {return fReason;};
+    /*! Fields including the address, e.g. GPGGA, as field 0. */
+    inline size_t   NFields(void) const {return fNFields;};
+    inline const Field& GetField(size_t i) const {return fFields[i];};
+
+    inline uint64_t Accepted(int Type) const {return fAccepted[Type];};
+    inline uint64_t Rejected(int Type) const {return fRejected[Type];};
+    inline uint64_t Reasons(int Reason) const {return fReasons[Reason];};
+
+    /*! XOR of Length bytes. */
+    static uint8_t Checksum(const char *Data, size_t Length);
+
+    /*! "GGA", ... */
+    static const char* TypeName(int Type);
+    /*! "no start", ... */
+    static const char* ReasonName(int Reason);
+
+private:
+    int      fType;
+    int      fReason;
+    size_t   fNFields;
+    Field    fFields[kMaxFields];
+
+    uint64_t fAccepted[kNTypes];
+    uint64_t fRejected[kNTypes];
+    uint64_t fReasons[kNReasons];
+
+    static int Classify(const char *Address, size_t Length);
+    bool Reject(int Reason);
+};
+#endif
@@ -0,0 +1,541 @@
+/********************************************************************
+ *
+ * Module Name : PMTK.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : MT3339 port speed and fix rate negotiation.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26   CBL   Fix rate cut to what fits, not to 5, 2 or 1 Hz. 
+ * 17-Oct-26   CBL   PMTK314 only when the default set does not fit. 
+ *                   After a failed PMTK251 the speed is probed again.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <termios.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "serial.h"
+#include "PMTK.hh"
+
+/*! Speeds tried, and how to ask termios for them. */
+static const struct {uint32_t Baud; speed_t Speed;} kSpeeds[] = {
+    {9600, B9600}, {115200, B115200}, {57600, B57600},
+    {38400, B38400}, {19200, B19200}, {4800, B4800}};
+static const size_t kNSpeeds = sizeof(kSpeeds)/sizeof(kSpeeds[0]);
+
+/*! Listen this long for sentences at a speed, s. */
+static const double kProbeSeconds  = 1.5;
+/*! Time the GGAs over this long, s. */
+static const double kVerifySeconds = 3.0;
+/*! Wait this long for a PMTK001, s. */
+static const double kAckSeconds    = 1.0;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Now
+ *
+ * Description : CLOCK_MONOTONIC, s.
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static double Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1.0e-9*t.tv_nsec;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PMTK constructor
+ *
+ * Description : The receiver is assumed at its factory 9600, 1 Hz
+ *     until Negotiate finds otherwise.
+ *
+ * Inputs : Framer - on the open serial port
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+PMTK::PMTK(SerialFramer *Framer) : CObject()
+{
+    SetName("PMTK");
+    SetError();
+    fFramer   = Framer;
+    fBaudRate = 9600;
+    fFixRate  = 1.0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PMTK destructor
+ *
+ * Description : NONE
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+PMTK::~PMTK(void)
+{
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ValidBaud
+ *
+ * Description : One of kSpeeds?
+ *
+ * Inputs : BaudRate
+ *
+ * Returns : true if so
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PMTK::ValidBaud(uint32_t BaudRate)
+{
+    for (size_t i = 0; i < kNSpeeds; i++)
+    {
+	if (kSpeeds[i].Baud == BaudRate)
+	    return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Speed
+ *
+ * Description : Set our end of the port and drop what was buffered
+ *     at the old speed.
+ *
+ * Inputs : BaudRate
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PMTK::Speed(uint32_t BaudRate)
+{
+    for (size_t i = 0; i < kNSpeeds; i++)
+    {
+	if (kSpeeds[i].Baud == BaudRate)
+	{
+	    if (SerialSpeed(kSpeeds[i].Speed) < 0)
+	    {
+		CLogger::GetThis()->Log("# PMTK speed %u: %s\n", BaudRate,
+					strerror(errno));
+		return false;
+	    }
+	    fFramer->Reset();
+	    return true;
+	}
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Send
+ *
+ * Description : $, Body, *hh, CR LF.
+ *
+ * Inputs : Body - e.g. "PMTK220,100"
+ *
+ * Returns : true if it was all written
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PMTK::Send(const char *Body)
+{
+    char    msg[128];
+    int     n;
+
+    n = snprintf(msg, sizeof(msg), "$%s*%02X\r\n", Body,
+		 NMEASentence::Checksum(Body, strlen(Body)));
+    if ((n <= 0) || (write(fFramer->fd(), msg, n) != n))
+    {
+	CLogger::GetThis()->Log("# PMTK send %s failed.\n", Body);
+	return false;
+    }
+    tcdrain(fFramer->fd());
+    if (fDebug)
+    {
+	CLogger::GetThis()->Log("# PMTK sent %s", msg);
+    }
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Listen
+ *
+ * Description : Good sentences for Seconds, and the GGA rate from
+ *     the first to the last GGA.
+ *
+ * Inputs :
+ *     Seconds - how long
+ *     GGARate - filled in if not NULL, 0 with fewer than 2 GGAs
+ *
+ * Returns : good sentences
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t PMTK::Listen(double Seconds, double *GGARate)
+{
+    SerialLine Line;
+    double     End = Now() + Seconds, t, First = 0.0, Last = 0.0;
+    uint32_t   Good = 0, NGGA = 0;
+
+    while ((t = Now()) < End)
+    {
+	if (!fFramer->Wait((int)(1000.0*(End - t)) + 1) ||
+	    (fFramer->Fill() < 0))
+	    continue;
+	t = Now();
+	while (fFramer->Next(Line))
+	{
+	    if (!fSentence.Parse(Line.Data, Line.Length))
+		continue;
+	    Good++;
+	    if (fSentence.Type() == NMEASentence::kGGA)
+	    {
+		if (NGGA++ == 0)
+		    First = t;
+		Last = t;
+	    }
+	}
+    }
+    if (GGARate)
+    {
+	*GGARate = ((NGGA > 1) && (Last > First)) ?
+	    (double)(NGGA - 1)/(Last - First) : 0.0;
+    }
+    return Good;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Ack
+ *
+ * Description : Wait for $PMTK001,Command,Flag.
+ *
+ * Inputs :
+ *     Command - e.g. 220
+ *     Seconds - how long
+ *
+ * Returns : Flag, 3 is success, -1 if none came
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int PMTK::Ack(uint32_t Command, double Seconds)
+{
+    SerialLine Line;
+    double     End = Now() + Seconds, t;
+
+    while ((t = Now()) < End)
+    {
+	if (!fFramer->Wait((int)(1000.0*(End - t)) + 1) ||
+	    (fFramer->Fill() < 0))
+	    continue;
+	while (fFramer->Next(Line))
+	{
+	    if (!fSentence.Parse(Line.Data, Line.Length) ||
+		(fSentence.Type() != NMEASentence::kPMTK) ||
+		(fSentence.NFields() < 3) ||
+		(strncmp(fSentence.GetField(0).Data, "PMTK001", 7) != 0) ||
+		(strtoul(fSentence.GetField(1).Data, NULL, 10) != Command))
+		continue;
+	    return atoi(fSentence.GetField(2).Data);
+	}
+    }
+    return -1;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Probe
+ *
+ * Description : Is the receiver talking at this speed?
+ *
+ * Inputs : BaudRate
+ *
+ * Returns : true if at least two good sentences came in.
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PMTK::Probe(uint32_t BaudRate)
+{
+    return Speed(BaudRate) && (Listen(kProbeSeconds, NULL) >= 2);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Find
+ *
+ * Description : Probe First, then every other speed in kSpeeds
+ *     order. The port is left at the speed found.
+ *
+ * Inputs : First - speed to try first
+ *
+ * Returns : the speed the receiver is talking at, 0 for none
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t PMTK::Find(uint32_t First)
+{
+    size_t i;
+
+    if (Probe(First))
+	return First;
+    for (i = 0; i < kNSpeeds; i++)
+    {
+	if ((kSpeeds[i].Baud != First) && Probe(kSpeeds[i].Baud))
+	    return kSpeeds[i].Baud;
+    }
+    return 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Negotiate
+ *
+ * Description : Speed, sentences, fix interval, then check the GGA
+ *     cadence. Anything that does not take is put back.
+ *
+ * Inputs :
+ *     BaudRate - target speed
+ *     FixRate  - target fixes a second
+ *
+ * Returns : true if both were had
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PMTK::Negotiate(uint32_t BaudRate, uint32_t FixRate)
+{
+    SET_DEBUG_STACK;
+    CLogger  *Logger = CLogger::GetThis();
+    char     msg[64];
+    uint32_t Found, Fits, Rate;
+    double   Measured = 0.0;
+    bool     rv = true;
+
+    if (!ValidBaud(BaudRate))
+    {
+	Logger->Log("# PMTK baud rate %u not supported, using 9600.\n",
+		    BaudRate);
+	BaudRate = 9600;
+	rv = false;
+    }
+    if ((FixRate < 1) || (FixRate > 10))
+    {
+	Logger->Log("# PMTK fix rate %u not supported, using 1.\n", FixRate);
+	FixRate = 1;
+	rv = false;
+    }
+
+    // 1, where is it now?
+    Found = Find(BaudRate);
+    if (Found == 0)
+    {
+	Logger->Log("# PMTK no sentences at any speed, left at 9600.\n");
+	Speed(9600);
+	fBaudRate = 9600;
+	fFixRate  = 1.0;
+	SET_DEBUG_STACK;
+	return false;
+    }
+    fBaudRate = Found;
+    Logger->Log("# PMTK receiver found at %u baud.\n", Found);
+
+    // 2, speed.
+    if (Found != BaudRate)
+    {
+	snprintf(msg, sizeof(msg), "PMTK251,%u", BaudRate);
+	if (Send(msg) && Probe(BaudRate))
+	{
+	    fBaudRate = BaudRate;
+	    Logger->Log("# PMTK now at %u baud.\n", BaudRate);
+	}
+	else
+	{
+	    /*
+	     * No ack or no sentences does not say the receiver stayed
+	     * put, it may have switched as the ack was lost. Look again.
+	     */
+	    Found = Find(Found);
+	    if (Found == 0)
+	    {
+		Logger->Log("# PMTK lost the receiver after PMTK251, left at 9600.\n");
+		Speed(9600);
+		fBaudRate = 9600;
+		fFixRate  = 1.0;
+		SET_DEBUG_STACK;
+		return false;
+	    }
+	    fBaudRate = Found;
+	    if (Found != BaudRate)
+	    {
+		Logger->Log("# PMTK change to %u baud failed, at %u.\n",
+			    BaudRate, Found);
+		rv = false;
+	    }
+	    else
+	    {
+		Logger->Log("# PMTK now at %u baud.\n", BaudRate);
+	    }
+	}
+    }
+
+    // 3, no faster than the port can carry without GSV, with room.
+    Fits = (uint32_t)(0.7 * (fBaudRate/10.0) / kCoreEpochBytes);
+    Rate = FixRate;
+    if (Rate > Fits)
+    {
+	Rate = (Fits >= 1) ? Fits : 1;
+	Logger->Log("# PMTK %u Hz will not fit %u baud, asking for %u Hz.\n",
+		    FixRate, fBaudRate, Rate);
+	rv = false;
+    }
+    // The receiver's own set is left alone unless it will not fit.
+    if (Rate > (uint32_t)(0.7 * (fBaudRate/10.0) / kEpochBytes))
+    {
+	Logger->Log("# PMTK %u Hz at %u baud, GSV off.\n", Rate, fBaudRate);
+	Send("PMTK314,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+	if (Ack(314, kAckSeconds) != 3)
+	{
+	    Logger->Log("# PMTK314 not acknowledged.\n");
+	}
+    }
+    // 4, fix interval.
+    snprintf(msg, sizeof(msg), "PMTK220,%u", 1000/Rate);
+    Send(msg);
+    if (Ack(220, kAckSeconds) != 3)
+    {
+	Logger->Log("# PMTK220 not acknowledged.\n");
+    }
+
+    // 5, did it take?
+    Listen(kVerifySeconds, &Measured);
+    if ((Measured < (1.0 - kRateTolerance)*Rate) ||
+	(Measured > (1.0 + kRateTolerance)*Rate))
+    {
+	Logger->Log("# PMTK asked for %u Hz, measured %.2f Hz, back to 1 Hz.\n",
+		    Rate, Measured);
+	Send("PMTK220,1000");
+	Ack(220, kAckSeconds);
+	fFixRate = 1.0;
+	SET_DEBUG_STACK;
+	return false;
+    }
+    fFixRate = (double) Rate;
+    Logger->Log("# PMTK %u baud, %u Hz, measured %.2f Hz.\n", fBaudRate,
+		Rate, Measured);
+    SET_DEBUG_STACK;
+    return rv;
+}
@@ -0,0 +1,101 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : PMTK.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Bring the MT3339 up to a faster port speed and fix
+ *     rate with PMTK commands, and check it took.
+ *
+ *         1  find the speed the receiver is talking at, the target
+ *            first, then 9600, then the rest
+ *         2  PMTK251 to the target speed, follow it, check the
+ *            sentences still come in good, else find it again
+ *         3  the rate is cut to what the port speed can carry
+ *            without GSV, and only if the receiver's own sentence
+ *            set will not fit, PMTK314 drops GSV, GGA GSA RMC VTG
+ *            on every fix
+ *         4  PMTK220 fix interval
+ *         5  time the GGAs, within kRateTolerance of the rate
+ *            asked for or back to 1 Hz
+ *
+ *     GTOP does not call this for the factory 9600 baud, 1 Hz.
+ *
+ *     Speed changes are made on the open descriptor with SerialSpeed
+ *     so the SerialFramer and the event loop keep using it.
+ *
+ * Restrictions/Limitations :
+ *     Run before the event loop starts, it blocks for a few seconds.
+ *     PMTK251 is lost at power off unless the receiver has its
+ *     backup battery, step 1 copes with either.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  PMTK314 only when the default set does not fit,
+ *                 the receiver is found again after a failed PMTK251.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     GlobalTop PMTK command packet, MT3339 platform, rev A07.
+ *
+ *******************************************************************
+ */
+#ifndef __PMTK_hh_
+#define __PMTK_hh_
+#  include <stdint.h>
+#  include "CObject.hh"
+#  include "SerialFramer.hh"
+#  include "NMEASentence.hh"
+
+/// PMTK - speed and fix rate negotiation with the MT3339.
+class PMTK : public CObject
+{
+public:
+    /*! Bytes in one epoch of GGA, GSA, 3 GSV, RMC and VTG, generous. */
+    static const uint32_t kEpochBytes = 550;
+    /*! The same without GSV, what GTOP uses. */
+    static const uint32_t kCoreEpochBytes = 300;
+    /*! Measured rate must be this close to the rate asked for. */
+    static constexpr double kRateTolerance = 0.15;
+
+    PMTK(SerialFramer *Framer);
+    ~PMTK(void);
+
+    /*!
+     * Description:
+     *   Negotiate, see above.
+     *
+     * Arguments:
+     *   BaudRate - bits a second, 4800 to 115200
+     *   FixRate  - fixes a second, 1 to 10
+     *
+     * Returns:
+     *   true if both were had as asked. Either way BaudRate() and
+     *   FixRate() are what the receiver is doing now.
+     *
+     * Errors:
+     *   logged, false
+     */
+    bool Negotiate(uint32_t BaudRate, uint32_t FixRate);
+
+    inline uint32_t BaudRate(void) const {return fBaudRate;};
+    inline double   FixRate(void)  const {return fFixRate;};
+
+    /*! true for a speed this module can set. */
+    static bool ValidBaud(uint32_t BaudRate);
+
+private:
+    SerialFramer *fFramer;
+    NMEASentence fSentence;
+    uint32_t     fBaudRate;
+    double       fFixRate;
+
+    bool     Speed(uint32_t BaudRate);
+    bool     Send(const char *Body);
+    int      Ack(uint32_t Command, double Seconds);
+    uint32_t Listen(double Seconds, double *GGARate);
+    bool     Probe(uint32_t BaudRate);
+    uint32_t Find(uint32_t First);
+};
+#endif
@@ -0,0 +1,245 @@
+/********************************************************************
+ *
+ * Module Name : PPS.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Kernel PPS edges paired with the GGA seconds.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     RFC 2783
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "PPS.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : NS
+ *
+ * Description : timespec to ns.
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static inline int64_t NS(const struct timespec &t)
+{
+    return (int64_t) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PPS constructor
+ *
+ * Description : open, time_pps_create, check it can capture assert
+ *     edges and ask for them as timespecs.
+ *
+ * Inputs : Device - /dev/ppsN
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : SetError(-1), logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+PPS::PPS(const char *Device) : CObject()
+{
+    SET_DEBUG_STACK;
+    CLogger     *pLog = CLogger::GetThis();
+    int          mode;
+    pps_params_t params;
+
+    SetName("PPS");
+    SetError();
+    fHandle       = 0;
+    fHaveHandle   = false;
+    fLogged       = false;
+    fLastSequence = 0;
+    fMissed       = 0;
+    fEdges        = 0;
+    fPaired       = 0;
+    fStale        = 0;
+
+    fFD = open(Device, O_RDWR);
+    if (fFD < 0)
+    {
+	pLog->Log("# PPS open %s: %s\n", Device, strerror(errno));
+	SetError(-1);
+	return;
+    }
+    if (time_pps_create(fFD, &fHandle) < 0)
+    {
+	pLog->Log("# PPS %s time_pps_create: %s\n", Device, strerror(errno));
+	SetError(-1);
+	return;
+    }
+    fHaveHandle = true;
+
+    if ((time_pps_getcap(fHandle, &mode) < 0) ||
+	((mode & PPS_CAPTUREASSERT) == 0) || ((mode & PPS_TSFMT_TSPEC) == 0))
+    {
+	pLog->Log("# PPS %s does not capture assert edges.\n", Device);
+	SetError(-1);
+	return;
+    }
+
+    /*
+     * Most drivers capture assert by default, so failing to set it,
+     * without write access say, is not fatal.
+     */
+    memset(&params, 0, sizeof(params));
+    if (time_pps_getparams(fHandle, &params) == 0)
+    {
+	params.mode |= PPS_CAPTUREASSERT | PPS_TSFMT_TSPEC;
+	if (time_pps_setparams(fHandle, &params) < 0)
+	{
+	    pLog->Log("# PPS %s capture mode not set: %s\n", Device,
+		      strerror(errno));
+	}
+    }
+    pLog->Log("# PPS %s open.\n", Device);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PPS destructor
+ *
+ * Description : time_pps_destroy and close.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+PPS::~PPS(void)
+{
+    if (fHaveHandle)
+	time_pps_destroy(fHandle);
+    if (fFD >= 0)
+	close(fFD);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Pair
+ *
+ * Description : Fetch the last edge without waiting. One newer than
+ *     RxReal belongs to a later GGA and is left for it. Otherwise the
+ *     edge is used up here, paired if this GGA is the one that
+ *     starts its second.
+ *
+ *     The kernel stamp is CLOCK_REALTIME only, the monotonic time
+ *     of the edge is CLOCK_MONOTONIC now less the realtime since the
+ *     edge, under a second so slewing does not matter.
+ *
+ * Inputs :
+ *     RxReal    - GGA first byte
+ *     GPSSecond - GGA whole seconds, UTC
+ *     Milli     - GGA fraction
+ *     Rec       - out
+ *
+ * Returns : true if Rec was filled in
+ *
+ * Error Conditions : fetch failure logged once
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool PPS::Pair(const struct timespec &RxReal, int64_t GPSSecond,
+	       double Milli, PPSTime &Rec)
+{
+    SET_DEBUG_STACK;
+    const struct timespec Zero = {0, 0};
+    struct timespec RealNow, MonoNow;
+    pps_info_t      info;
+    int64_t         Edge, Lag;
+    uint64_t        New;
+
+    if (time_pps_fetch(fHandle, PPS_TSFMT_TSPEC, &info, &Zero) < 0)
+    {
+	if (!fLogged)
+	{
+	    CLogger::GetThis()->Log("# PPS fetch: %s\n", strerror(errno));
+	    fLogged = true;
+	}
+	return false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &MonoNow);
+    clock_gettime(CLOCK_REALTIME,  &RealNow);
+
+    // At more than 1 Hz most GGAs find the edge already used.
+    if ((info.assert_sequence == fLastSequence) ||
+	(info.assert_sequence == 0))
+	return false;
+
+    Edge = NS(info.assert_timestamp);
+    Lag  = NS(RxReal) - Edge;
+    if (Lag < 0)
+	return false;
+
+    New = (fEdges == 0) ? 1 : info.assert_sequence - fLastSequence;
+    fEdges        += New;
+    fMissed       += (uint32_t)(New - 1);
+    fLastSequence  = info.assert_sequence;
+
+    if ((Lag > (int64_t)(kMaxLag * 1.0e9)) || (Milli > kMaxMilli))
+    {
+	fStale++;
+	fMissed++;
+	return false;
+    }
+
+    Rec.Version         = kPPSTimeVersion;
+    Rec.Missed          = fMissed;
+    Rec.Sequence        = info.assert_sequence;
+    Rec.GPSSecond       = GPSSecond;
+    Rec.AssertRealTime  = (uint64_t) Edge;
+    Rec.AssertMonotonic = (uint64_t)(NS(MonoNow) - (NS(RealNow) - Edge));
+    Rec.Offset          = Edge - GPSSecond * 1000000000LL;
+    Rec.Latency         = Lag;
+
+    fMissed = 0;
+    fPaired++;
+    SET_DEBUG_STACK;
+    return true;
+}
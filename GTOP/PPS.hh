@@ -0,0 +1,109 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : PPS.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : The receiver's 1PPS through the kernel PPS driver,
+ *     /dev/ppsN, read with the RFC 2783 time_pps_fetch API. Each
+ *     assert edge is paired with the GGA that follows it, which
+ *     says what second the edge started, giving a PPSTime record.
+ *
+ *     No thread and no wait, the kernel keeps the last edge and its
+ *     stamp, Pair fetches them with a zero timeout when a GGA comes
+ *     in. An edge is taken when
+ *
+ *         it is new since the last Pair
+ *         the GGA first byte came 0 to kMaxLag s after it
+ *         the GGA is on the whole second, Milli < kMaxMilli
+ *
+ *     The MT3339 PPS line goes to a GPIO with the pps-gpio overlay,
+ *     dtoverlay=pps-gpio,gpiopin=N in config.txt. With no receiver
+ *     modprobe pps-ktimer gives a /dev/pps0 that asserts once a
+ *     second off a kernel timer, fine for exercising this, the
+ *     Offsets are then nonsense.
+ *
+ * Restrictions/Limitations :
+ *     Needs timepps.h, apt install pps-tools, and read and write on
+ *     the device to set the capture mode.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     RFC 2783, Pulse-Per-Second API for UNIX-like Operating Systems
+ *     Documentation/driver-api/pps.rst in the kernel tree
+ *
+ *******************************************************************
+ */
+#ifndef __PPS_hh_
+#define __PPS_hh_
+#  include <stdint.h>
+#  include <time.h>
+#  include <sys/timepps.h>
+#  include "CObject.hh"
+#  include "PPSTime.hh"
+
+/// PPS - GPS second boundaries from the kernel PPS stamps.
+class PPS : public CObject
+{
+public:
+    /*! Longest edge to GGA first byte taken as the same second, s. */
+    static constexpr double kMaxLag   = 0.95;
+    /*! GGA fraction of a second allowed, s, it should be .000 */
+    static constexpr double kMaxMilli = 0.05;
+
+    /*!
+     * Description:
+     *   Open the device and ask for assert stamps as timespecs.
+     *
+     * Arguments:
+     *   Device - e.g. /dev/pps0
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   logged, SetError(-1) if it cannot be opened or does not
+     *   capture assert edges.
+     */
+    PPS(const char *Device);
+    ~PPS(void);
+
+    /*!
+     * Description:
+     *   Pair the last edge with a GGA just parsed.
+     *
+     * Arguments:
+     *   RxReal    - first byte of the GGA, CLOCK_REALTIME
+     *   GPSSecond - GGA time, whole UTC seconds since the epoch
+     *   Milli     - GGA fraction of a second
+     *   Rec       - filled in when true is returned
+     *
+     * Returns:
+     *   true if there was a new edge for this GGA.
+     *
+     * Errors:
+     *   fetch failures logged once, false
+     */
+    bool Pair(const struct timespec &RxReal, int64_t GPSSecond,
+	      double Milli, PPSTime &Rec);
+
+    inline uint64_t Edges(void)  const {return fEdges;};
+    inline uint64_t Paired(void) const {return fPaired;};
+    inline uint64_t Stale(void)  const {return fStale;};
+
+private:
+    int          fFD;
+    pps_handle_t fHandle;
+    bool         fHaveHandle;
+    bool         fLogged;
+    uint64_t     fLastSequence;  // last edge seen
+    uint32_t     fMissed;        // edges since the last pair
+    uint64_t     fEdges;
+    uint64_t     fPaired;
+    uint64_t     fStale;         // new edge, wrong GGA
+};
+#endif
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : PPSTime.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : One PPS edge paired with the NMEA epoch that names
+ *     its second, the GPS second boundary in system time. GTOP puts
+ *     one a second in the GPS_PPS snapshot.
+ *
+ *     The edge time is the kernel's stamp from the PPS interrupt,
+ *     not our loop, so Offset is good to the interrupt latency,
+ *     a few microseconds or better. A reader corrects its own
+ *     CLOCK_REALTIME stamps, t, taken within a second or so of the
+ *     edge
+ *
+ *         GPS time = t - Offset
+ *
+ *     and CLOCK_MONOTONIC ones against AssertMonotonic.
+ *
+ * Restrictions/Limitations :
+ *     Packed, little endian (the Pi). Python readers use
+ *     '<IIQqQQqq'.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     RFC 2783, Pulse-Per-Second API for UNIX-like Operating Systems
+ *
+ *******************************************************************
+ */
+#ifndef __PPSTIME_hh_
+#define __PPSTIME_hh_
+#    include <stdint.h>
+#    include "SMSchema.hh"
+
+/*!
+ * One paired edge.
+ */
+struct PPSTime {
+    uint32_t Version;          // kPPSTimeVersion
+    uint32_t Missed;           // edges not paired since the last one
+    uint64_t Sequence;         // kernel assert sequence number
+    int64_t  GPSSecond;        // UTC second the edge starts, unix
+    uint64_t AssertRealTime;   // ns, CLOCK_REALTIME, kernel stamp
+    uint64_t AssertMonotonic;  // ns, the same instant, CLOCK_MONOTONIC
+    int64_t  Offset;           // ns, AssertRealTime - GPSSecond,
+                               // system clock ahead is positive
+    int64_t  Latency;          // ns, edge to the first byte of the GGA
+} __attribute__((packed));
+
+/*! Bump on any change above. */
+const uint32_t kPPSTimeVersion = 1;
+
+/*! PPSTime layout, for the shared memory registry. */
+inline const SMSchema& PPSTimeSchema(void)
+{
+    static const SMField kFields[] = {
+	SM_MEMBER(PPSTime, Version,         "Version"),
+	SM_MEMBER(PPSTime, Missed,          "Missed"),
+	SM_MEMBER(PPSTime, Sequence,        "Sequence"),
+	SM_MEMBER(PPSTime, GPSSecond,       "GPSSecond"),
+	SM_MEMBER(PPSTime, AssertRealTime,  "AssertRealTime"),
+	SM_MEMBER(PPSTime, AssertMonotonic, "AssertMonotonic"),
+	SM_MEMBER(PPSTime, Offset,          "Offset"),
+	SM_MEMBER(PPSTime, Latency,         "Latency"),
+    };
+    static const SMSchema kSchema("PPSTime", kFields, SM_NFIELDS(kFields));
+    return kSchema;
+}
+#endif
@@ -0,0 +1,317 @@
+/********************************************************************
+ *
+ * Module Name : SerialFramer.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Buffered, non blocking serial read, lines split in
+ *     place.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Receive stamps. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SerialFramer.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SerialFramer constructor
+ *
+ * Description : Empty buffer, port to non blocking.
+ *
+ * Inputs : fd - open serial port
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : SetError(-1) if fcntl fails.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SerialFramer::SerialFramer(int fd) : CObject()
+{
+    SET_DEBUG_STACK;
+    int flags;
+
+    SetName("SerialFramer");
+    SetError();
+
+    fFD        = fd;
+    fStart     = 0;
+    fScan      = 0;
+    fEnd       = 0;
+    fDiscard   = false;
+    fLogged    = false;
+    fReads     = 0;
+    fBytes     = 0;
+    fLines     = 0;
+    fOverflows = 0;
+    fNStamps   = 0;
+    fBuffer[0] = 0;
+
+    flags = fcntl(fFD, F_GETFL, 0);
+    if ((flags < 0) || (fcntl(fFD, F_SETFL, flags | O_NONBLOCK) < 0))
+    {
+	CLogger::GetThis()->Log("# SerialFramer fcntl: %s\n", strerror(errno));
+	SetError(-1);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SerialFramer destructor
+ *
+ * Description : The port belongs to the caller, it stays open.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SerialFramer::~SerialFramer(void)
+{
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Fill
+ *
+ * Description : Stamp, move the unread tail to the front, then one
+ *     read into the rest of the buffer.
+ *
+ * Inputs : NONE
+ *
+ * Returns : bytes read, 0 if nothing waiting, -1 on error or EOF.
+ *
+ * Error Conditions : logged the first time
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int SerialFramer::Fill(void)
+{
+    struct timespec Real, Mono;
+    ssize_t n;
+    size_t  i, k;
+
+    // First, as close to the wake up as we can.
+    clock_gettime(CLOCK_REALTIME,  &Real);
+    clock_gettime(CLOCK_MONOTONIC, &Mono);
+
+    if (fStart > 0)
+    {
+	memmove(fBuffer, fBuffer + fStart, fEnd - fStart);
+	// Keep the stamp the tail started in and those after it.
+	for (i = 0, k = 0; i < fNStamps; i++)
+	{
+	    if ((i + 1 < fNStamps) && (fStamps[i+1].At <= fStart))
+		continue;
+	    fStamps[k]    = fStamps[i];
+	    fStamps[k].At = (fStamps[i].At > fStart) ? fStamps[i].At - fStart
+		: 0;
+	    k++;
+	}
+	fNStamps = (fEnd > fStart) ? k : 0;
+	fEnd  -= fStart;
+	fScan -= fStart;
+	fStart = 0;
+    }
+    if (fEnd == kBufferSize)
+    {
+	// Nothing but one over long line, Next drops it.
+	return 0;
+    }
+
+    n = read(fFD, fBuffer + fEnd, kBufferSize - fEnd);
+    if (n > 0)
+    {
+	if (fNStamps == kMaxStamps)
+	{
+	    // Reads with no Next between, lines keep the older stamp.
+	    fNStamps--;
+	}
+	else
+	{
+	    fStamps[fNStamps].At        = fEnd;
+	    fStamps[fNStamps].RealTime  = Real;
+	    fStamps[fNStamps].Monotonic = Mono;
+	}
+	fNStamps++;
+	fEnd   += (size_t) n;
+	fBytes += (uint64_t) n;
+	fReads++;
+	return (int) n;
+    }
+    if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+		    (errno == EINTR)))
+    {
+	return 0;
+    }
+    if (!fLogged)
+    {
+	CLogger::GetThis()->Log("# SerialFramer read: %s\n",
+				(n == 0) ? "end of file" : strerror(errno));
+	fLogged = true;
+    }
+    return -1;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : Find the next '\n' past fScan, terminate the line
+ *     there and drop a trailing '\r'. Over long lines are thrown
+ *     away up to their '\n'. The line gets the stamps of the last
+ *     Fill that started at or before its first byte.
+ *
+ * Inputs : Line - filled in
+ *
+ * Returns : true if a line was found
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SerialFramer::Next(SerialLine &Line)
+{
+    char   *nl;
+    size_t length;
+
+    while (fScan < fEnd)
+    {
+	nl = (char *) memchr(fBuffer + fScan, '\n', fEnd - fScan);
+	if (nl == NULL)
+	{
+	    fScan = fEnd;
+	    if (fDiscard)
+	    {
+		fStart = fEnd;
+	    }
+	    else if (fEnd - fStart > kMaxLine)
+	    {
+		// No end in sight, drop what there is.
+		fOverflows++;
+		fDiscard = true;
+		fStart   = fEnd;
+	    }
+	    return false;
+	}
+
+	*nl    = 0;
+	length = nl - (fBuffer + fStart);
+	Line.Data = fBuffer + fStart;
+	fStart = fScan = (nl - fBuffer) + 1;
+
+	if (fDiscard)
+	{
+	    // Tail of a line already dropped.
+	    fDiscard = false;
+	    continue;
+	}
+	if ((length > 0) && (Line.Data[length-1] == '\r'))
+	{
+	    ((char *) Line.Data)[--length] = 0;
+	}
+	if (length == 0)
+	{
+	    continue;
+	}
+	if (length > kMaxLine)
+	{
+	    fOverflows++;
+	    continue;
+	}
+	Line.Length = length;
+	memset(&Line.RealTime,  0, sizeof(Line.RealTime));
+	memset(&Line.Monotonic, 0, sizeof(Line.Monotonic));
+	for (size_t i = fNStamps; i > 0; i--)
+	{
+	    if (fStamps[i-1].At <= (size_t)(Line.Data - fBuffer))
+	    {
+		Line.RealTime  = fStamps[i-1].RealTime;
+		Line.Monotonic = fStamps[i-1].Monotonic;
+		break;
+	    }
+	}
+	fLines++;
+	return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Wait
+ *
+ * Description : poll the port.
+ *
+ * Inputs : TimeoutMS - -1 forever
+ *
+ * Returns : true if there is something to read
+ *
+ * Error Conditions : false on an error, EINTR included
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SerialFramer::Wait(int TimeoutMS)
+{
+    struct pollfd p;
+
+    p.fd      = fFD;
+    p.events  = POLLIN;
+    p.revents = 0;
+    return (poll(&p, 1, TimeoutMS) > 0) && (p.revents & (POLLIN | POLLHUP));
+}
@@ -0,0 +1,143 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SerialFramer.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Buffered, non blocking read of the GPS serial port
+ *     with the sentences split in place. Fill takes everything the
+ *     driver has in one read, Next hands out each complete line as
+ *     a view into the buffer, null terminated where the '\n' was, so
+ *     nothing is copied or allocated per byte or per sentence.
+ *
+ *     A line is good until the next Fill, which moves any partial
+ *     sentence to the front of the buffer to make room.
+ *
+ *     Fill takes CLOCK_REALTIME and CLOCK_MONOTONIC before its read,
+ *     right after the caller woke for the port, and each line
+ *     carries the stamps of the Fill that brought its first byte. A
+ *     sentence continued over several reads keeps the first one.
+ *
+ * Restrictions/Limitations :
+ *     Lines longer than kMaxLine are dropped, counted in Overflows.
+ *     Empty lines, the ICRNL half of a "\r\n", are skipped.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  First byte receive stamps on each line. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SERIALFRAMER_hh_
+#define __SERIALFRAMER_hh_
+#  include <stddef.h>
+#  include <stdint.h>
+#  include <time.h>
+#  include "CObject.hh"
+
+/*! One sentence, a view into the framer buffer. */
+struct SerialLine {
+    const char      *Data;      // null terminated, no '\r' or '\n'
+    size_t          Length;
+    struct timespec RealTime;   // first byte read, CLOCK_REALTIME
+    struct timespec Monotonic;  // and CLOCK_MONOTONIC
+};
+
+/// SerialFramer - whole lines from a non blocking serial port.
+class SerialFramer : public CObject
+{
+public:
+    /*! Longest sentence kept, NMEA allows 82. */
+    static const size_t kMaxLine   = 256;
+    /*! Buffer, several seconds of sentences at 9600 baud. */
+    static const size_t kBufferSize = 4096;
+
+    /*!
+     * Description:
+     *   Take over fd, it is switched to non blocking.
+     *
+     * Arguments:
+     *   fd - open serial port
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   SetError(-1) if the flags could not be set.
+     */
+    SerialFramer(int fd);
+    ~SerialFramer(void);
+
+    /*!
+     * Description:
+     *   Read what the driver has, one read call.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   bytes read, 0 if none were waiting, -1 on error or end of
+     *   file.
+     *
+     * Errors:
+     *   logged once
+     */
+    int Fill(void);
+
+    /*!
+     * Description:
+     *   Next complete line already in the buffer.
+     *
+     * Arguments:
+     *   Line - filled in, good until the next Fill.
+     *
+     * Returns:
+     *   true if there was one.
+     *
+     * Errors:
+     *   NONE
+     */
+    bool Next(SerialLine &Line);
+
+    /*! Forget anything buffered, after a change of speed. */
+    void Reset(void) {fStart = fScan = fEnd = 0; fDiscard = false;
+	fNStamps = 0;};
+
+    /*! Wait up to TimeoutMS for the port to be readable. */
+    bool Wait(int TimeoutMS);
+
+    inline int      fd(void)        const {return fFD;};
+    inline uint64_t Reads(void)     const {return fReads;};
+    inline uint64_t Bytes(void)     const {return fBytes;};
+    inline uint64_t Lines(void)     const {return fLines;};
+    inline uint64_t Overflows(void) const {return fOverflows;};
+
+private:
+    int      fFD;
+    char     fBuffer[kBufferSize+1];
+    size_t   fStart;      // first byte not yet handed out
+    size_t   fScan;       // searched for '\n' up to here
+    size_t   fEnd;        // one past the last byte read
+    bool     fDiscard;    // dropping an over long line
+    bool     fLogged;
+
+    /*! Where each Fill since the last compaction started, and when. */
+    struct Stamp {
+	size_t          At;
+	struct timespec RealTime;
+	struct timespec Monotonic;
+    };
+    static const size_t kMaxStamps = 16;
+    Stamp    fStamps[kMaxStamps];
+    size_t   fNStamps;
+
+    uint64_t fReads;
+    uint64_t fBytes;
+    uint64_t fLines;
+    uint64_t fOverflows;
+};
+#endif
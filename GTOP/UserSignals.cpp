@@ -10,6 +10,11 @@
  *
  * Change Descriptions :
  * 08-Sep-25   CBL changed SIGUSR2 to force log filename change. 
+ * 17-Oct-26   CBL SIGUSR1, SIGUSR2, SIGTERM and SIGINT blocked, 
+ *             GTOP::Do takes them from a signalfd between sentences.
+ * 17-Oct-26   CBL Only SIGUSR1 and SIGUSR2 blocked here, GTOP::Do
+ *             blocks SIGTERM and SIGINT once its loop is ready, so
+ *             CTRL+C still works while the port is negotiated. 
  *
  * Classification : Unclassified
  *
@@ -25,6 +30,7 @@ using namespace std;
 #include <cstring>
 #include <unistd.h>
 #include <csignal>
+#include <pthread.h>
 
 
 // Local Includes.
@@ -251,4 +257,44 @@ void SetSignals(void)
     signal (SIGUSR1, UserSignal);
     signal (SIGUSR2, UserSignal);  
 
+    /*
+     * Block the user signals the run loop reads from its signalfd. 
+     * This is called before the display thread starts so every 
+     * thread inherits the mask. SIGTERM and SIGINT stay with 
+     * Terminate until GTOP::Do is ready for them, the setup before
+     * that can take several seconds. 
+     */
+    sigset_t Set;
+    sigemptyset(&Set);
+    sigaddset(&Set, SIGUSR1);
+    sigaddset(&Set, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &Set, NULL);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LoopSignals
+ *
+ * Description : The signals handled in the GTOP::Do loop.
+ *
+ * Inputs : Set - filled in
+ *
+ * Returns : none
+ *
+ * Error Conditions : None
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void LoopSignals(sigset_t *Set)
+{
+    sigemptyset(Set);
+    sigaddset(Set, SIGUSR1);
+    sigaddset(Set, SIGUSR2);
+    sigaddset(Set, SIGTERM);
+    sigaddset(Set, SIGINT);
 }
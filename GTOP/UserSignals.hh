@@ -11,6 +11,8 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  LoopSignals, taken by GTOP::Do from a signalfd.
+ * 17-Oct-26  CBL  SIGTERM and SIGINT blocked by GTOP::Do, not SetSignals.
  *
  * Classification : Unclassified
  *
@@ -21,6 +23,7 @@
  */
 #ifndef __USERSIGNALS_hh_
 #define __USERSIGNALS_hh_
+#  include <csignal>
 /*!
  * Terminate - this function is used by the module and is linked to most of
  * the signals associated with the overall module. 
@@ -34,5 +37,12 @@ void UserSignal(int sig);
  * Call to setup all signals. 
  */
 void SetSignals(void);
+/*!
+ * The signals GTOP::Do reads from its signalfd, SIGUSR1, SIGUSR2,
+ * SIGTERM and SIGINT. SetSignals blocks the first two in every 
+ * thread, GTOP::Do the other two when its loop starts. The display
+ * and archive threads start with all four blocked.
+ */
+void LoopSignals(sigset_t *Set);
 
 #endif
@@ -13,6 +13,7 @@
  *
  * 18-Feb-22  CBL   Allow the display to be turned off. 
  *                  set the startup characteristics in a cfg file
+ * 17-Oct-26  CBL   Display thread started with the loop signals blocked.
  *
  * Classification : Unclassified
  *
@@ -196,6 +197,13 @@ static bool Initialize(void)
 	/* If the user has requested the display feature, start it now. */
 	/* create the display. */
 	pDisp = new GTOP_Display();
+	/* 
+	 * The display thread takes no signals, they are for 
+	 * Terminate here or GTOP::Do's signalfd later. 
+	 */
+	sigset_t Set, Old;
+	LoopSignals(&Set);
+	pthread_sigmask(SIG_BLOCK, &Set, &Old);
 	if( pthread_create(&d_thread, NULL, DisplayThread, NULL) == 0)
 	{
 	    logger->Log("# Display Thread successfully created.\n");
@@ -206,6 +214,7 @@ static bool Initialize(void)
 	    /* It is not the end of the world if this fails. */
 	    logger->Log("# Dispaly Thread failed.\n");
 	}
+	pthread_sigmask(SIG_SETMASK, &Old, NULL);
     }
     logger->Log("# SIGUSR1: %d, SIGUSR2 %d\n", SIGUSR1, SIGUSR2);
     return true;
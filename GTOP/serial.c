@@ -10,6 +10,7 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  SerialSpeed, change the baud rate of the open port.
  *
  * Classification : Unclassified
  *
@@ -200,3 +201,43 @@ void CloseSerial(void)
 {
     close(serial_fd);
 }
+/**
+ ******************************************************************
+ *
+ * Function Name : SerialSpeed
+ *
+ * Description : Change the speed of the open port in place, the 
+ *     descriptor and the rest of the settings stay. Output already
+ *     queued is sent at the old speed first, input is flushed. 
+ *
+ * Inputs : BaudRate - B9600 ...
+ *
+ * Returns : 0 on success, -1 on failure
+ *
+ * Error Conditions : errno from tcsetattr
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int SerialSpeed(speed_t BaudRate)
+{
+    struct termios tio;
+
+    if (tcgetattr( serial_fd, &tio) < 0)
+    {
+	return -1;
+    }
+    cfsetispeed( &tio, BaudRate);
+    cfsetospeed( &tio, BaudRate);
+    tcdrain(serial_fd);
+    if (tcsetattr( serial_fd, TCSANOW, &tio) < 0)
+    {
+	return -1;
+    }
+    tcflush( serial_fd, TCIFLUSH);
+    return 0;
+}
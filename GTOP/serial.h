@@ -10,6 +10,7 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  SerialSpeed
  *
  * Classification : Unclassified
  *
@@ -40,6 +41,11 @@
        * Close the serial port down. 
        */
       void CloseSerial();
+      /*!
+       * @brief SerialSpeed
+       * Change the baud rate of the open port, 0 on success. 
+       */
+      int SerialSpeed(speed_t BaudRate);
 # ifdef __cplusplus
   }
 # endif
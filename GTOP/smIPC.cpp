@@ -22,6 +22,15 @@
  *                     be larger. 
  * 18-Mar-26    CBL    Added in a telegram command to put a marker in 
  *                     the H5 file.
+ * 17-Oct-26    CBL    GGA_Ring and RMC_Ring. 
+ * 17-Oct-26    CBL    GGA/GSA/VTG/RMC_Snap. 
+ * 17-Oct-26    CBL    GPS_Fix. 
+ * 17-Oct-26    CBL    GPS_CmdQ, commands no longer overwrite each
+ *                     other and are not tied to the GPS updates. 
+ * 17-Oct-26    CBL    Register the rings and snapshots. 
+ * 17-Oct-26    CBL    SetRate, the fix rate PMTK negotiated. 
+ * 17-Oct-26    CBL    GPS_Fix carries the GGA receive stamps. 
+ * 17-Oct-26    CBL    GPS_PPS snapshot of PPSTime. 
  *
  * Classification : Unclassified
  *
@@ -43,12 +52,23 @@ using namespace std;
 #include "smIPC.hh"
 #include "GTOP.hh"
 
-// 22-Feb-26 upped command size allocation to 512
-const size_t kCommandSize  = 512;          // Bytes of command data.
-const size_t kFilenameSize = 512;         // Bytes of data open to filename
-static char zerobuf[kCommandSize];
-
 #define DEBUG_SM 0
+
+/*! Fixes a second, the receiver default until SetRate. */
+static const double kFixRate = 1.0;
+
+/*
+ * The messages are libNMEA's own classes, we only know their
+ * DataSize, so the registry sees each as one run of bytes. 
+ */
+static const SMField kGGAFields[] = {SM_BYTES("GGA", 0, GGA::DataSize())};
+static const SMField kGSAFields[] = {SM_BYTES("GSA", 0, GSA::DataSize())};
+static const SMField kVTGFields[] = {SM_BYTES("VTG", 0, VTG::DataSize())};
+static const SMField kRMCFields[] = {SM_BYTES("RMC", 0, RMC::DataSize())};
+static const SMSchema kGGASchema("GGA", kGGAFields, 1);
+static const SMSchema kGSASchema("GSA", kGSAFields, 1);
+static const SMSchema kVTGSchema("VTG", kVTGFields, 1);
+static const SMSchema kRMCSchema("RMC", kRMCFields, 1);
 /**
  ******************************************************************
  *
@@ -82,13 +102,21 @@ GPS_IPC::GPS_IPC(void) : CObject()
 
     plogger->LogCommentTimestamp("IPC Initialize, shared memory.");
 
-    pSM_Commands      = NULL;
+    fCommands         = NULL;
     pSM_PositionData  = NULL;
     pSM_SolutionData  = NULL;
     pSM_VelocityData  = NULL;
     pSM_Minimum       = NULL;
-
-    memset(zerobuf, 0, sizeof(zerobuf));
+    fGGARing          = NULL;
+    fRMCRing          = NULL;
+    fGGASnap          = NULL;
+    fGSASnap          = NULL;
+    fVTGSnap          = NULL;
+    fRMCSnap          = NULL;
+    fFixSnap          = NULL;
+    fFix              = NULL;
+    fEpoch            = 0;
+    fPPSSnap          = NULL;
 
     pSM_PositionData = new SharedMem2("GGA", 
 				      GGA::DataSize(), true);
@@ -162,25 +190,123 @@ GPS_IPC::GPS_IPC(void) : CObject()
     }
 
 
-    pSM_Commands = new SharedMem2("GPS_Commands", kCommandSize, true);
-    if (pSM_Commands->CheckError())
+    // A fresh queue each start, nothing left over from the last run. 
+    fCommands = new SMCommandQueue("GPS_CmdQ", kCommandDepth, kCommandReplies);
+    if (fCommands->CheckError())
     {
 	plogger->Log("# %s %d Commands shared memory failed.\n", 
 		    __FILE__,  __LINE__);
-	delete pSM_Commands;
-	pSM_Commands = NULL;
+	delete fCommands;
+	fCommands = NULL;
 	SetError(-5);
     }
     else
     {
 	plogger->Log("# %s %d Commands shared memory attached.\n",
 		    __FILE__,  __LINE__);
-	// Sometimes there is residual crap in the buffer that 
-	// needs clearing
-	pSM_Commands->PutData(zerobuf);
-        pSM_Commands->PutData(0.0);
     }
+
+    /*
+     * The single slot segments above hold the latest fix, a reader
+     * that polls slower than the fix rate loses the rest. The rings
+     * keep 25s at 10Hz for readers that want every one. 
+     */
+    fGGARing = MakeRing("GGA_Ring", kGGASchema);
+    fRMCRing = MakeRing("RMC_Ring", kRMCSchema);
+
+    fGGASnap = MakeSnapshot("GGA_Snap", kGGASchema);
+    fGSASnap = MakeSnapshot("GSA_Snap", kGSASchema);
+    fVTGSnap = MakeSnapshot("VTG_Snap", kVTGSchema);
+    fRMCSnap = MakeSnapshot("RMC_Snap", kRMCSchema);
+
+    fFixSnap = MakeSnapshot("GPS_Fix", GPSFix::Schema());
+    if (fFixSnap)
+    {
+	fFix = new GPSFix();
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  MakeRing
+ *
+ * Description : Create an SMRing and list it in the registry, not
+ *     fatal if it fails. 
+ *
+ * Inputs : 
+ *     Name   - segment name
+ *     Schema - layout of the message
+ *
+ * Returns : the ring or NULL
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMRing* GPS_IPC::MakeRing(const char *Name, const SMSchema &Schema)
+{
+    SET_DEBUG_STACK;
+    SMRing *rv = new SMRing(Name, Schema.Size(), kRingSize);
+    if (rv->CheckError())
+    {
+	CLogger::GetThis()->LogError(__FILE__, __LINE__, 'W',
+				     "GPS ring SM failed.");
+	delete rv;
+	rv = NULL;
+    }
+    else
+    {
+	rv->Register(Schema, kFixRate);
+    }
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  MakeSnapshot
+ *
+ * Description : Create an SMSnapshot and list it in the registry,
+ *     not fatal if it fails. 
+ *
+ * Inputs : 
+ *     Name   - segment name
+ *     Schema - layout of the record
+ *
+ * Returns : the snapshot or NULL
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMSnapshot* GPS_IPC::MakeSnapshot(const char *Name, const SMSchema &Schema)
+{
     SET_DEBUG_STACK;
+    SMSnapshot *rv = new SMSnapshot(Name, Schema.Size());
+    if (rv->CheckError())
+    {
+	CLogger::GetThis()->LogError(__FILE__, __LINE__, 'W',
+				     "GPS snapshot SM failed.");
+	delete rv;
+	rv = NULL;
+    }
+    else
+    {
+	rv->Register(Schema, kFixRate);
+    }
+    return rv;
 }
 
 /**
@@ -189,9 +315,11 @@ GPS_IPC::GPS_IPC(void) : CObject()
  * Function Name :  ProcessCommands
  *
  * Description : Process any commmands that have been issued by
- * the parent process. 
+ * the parent process, or any other. Each is answered in the reply
+ * area under its request ID. CF and GF reply with the current
+ * filespec. 
  *
- * Inputs : gps - lassen gps structure.
+ * Inputs : NONE
  *
  * Returns : none
  *
@@ -209,48 +337,38 @@ void GPS_IPC::ProcessCommands(void)
     SET_DEBUG_STACK;
     GTOP    *pGTOP    = GTOP::GetThis();
     CLogger *plogger  = CLogger::GetThis();
-    if (pSM_Commands != NULL)
-    {
-        // number of bytes in buffer
-	float available = pSM_Commands->GetData(); 
-	char command[kCommandSize];
-	memset(command, 0, sizeof(command));
+    SMCommandQueue::Command command;
+
+    if (fCommands == NULL)
+	return;
 
-	//plogger->LogTime("command loop, size: %f\n", available);
-	if (available > 0.0)
+    // Every command queued since the last pass, in order. 
+    while (fCommands->Next(command))
+    {
+	plogger->Log("# Command received: %lu from %d %s\n", 
+		     (unsigned long) command.ID, command.Client, command.Text);
+	// Process approprately.
+	if (strncmp( command.Text, "CF", 2) == 0)
+	{
+	    plogger->Log("# DEBUG: Change Filename command\n");
+	    pGTOP->UpdateFileName();
+	    fCommands->Respond(command.ID, 0, pGTOP->Filespec());
+	}
+	else if (strncmp( command.Text, "GF",2) == 0)
+	{
+	    // get the current filename. 
+	    fCommands->Respond(command.ID, 0, pGTOP->Filespec());
+	}
+	else if (strncmp( command.Text, "CM", 2) == 0)
+	{
+	    plogger->Log("# DEBUG: Marker command\n");
+	    // Marker in H5 file
+	    pGTOP->SetFlag(1);
+	    fCommands->Respond(command.ID, 0, NULL);
+	}
+	else
 	{
-	    pSM_Commands->GetData(command);
-	    // Null terminate
-	    command[(int)available + 1] = 0;
-	    plogger->Log("# Command received: %d %s\n", 
-			 (int)available, command);
-	    // Process approprately.
-	    if (strncmp( command, "CF", 2) == 0)
-	    {
-		plogger->Log("# DEBUG: Change Filename command\n");
-		GTOP::GetThis()->UpdateFileName();
-		// Now clear out the data buffer. 
-		// Otherwise the last command will stick around. 
-		pSM_Commands->PutData(zerobuf);
-		pSM_Commands->PutData(0.0);
-	    }
-	    else if (strncmp( command, "GF",2) == 0)
-	    {
-		// get the current filename. 
-		const char *filespec = pGTOP->Filespec();
-		pSM_Commands->PutData(filespec);
-
-	    }
-	    else if (strncmp( command, "CM", 2) == 0)
-	    {
-		plogger->Log("# DEBUG: Marker command\n");
-		// Marker in H5 file
-		pGTOP->SetFlag(1);
-	    }
-
-	    available = 0.0; // Commands have been processed. 
-	    memset( command, 0, kCommandSize);
-	    pSM_Commands->PutData(available);
+	    fCommands->Respond(command.ID, -1, "Unknown command");
 	}
     }
     SET_DEBUG_STACK;
@@ -293,30 +411,158 @@ void GPS_IPC::Update(void)
 	{
 	    pSM_PositionData->PutData(pGGA->DataPointer());
 	}
+	if (pGGA && fGGARing)
+	{
+	    fGGARing->Put(pGGA->DataPointer());
+	}
+	if (pGGA && fGGASnap)
+	{
+	    fGGASnap->Put(pGGA->DataPointer());
+	}
 
 	SET_DEBUG_STACK;
 	if(pGSA && pSM_SolutionData)
 	{
 	    pSM_SolutionData->PutData(pGSA->DataPointer());
 	}
+	if (pGSA && fGSASnap)
+	{
+	    fGSASnap->Put(pGSA->DataPointer());
+	}
 
 	SET_DEBUG_STACK;
 	if (pVTG && pSM_VelocityData)
 	{
 	    pSM_VelocityData->PutData(pVTG->DataPointer());
 	}
+	if (pVTG && fVTGSnap)
+	{
+	    fVTGSnap->Put(pVTG->DataPointer());
+	}
 
 	
 	if (pRMC && pSM_Minimum)
 	{
 	    pSM_Minimum->PutData( pRMC->DataPointer());
 	}
+	if (pRMC && fRMCRing)
+	{
+	    fRMCRing->Put(pRMC->DataPointer());
+	}
+	if (pRMC && fRMCSnap)
+	{
+	    fRMCSnap->Put(pRMC->DataPointer());
+	}
 
-	ProcessCommands();
+	// The whole epoch in one write. 
+	if (fFixSnap)
+	{
+	    fFix->Pack(++fEpoch, pGGA, pGSA, pVTG, pRMC,
+		       &pGTOP->GGARealTime(), &pGTOP->GGAMonotonic());
+	    fFixSnap->Put(fFix->Buffer());
+	}
     }
     SET_DEBUG_STACK;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name :  SetRate
+ *
+ * Description : Fixes a second now published, for the registry 
+ *     entries of the rings and snapshots. 
+ *
+ * Inputs : Rate - Hz
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void GPS_IPC::SetRate(double Rate)
+{
+    SET_DEBUG_STACK;
+    SMSegment *Segments[] = {fGGARing, fRMCRing, fGGASnap, fGSASnap,
+			     fVTGSnap, fRMCSnap, fFixSnap};
+
+    for (size_t i = 0; i < sizeof(Segments)/sizeof(Segments[0]); i++)
+    {
+	if (Segments[i])
+	{
+	    Segments[i]->SetRate(Rate);
+	}
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  EnablePPS
+ *
+ * Description : Create and register GPS_PPS. Not done in the 
+ *     constructor so readers do not find a segment that never 
+ *     updates when there is no PPS device. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if created
+ *
+ * Error Conditions : logged by MakeSnapshot
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool GPS_IPC::EnablePPS(void)
+{
+    SET_DEBUG_STACK;
+    if (fPPSSnap == NULL)
+    {
+	fPPSSnap = MakeSnapshot("GPS_PPS", PPSTimeSchema());
+    }
+    return (fPPSSnap != NULL);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  PutPPS
+ *
+ * Description : Publish one paired PPS edge. 
+ *
+ * Inputs : Rec - from PPS::Pair
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void GPS_IPC::PutPPS(const PPSTime &Rec)
+{
+    SET_DEBUG_STACK;
+    if (fPPSSnap)
+    {
+	fPPSSnap->Put(&Rec);
+    }
+}
+
 /**
  ******************************************************************
  *
@@ -344,7 +590,16 @@ GPS_IPC::~GPS_IPC(void)
     delete pSM_SolutionData;
     delete pSM_VelocityData;
     delete pSM_Minimum;
-    delete pSM_Commands;
+    delete fCommands;
+    delete fGGARing;
+    delete fRMCRing;
+    delete fGGASnap;
+    delete fGSASnap;
+    delete fVTGSnap;
+    delete fRMCSnap;
+    delete fFixSnap;
+    delete fFix;
+    delete fPPSSnap;
     SET_DEBUG_STACK;
 }
 
@@ -16,6 +16,12 @@
  * 22-Feb-26  CBL  Took out the filename SM and changed the
  *                 command structure to allow for 512 bytes of string
  *                 data to be returned. Use this when querying filename
+ * 17-Oct-26  CBL  GGA_Ring and RMC_Ring, every fix. 
+ * 17-Oct-26  CBL  GGA/GSA/VTG/RMC_Snap, generation counted. 
+ * 17-Oct-26  CBL  GPS_Fix, all four messages of an epoch in one Put. 
+ * 17-Oct-26  CBL  GPS_CmdQ command queue replaces GPS_Commands. 
+ * 17-Oct-26  CBL  SetRate. 
+ * 17-Oct-26  CBL  GPS_PPS, EnablePPS and PutPPS. 
  *
  * Classification : Unclassified
  *
@@ -28,6 +34,11 @@
 #   include "NMEA_GPS.hh"
 #   include "CObject.hh"
 #   include "SharedMem2.hh"
+#   include "SMRing.hh"
+#   include "SMSnapshot.hh"
+#   include "GPSFix.hh"
+#   include "PPSTime.hh"
+#   include "SMCommandQueue.hh"
 
 class GPS_IPC : public CObject 
 {
@@ -38,8 +49,17 @@ public:
     ~GPS_IPC(void);
     /*! Send the data */
     void Update(void);
-    /*! provide shared memory for inbound commands. */
+    /*! 
+     * Take and answer every command queued in GPS_CmdQ. Cheap when
+     * there are none, call on every pass of the main loop. 
+     */
     void ProcessCommands(void);
+    /*! Fixes a second, as negotiated, for the registry. */
+    void SetRate(double Rate);
+    /*! Create GPS_PPS, only when there is a PPS device. */
+    bool EnablePPS(void);
+    /*! One paired PPS edge. */
+    void PutPPS(const PPSTime &Rec);
 
 private:
     /**
@@ -59,6 +79,47 @@ private:
      */
     SharedMem2   *pSM_VelocityData;
 
-    SharedMem2   *pSM_Commands;        // A way to communicate with remote
+    /**
+     * Commands from any process, CF, GF, CM. Each gets its own
+     * reply by request ID, kept for the next kCommandReplies. 
+     */
+    SMCommandQueue *fCommands;
+    static const uint32_t kCommandDepth   = 16;
+    static const uint32_t kCommandReplies = 64;
+
+    /**
+     * Every GGA and RMC, one record per fix, kRingSize deep. 
+     */
+    SMRing       *fGGARing;
+    SMRing       *fRMCRing;
+    static const uint32_t kRingSize = 256;
+
+    /*! Create and register one of the rings above, NULL on failure. */
+    SMRing* MakeRing(const char *Name, const SMSchema &Schema);
+
+    /**
+     * Latest of each message with a generation counter. Readers
+     * keep their own last seen generation, nobody clears a LAM. 
+     */
+    SMSnapshot   *fGGASnap;
+    SMSnapshot   *fGSASnap;
+    SMSnapshot   *fVTGSnap;
+    SMSnapshot   *fRMCSnap;
+
+    /*! Create and register one of the snapshots, NULL on failure. */
+    SMSnapshot* MakeSnapshot(const char *Name, const SMSchema &Schema);
+
+    /**
+     * GGA, GSA, VTG and RMC of one Update packed together and put
+     * once, readers cannot mix epochs. fEpoch counts the Updates. 
+     */
+    SMSnapshot   *fFixSnap;
+    GPSFix       *fFix;
+    uint64_t     fEpoch;
+
+    /**
+     * GPS second boundaries in system time, one a second. 
+     */
+    SMSnapshot   *fPPSSnap;
 };
 #endif
@@ -9,6 +9,9 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  QueueRead/Decode for combined I2C transactions.
+ * 17-Oct-26  CBL  Use I2CBus, no direct i2c-dev ioctl in constructor.
+ * 17-Oct-26  CBL  DecodeRaw.
  *
  * Classification : Unclassified
  *
@@ -27,7 +30,7 @@ using namespace std;
 
 // Local Includes.
 #include "AK09916.hh"
-#include "I2CHelper.hh"
+#include "I2CBus.hh"
 #include "debug.h"
 #include "CLogger.hh"
 
@@ -112,7 +115,7 @@ AK09916::AK09916 (uint8_t Address, READOUT_MODE Mode)
 {
     SET_DEBUG_STACK;
     CLogger   *pLog = CLogger::GetThis();
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
 
     fError      = false;
     fMmode      = Mode;     // Measurement mode, see header for details. 
@@ -124,8 +127,9 @@ AK09916::AK09916 (uint8_t Address, READOUT_MODE Mode)
 	fError = false;
     }
     // Initalize the mag sensor at the specified address.
-    // the ioctl points us at the correct address. 
-    if (ioctl(pI2C->FD(), I2C_SLAVE, fMagAddress) < 0)
+    // Make sure something answers there, this works for any backend. 
+    pI2C->ReadReg8(fMagAddress, WHO_AM_I_AK09916);
+    if (pI2C->Error())
     {
  	pLog->LogTime(" Error opening AK09916, address 0x%2X\n", fMagAddress);
 	fError = true;
@@ -209,7 +213,7 @@ bool AK09916::Read(int16_t *results)
 {
     SET_DEBUG_STACK;
     CLogger   *pLog = CLogger::GetThis();
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     uint8_t   rv;
     uint16_t  itemp;
     uint8_t   *ptr;
@@ -374,6 +378,149 @@ bool AK09916::ARead(double AvgTime, double *results)
     }
     return true;
 }
+/**
+ ******************************************************************
+ *
+ * Function Name : QueueRead
+ *
+ * Description : Queue ST1 through ST2 on the current combined
+ *     I2C transaction. This is one contiguous read, the data 
+ *     registers are only valid if DRDY in ST1 is set but reading
+ *     them regardless is harmless and ST2 ends the read cycle. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if queued
+ *
+ * Error Conditions : transaction full
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool AK09916::QueueRead(void)
+{
+    SET_DEBUG_STACK;
+    I2CBus    *pI2C = I2CBus::GetThis();
+    return pI2C->QueueRead(fMagAddress, AK09916_ST1, kBlockSize, fBlock);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Decode
+ *
+ * Description : Unpack the block filled by QueueRead/Submit. 
+ *
+ * Inputs : results - user supplied vector of 3 (uT)
+ *
+ * Returns : true if DRDY was set, the data is new. 
+ *
+ * Error Conditions : Sensor overflow flagged in ST2 sets fError
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool AK09916::Decode(double *results)
+{
+    SET_DEBUG_STACK;
+    return Decode(fBlock, results);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Decode
+ *
+ * Description : Unpack an ST1..ST2 block. 
+ *     Block[0] ST1, [1..6] HXL..HZH little endian, [7] TMPS,
+ *     [8] ST2. 
+ *
+ * Inputs : 
+ *     Block   - kBlockSize bytes starting at ST1
+ *     results - user supplied vector of 3 (uT)
+ *
+ * Returns : true if DRDY was set, the data is new. 
+ *
+ * Error Conditions : Sensor overflow flagged in ST2 sets fError
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool AK09916::Decode(const uint8_t *Block, double *results)
+{
+    SET_DEBUG_STACK;
+    int16_t   ivalue[3];
+
+    DecodeRaw(Block, ivalue);
+    Convert(ivalue, results);
+    SET_DEBUG_STACK;
+    return fMagRead;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : DecodeRaw
+ *
+ * Description : Unpack an ST1..ST2 block to counts. 
+ *     Block[0] ST1, [1..6] HXL..HZH little endian, [7] TMPS,
+ *     [8] ST2. 
+ *
+ * Inputs : 
+ *     Block   - kBlockSize bytes starting at ST1, NULL for fBlock
+ *     counts  - user supplied vector of 3
+ *
+ * Returns : true if DRDY was set, the data is new. 
+ *
+ * Error Conditions : Sensor overflow flagged in ST2 sets fError
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool AK09916::DecodeRaw(const uint8_t *Block, int16_t *counts)
+{
+    SET_DEBUG_STACK;
+    CLogger   *pLog = CLogger::GetThis();
+    size_t    i;
+
+    if (Block == NULL)
+    {
+	Block = fBlock;
+    }
+
+    /*
+     * The data registers hold the last measurement until the next
+     * one completes, so they are good even when DRDY is clear. This
+     * matters in I2C master mode where the ICM samples faster than
+     * the magnetometer. DRDY just says the data is fresh. 
+     */
+    fError   = false;
+    fMagRead = ((Block[0] & 0x01) != 0);
+    for (i=0;i<3;i++)
+    {
+	counts[i] = (int16_t)(((uint16_t)Block[2*i+2] << 8) | Block[2*i+1]);
+    }
+    if (Block[8] & 0x08)
+    {
+	pLog->LogTime("OVERFLOW IN MAGNETOMETER.\n");
+	fError = true;
+    }
+    SET_DEBUG_STACK;
+    return fMagRead;
+}
 /**
  ******************************************************************
  *
@@ -582,7 +729,7 @@ void AK09916::Convert(int16_t *intArray, double *result)
 uint8_t AK09916::DeviceID(void)
 {
     SET_DEBUG_STACK;
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     uint8_t   rv    = 0;
     rv = pI2C->ReadReg8(fMagAddress, WHO_AM_I_AK09916);
 
@@ -611,7 +758,7 @@ uint8_t AK09916::DeviceID(void)
 void AK09916::SoftReset(void)
 {
     SET_DEBUG_STACK;
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     pI2C->WriteReg8(fMagAddress, AK09916_CNTL3, 0x01);
 }
 /**
@@ -685,7 +832,7 @@ bool AK09916::SelfTest(int16_t *results)
     SET_DEBUG_STACK;
     struct timespec sleeptime    = {0L, 50000000};
     CLogger   *pLog = CLogger::GetThis();
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     bool      rv    = false;
     uint8_t   rc    = 0; 
     uint8_t   count = 0;
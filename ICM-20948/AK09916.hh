@@ -10,6 +10,9 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  QueueRead/Decode for combined I2C transactions.
+ * 17-Oct-26  CBL  Decode of a block read by the ICM-20948 I2C master.
+ * 17-Oct-26  CBL  DecodeRaw, counts for the IMURaw format.
  *
  * Classification : Unclassified
  *
@@ -210,6 +213,77 @@ public:
      */
     bool ARead(double AvgTime, double *results);
 
+    /*!
+     * Description: 
+     *   Queue a read of ST1 through ST2 (9 bytes) on the current 
+     *   I2CBus transaction. Reading through ST2 closes the 
+     *   read cycle so the chip will latch the next sample. 
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   true if queued. 
+     *
+     * Errors:
+     *   transaction full
+     */
+    bool QueueRead(void);
+
+    /*!
+     * Description: 
+     *   Decode the block filled by QueueRead/Submit. 
+     *
+     * Arguments:
+     *   results - user supplied vector of 3, field in uT. 
+     *             The last measurement, new or not. 
+     *
+     * Returns:
+     *   true if ST1 DRDY was set, the data is new. 
+     *
+     * Errors:
+     *   magnetic sensor overflow sets fError
+     */
+    bool Decode(double *results);
+
+    /*!
+     * Description: 
+     *   Same as above for an ST1..ST2 block read some other way, 
+     *   e.g. by the ICM-20948 I2C master into EXT_SLV_SENS_DATA. 
+     *
+     * Arguments:
+     *   Block   - kBlockSize bytes starting at ST1
+     *   results - user supplied vector of 3, field in uT. 
+     *
+     * Returns:
+     *   true if ST1 DRDY was set, the data is new. 
+     *
+     * Errors:
+     *   magnetic sensor overflow sets fError
+     */
+    bool Decode(const uint8_t *Block, double *results);
+
+    /*!
+     * Description: 
+     *   As the two Decode calls above, but the field is returned as
+     *   HX, HY, HZ counts. Multiply by getMres for uT. 
+     *
+     * Arguments:
+     *   Block   - kBlockSize bytes starting at ST1, or NULL for the 
+     *             block filled by QueueRead/Submit
+     *   counts  - user supplied vector of 3
+     *
+     * Returns:
+     *   true if ST1 DRDY was set, the data is new. 
+     *
+     * Errors:
+     *   magnetic sensor overflow sets fError
+     */
+    bool DecodeRaw(const uint8_t *Block, int16_t *counts);
+
+    /*! ST1, HXL..HZH, TMPS, ST2 */
+    static const size_t kBlockSize = 9;
+
     /*
      * convert integer result to double applying scaling factor
      * as well. 
@@ -277,5 +351,7 @@ private:
     bool       fError;
     bool       fMagRead;   // Read of magnetic data success. 
     double     fMag[3];    // resulting magnetic field, converted
+    /*! ST1, HXL..HZH, TMPS, ST2 for the batched read. */
+    uint8_t    fBlock[kBlockSize];
 };
 #endif
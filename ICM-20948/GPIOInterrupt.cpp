@@ -0,0 +1,241 @@
+/********************************************************************
+ *
+ * Module Name : GPIOInterrupt.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Rising edge wait on a GPIO character device line.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     Documentation/userspace-api/gpio/chardev.rst
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "GPIOInterrupt.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : GPIOInterrupt constructor
+ *
+ * Description : Open the chip and request the line as an input
+ *     with rising edge detection. Ask for REALTIME event stamps
+ *     first, older kernels reject the flag so retry without it.
+ *     The chip fd is not needed once the line is held.
+ *
+ * Inputs :
+ *     Chip - character device, /dev/gpiochipN
+ *     Line - offset of the line on that chip
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : open or line request fails, Error() is true.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+GPIOInterrupt::GPIOInterrupt(const char *Chip, uint32_t Line)
+{
+    SET_DEBUG_STACK;
+    CLogger *log = CLogger::GetThis();
+    struct gpio_v2_line_request req;
+    int    fdChip;
+    int    rc;
+
+    fFD        = -1;
+    fError     = true;
+    fRealtime  = true;
+    fLine      = Line;
+    fLastSeqno = 0;
+    fEvents    = 0;
+    fMissed    = 0;
+    fTimeouts  = 0;
+
+    fdChip = open( Chip, O_RDONLY | O_CLOEXEC);
+    if (fdChip < 0)
+    {
+	log->LogError(__FILE__,__LINE__,'W', "Could not open GPIO chip.\n");
+	log->Log("# GPIO %s: %s\n", Chip, strerror(errno));
+	return;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.offsets[0]        = Line;
+    req.num_lines         = 1;
+    req.event_buffer_size = kEventBuffer;
+    strncpy(req.consumer, "IMU DRDY", sizeof(req.consumer)-1);
+    req.config.flags      = GPIO_V2_LINE_FLAG_INPUT |
+	GPIO_V2_LINE_FLAG_EDGE_RISING |
+	GPIO_V2_LINE_FLAG_EVENT_CLOCK_REALTIME;
+
+    rc = ioctl( fdChip, GPIO_V2_GET_LINE_IOCTL, &req);
+    if ((rc < 0) && (errno == EINVAL))
+    {
+	// Before 5.11, monotonic stamps only.
+	fRealtime = false;
+	req.config.flags &= ~GPIO_V2_LINE_FLAG_EVENT_CLOCK_REALTIME;
+	rc = ioctl( fdChip, GPIO_V2_GET_LINE_IOCTL, &req);
+    }
+    if (rc < 0)
+    {
+	log->LogError(__FILE__,__LINE__,'W', "GPIO line request failed.\n");
+	log->Log("# GPIO %s line %u: %s\n", Chip, Line, strerror(errno));
+	close(fdChip);
+	return;
+    }
+    close(fdChip);
+
+    fFD    = req.fd;
+    fError = false;
+    log->Log("# GPIO %s line %u rising edge, %s time stamps.\n",
+	     Chip, Line, fRealtime ? "REALTIME" : "MONOTONIC");
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : GPIOInterrupt destructor
+ *
+ * Description : Release the line.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+GPIOInterrupt::~GPIOInterrupt(void)
+{
+    SET_DEBUG_STACK;
+    if (fFD >= 0)
+    {
+	close(fFD);
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Wait
+ *
+ * Description : poll the line fd for an edge and drain the event
+ *     queue. Gaps in line_seqno are edges the kernel had to drop
+ *     because we fell behind, they are counted in Missed.
+ *
+ * Inputs :
+ *     TimeoutMs - poll timeout in ms, -1 forever
+ *     When      - returned REALTIME of the most recent edge
+ *
+ * Returns : number of edges, 0 on timeout, -1 on error
+ *
+ * Error Conditions : poll or read failure
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int GPIOInterrupt::Wait(int TimeoutMs, struct timespec *When)
+{
+    SET_DEBUG_STACK;
+    struct pollfd  pfd;
+    struct gpio_v2_line_event ev[kEventBuffer];
+    struct timespec rt, mt;
+    ssize_t  nb;
+    size_t   i, n;
+    uint64_t ns;
+    int64_t  offset;
+    int      rc;
+
+    if (fFD < 0)
+    {
+	return -1;
+    }
+
+    pfd.fd      = fFD;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    do
+    {
+	rc = poll( &pfd, 1, TimeoutMs);
+    } while ((rc < 0) && (errno == EINTR));
+
+    if (rc == 0)
+    {
+	fTimeouts++;
+	return 0;
+    }
+    if ((rc < 0) || (pfd.revents & (POLLERR|POLLHUP|POLLNVAL)))
+    {
+	return -1;
+    }
+
+    nb = read( fFD, ev, sizeof(ev));
+    if (nb < (ssize_t) sizeof(ev[0]))
+    {
+	return (nb < 0 && errno == EAGAIN) ? 0 : -1;
+    }
+    n = nb / sizeof(ev[0]);
+
+    for (i=0;i<n;i++)
+    {
+	if ((fEvents > 0) && (ev[i].line_seqno > fLastSeqno+1))
+	{
+	    fMissed += ev[i].line_seqno - fLastSeqno - 1;
+	}
+	fLastSeqno = ev[i].line_seqno;
+	fEvents++;
+    }
+
+    if (When)
+    {
+	ns = ev[n-1].timestamp_ns;
+	if (!fRealtime)
+	{
+	    // Shift the monotonic stamp onto the wall clock.
+	    clock_gettime(CLOCK_REALTIME,  &rt);
+	    clock_gettime(CLOCK_MONOTONIC, &mt);
+	    offset = (int64_t)(rt.tv_sec - mt.tv_sec)*1000000000LL +
+		(int64_t)(rt.tv_nsec - mt.tv_nsec);
+	    ns = (uint64_t)((int64_t) ns + offset);
+	}
+	When->tv_sec  = ns / 1000000000ULL;
+	When->tv_nsec = ns % 1000000000ULL;
+    }
+    SET_DEBUG_STACK;
+    return (int) n;
+}
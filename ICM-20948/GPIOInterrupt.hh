@@ -0,0 +1,102 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : GPIOInterrupt.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Wait for a rising edge on one GPIO line through the
+ *     Linux GPIO character device (uAPI v2). The line is requested
+ *     as an edge detecting input, the kernel queues a timestamped
+ *     event per edge on the line fd and Wait polls on it. Used to
+ *     read the ICM-20948 as soon as its INT pin signals data ready
+ *     instead of sleeping a fixed period.
+ *
+ * Restrictions/Limitations :
+ *     Linux 5.10 or later for the v2 uAPI. Edge times are taken on
+ *     CLOCK_REALTIME where the kernel supports it (5.11), otherwise
+ *     on CLOCK_MONOTONIC and shifted to REALTIME when read.
+ *
+ *     Testing without hardware, gpio-sim:
+ *        modprobe gpio-sim
+ *        cd /sys/kernel/config/gpio-sim
+ *        mkdir imu imu/bank0
+ *        echo 8 > imu/bank0/num_lines
+ *        echo 1 > imu/live
+ *        cat imu/bank0/chip_name             # e.g. gpiochip2
+ *     then set GPIOChip = "/dev/gpiochip2" and GPIOLine = 0 and
+ *     generate edges by changing the simulated pull
+ *        D=/sys/devices/platform/gpio-sim.0/gpiochip2/sim_gpio0
+ *        while true; do echo pull-up > $D/pull; \
+ *                       echo pull-down > $D/pull; sleep 0.01; done
+ *     or gpio-mockup:
+ *        modprobe gpio-mockup gpio_mockup_ranges=-1,8
+ *        echo 1 > /sys/kernel/debug/gpio-mockup/gpiochipN/0
+ *        echo 0 > /sys/kernel/debug/gpio-mockup/gpiochipN/0
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     Documentation/userspace-api/gpio/chardev.rst
+ *     /usr/include/linux/gpio.h
+ *
+ *******************************************************************
+ */
+#ifndef __GPIOINTERRUPT_hh_
+#define __GPIOINTERRUPT_hh_
+#    include <stdint.h>
+#    include <time.h>
+
+/// GPIOInterrupt - edge events from one GPIO character device line.
+class GPIOInterrupt {
+public:
+    /// Default Constructor, request Line on Chip (/dev/gpiochipN)
+    GPIOInterrupt(const char *Chip, uint32_t Line);
+    /// Default destructor, release the line.
+    ~GPIOInterrupt(void);
+
+    /*! returns true if the line could not be requested. */
+    inline bool Error(void) const {return fError;};
+
+    /*!
+     * Description:
+     *   Wait for one or more rising edges. All events queued by
+     *   the kernel are consumed, the time of the most recent is
+     *   returned.
+     *
+     * Arguments:
+     *   TimeoutMs - maximum time to wait in ms, -1 forever
+     *   When      - CLOCK_REALTIME of the latest edge, may be NULL
+     *
+     * Returns:
+     *   number of edges seen, 0 on timeout, -1 on error.
+     *
+     * Errors:
+     *   poll or read failure.
+     */
+    int  Wait(int TimeoutMs, struct timespec *When);
+
+    /*! line request file descriptor, for use in a poll set. */
+    inline int      FD(void)       const {return fFD;};
+    /*! Number of edges seen. */
+    inline uint64_t Events(void)   const {return fEvents;};
+    /*! Edges dropped by the kernel, event buffer overflow. */
+    inline uint64_t Missed(void)   const {return fMissed;};
+    /*! Number of Wait calls that timed out. */
+    inline uint64_t Timeouts(void) const {return fTimeouts;};
+
+private:
+    static const uint32_t kEventBuffer = 16;
+
+    int       fFD;          // line request fd
+    bool      fError;
+    bool      fRealtime;    // events carry CLOCK_REALTIME stamps
+    uint32_t  fLine;
+    uint32_t  fLastSeqno;   // line_seqno of the last event
+    uint64_t  fEvents;
+    uint64_t  fMissed;
+    uint64_t  fTimeouts;
+};
+#endif
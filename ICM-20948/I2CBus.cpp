@@ -0,0 +1,348 @@
+/********************************************************************
+ *
+ * Module Name : I2CBus.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Abstract I2C transport, common transaction queue.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Submit, with the read last fallback. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cerrno>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "I2CBus.hh"
+
+I2CBus* I2CBus::fBus;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : I2CBus constructor
+ *
+ * Description : Clear the transaction queue and register this 
+ *     instance as the process bus. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+I2CBus::I2CBus (void)
+{
+    SET_DEBUG_STACK;
+    fBus          = this;
+    fError        = false;
+    fTransactions = 0;
+    fLastErrno    = 0;
+    fSplit        = false;
+    BeginTransaction();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : I2CBus destructor
+ *
+ * Description :
+ *
+ * Inputs :
+ *
+ * Returns :
+ *
+ * Error Conditions :
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+I2CBus::~I2CBus (void)
+{
+    SET_DEBUG_STACK;
+    if (fBus == this) fBus = NULL;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : BeginTransaction
+ *
+ * Description : Reset the combined transaction queue. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CBus::BeginTransaction(void)
+{
+    SET_DEBUG_STACK;
+    fNMsg     = 0;
+    fTxUsed   = 0;
+    fOverflow = false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : QueueRead
+ *
+ * Description : Add a register read to the transaction. This is
+ *     two messages, write the register address then read back 
+ *     size bytes with a repeated start. 
+ *
+ * Inputs : 
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to read from
+ *     size         - number of bytes to read
+ *     data         - user provided data array to store data. 
+ *
+ * Returns : true if queued
+ *
+ * Error Conditions : Message or buffer space exhausted
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CBus::QueueRead(uint8_t SlaveAddress, uint8_t Register, 
+			  size_t size, void *data)
+{
+    SET_DEBUG_STACK;
+    if ((fNMsg+2 > I2C_RDWR_IOCTL_MAX_MSGS) || (fTxUsed+1 > kTxBufferSize) ||
+	(size > UINT16_MAX))
+    {
+	fOverflow = true;
+	return false;
+    }
+    fTxBuffer[fTxUsed] = Register;
+
+    fMsgs[fNMsg].addr  = SlaveAddress;
+    fMsgs[fNMsg].flags = 0;
+    fMsgs[fNMsg].len   = 1;
+    fMsgs[fNMsg].buf   = &fTxBuffer[fTxUsed];
+    fNMsg++;
+    fTxUsed++;
+
+    fMsgs[fNMsg].addr  = SlaveAddress;
+    fMsgs[fNMsg].flags = I2C_M_RD;
+    fMsgs[fNMsg].len   = (uint16_t) size;
+    fMsgs[fNMsg].buf   = (uint8_t *) data;
+    fNMsg++;
+
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : QueueWrite
+ *
+ * Description : Add a register write to the transaction. 
+ *     The register address and data are copied into the 
+ *     transmit buffer and sent as one message. 
+ *
+ * Inputs : 
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - first register to write
+ *     size         - number of bytes to write
+ *     data         - data to write
+ *
+ * Returns : true if queued
+ *
+ * Error Conditions : Message or buffer space exhausted
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CBus::QueueWrite(uint8_t SlaveAddress, uint8_t Register, 
+			   size_t size, const void *data)
+{
+    SET_DEBUG_STACK;
+    if ((fNMsg+1 > I2C_RDWR_IOCTL_MAX_MSGS) || 
+	(fTxUsed+size+1 > kTxBufferSize))
+    {
+	fOverflow = true;
+	return false;
+    }
+    fTxBuffer[fTxUsed] = Register;
+    memcpy(&fTxBuffer[fTxUsed+1], data, size);
+
+    fMsgs[fNMsg].addr  = SlaveAddress;
+    fMsgs[fNMsg].flags = 0;
+    fMsgs[fNMsg].len   = (uint16_t) (size+1);
+    fMsgs[fNMsg].buf   = &fTxBuffer[fTxUsed];
+    fNMsg++;
+    fTxUsed += size+1;
+
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Submit
+ *
+ * Description : Send everything queued since BeginTransaction as
+ *     one combined transfer. On EOPNOTSUPP with a read before the
+ *     last message, the adapter's read last rule, switch to write/
+ *     read pairs for good. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : 
+ *     transfer failure, LastErrno, or a Queue call ran out of space.
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CBus::Submit(void)
+{
+    SET_DEBUG_STACK;
+    int rc = 0;
+
+    if (fOverflow)
+    {
+	rc = ENOBUFS;
+    }
+    else if (fNMsg > 0)
+    {
+	if (fSplit)
+	{
+	    rc = SubmitPairs();
+	}
+	else
+	{
+	    fTransactions++;
+	    rc = Combined(fMsgs, fNMsg);
+	    if ((rc == EOPNOTSUPP) && ReadBeforeLast())
+	    {
+		fSplit = true;
+		CLogger::GetThis()->Log(
+		    "# I2C adapter takes a read only last, batches split into write/read pairs.\n");
+		rc = SubmitPairs();
+	    }
+	}
+    }
+    fError = (rc != 0);
+    if (fError)
+	fLastErrno = rc;
+    BeginTransaction();
+
+    SET_DEBUG_STACK;
+    return !fError;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadBeforeLast
+ *
+ * Description : Is there a read anywhere but the last message.
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if so
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CBus::ReadBeforeLast(void) const
+{
+    for (size_t i = 0; i + 1 < fNMsg; i++)
+    {
+	if (fMsgs[i].flags & I2C_M_RD)
+	    return true;
+    }
+    return false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : SubmitPairs
+ *
+ * Description : One transfer for each run of messages ending in a
+ *     read, the write of the register address and its read for a
+ *     QueueRead, plus any writes queued before it. Writes after the
+ *     last read go together. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : 0 or the errno of the first failure, the rest are
+ *     not sent.
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int I2CBus::SubmitPairs(void)
+{
+    size_t start = 0, i;
+    int    rc    = 0;
+
+    for (i = 0; (i < fNMsg) && (rc == 0); i++)
+    {
+	if ((fMsgs[i].flags & I2C_M_RD) || (i + 1 == fNMsg))
+	{
+	    fTransactions++;
+	    rc = Combined(&fMsgs[start], i - start + 1);
+	    start = i + 1;
+	}
+    }
+    return rc;
+}
@@ -0,0 +1,194 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : I2CBus.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Abstract I2C transport. The sensor classes only
+ *     talk to the bus through this interface so that the real
+ *     i2c-dev backend (I2CHelper) and the register level simulator
+ *     (I2CSim) are interchangeable.
+ *
+ * Restrictions/Limitations :
+ *     One bus per process, the most recently constructed backend
+ *     is returned by GetThis.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Submit here, split into write/read pairs for
+ *                 adapters that only allow a read last. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __I2CBUS_hh_
+#define __I2CBUS_hh_
+#    include <stdint.h>
+#    include <stddef.h>
+// struct i2c_msg is used for the combined transaction queue.
+#    include <linux/i2c-dev.h>
+#    include <linux/i2c.h>
+
+/// I2CBus - common interface for the I2C backends.
+class I2CBus {
+public:
+    /// Default Constructor, registers this as the process bus.
+    I2CBus(void);
+    /// Default destructor
+    virtual ~I2CBus(void);
+
+    /*! returns true if error on last function call. */
+    inline bool Error(void) const {return fError;};
+
+    /*! Number of bus transactions (system calls for i2c-dev) made. */
+    inline uint64_t Transactions(void) const {return fTransactions;};
+
+    virtual uint8_t ReadReg8(uint8_t SlaveAddress, uint8_t Register) = 0;
+    virtual int     ReadBlock(uint8_t SlaveAddress, unsigned char Register,
+			      size_t  size,  void* data) = 0;
+    virtual bool    WriteReg8(uint8_t SlaveAddress, unsigned char Register,
+			      unsigned char value) = 0;
+    virtual int     ReadWord(uint8_t SlaveAddress, unsigned char Register) = 0;
+    virtual bool    WriteWord(uint8_t SlaveAddress, uint8_t Register,
+			      uint16_t value) = 0;
+
+    /*!
+     * Description:
+     *   Start a new combined transaction. Any previously queued
+     *   messages that were not submitted are discarded.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE
+     */
+    void    BeginTransaction(void);
+
+    /*!
+     * Description:
+     *   Queue a register read, a one byte write of the register
+     *   address followed by a repeated start read of size bytes.
+     *   There is no SMBus 32 byte limit on size.
+     *
+     * Arguments:
+     *   SlaveAddress - address of the subsystem on the bus.
+     *   Register     - first register to read
+     *   size         - number of bytes to read
+     *   data         - user buffer, must stay valid until Submit.
+     *
+     * Returns:
+     *   true if queued.
+     *
+     * Errors:
+     *   too many messages in the batch.
+     */
+    bool    QueueRead(uint8_t SlaveAddress, uint8_t Register,
+		      size_t size, void *data);
+
+    /*!
+     * Description:
+     *   Queue a register write, register address followed by data
+     *   in one message. The data is copied so the caller's buffer
+     *   may be reused immediately.
+     *
+     * Arguments:
+     *   SlaveAddress - address of the subsystem on the bus.
+     *   Register     - first register to write
+     *   size         - number of bytes to write
+     *   data         - data to write
+     *
+     * Returns:
+     *   true if queued.
+     *
+     * Errors:
+     *   too many messages or too much data in the batch.
+     */
+    bool    QueueWrite(uint8_t SlaveAddress, uint8_t Register,
+		       size_t size, const void *data);
+
+    /*!
+     * Description:
+     *   Execute all queued messages as one combined transaction.
+     *   The queue is empty on return.
+     *
+     *   Some adapters, i2c-bcm2835 on the Pi 0-4, take a read only
+     *   as the last message and refuse the rest with EOPNOTSUPP,
+     *   before anything goes on the bus. The batch is then sent as
+     *   one transfer per write/read pair, and so is every later
+     *   one, logged once.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   transfer failure, or an earlier Queue call overflowed.
+     *   LastErrno says why.
+     */
+    bool    Submit(void);
+
+    /*! errno of the last failed transfer, 0 if none. */
+    inline int  LastErrno(void) const {return fLastErrno;};
+
+    /*! true once Submit has had to split batches. */
+    inline bool Split(void) const {return fSplit;};
+
+    /*! Number of messages currently queued. */
+    inline size_t Queued(void) const {return fNMsg;};
+
+    /*! Access the This pointer. */
+    static I2CBus* GetThis(void) {return fBus;};
+
+protected:
+    bool     fError;        // returns true if error on last function call.
+    uint64_t fTransactions; // count of bus transactions.
+
+    /*!
+     * Combined transaction state, the kernel accepts at most
+     * I2C_RDWR_IOCTL_MAX_MSGS per ioctl. Write payloads (register
+     * address + data) are copied into fTxBuffer.
+     */
+    static const size_t kTxBufferSize = 256;
+    struct i2c_msg fMsgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint8_t        fTxBuffer[kTxBufferSize];
+    size_t         fNMsg;
+    size_t         fTxUsed;
+    bool           fOverflow;
+
+    /*!
+     * Description:
+     *   Backend, run n messages as one combined transfer.
+     *
+     * Arguments:
+     *   Msgs - messages
+     *   n    - how many, > 0
+     *
+     * Returns:
+     *   0 on success, else an errno value.
+     *
+     * Errors:
+     *   EOPNOTSUPP if the adapter refuses a read before the last
+     *   message, nothing was transferred.
+     */
+    virtual int Combined(struct i2c_msg *Msgs, size_t n) = 0;
+
+private:
+    int            fLastErrno;
+    bool           fSplit;     // sending write/read pairs
+
+    bool    ReadBeforeLast(void) const;
+    int     SubmitPairs(void);
+
+    /*! The static 'this' pointer. */
+    static I2CBus *fBus;
+};
+#endif
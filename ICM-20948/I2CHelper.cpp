@@ -9,6 +9,9 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  Added I2C_RDWR transaction batch, Begin/Queue/Submit.
+ * 17-Oct-26  CBL  Now the i2c-dev backend of I2CBus.
+ * 17-Oct-26  CBL  Combined, the I2C_RDWR half of Submit. 
  *
  * Classification : Unclassified
  *
@@ -23,6 +26,7 @@ using namespace std;
 #include <cmath>
 #include <unistd.h>
 #include <cstring>
+#include <cerrno>
 
 
 // Local Includes.
@@ -30,8 +34,6 @@ using namespace std;
 #include "CLogger.hh"
 #include "I2CHelper.hh"
 
-I2CHelper* I2CHelper::fI2C;
-
 /**
  ******************************************************************
  *
@@ -52,11 +54,9 @@ I2CHelper* I2CHelper::fI2C;
  *
  *******************************************************************
  */
-I2CHelper::I2CHelper (const char *DeviceName)
+I2CHelper::I2CHelper (const char *DeviceName) : I2CBus()
 {
     SET_DEBUG_STACK;
-    fError = false;
-    fI2C   = this;
     fdI2C  = open( DeviceName, O_RDWR);
     fError = (fdI2C<0);
 }
@@ -166,6 +166,7 @@ uint8_t I2CHelper::ReadReg8(uint8_t SlaveAddress, uint8_t Register)
 	    return -1;
 	}
 
+	fTransactions++;
 	if(ioctl(fdI2C, I2C_SMBUS, &blk) < 0)
 	{
 	    fError = true;
@@ -226,6 +227,7 @@ int I2CHelper::ReadBlock(uint8_t SlaveAddress, unsigned char Register,
     blk.data         = &i2cdata;
     i2cdata.block[0] = size;
 
+    fTransactions++;
     if(ioctl(fdI2C, I2C_SMBUS, &blk) < 0)
     {
 	fError = true;
@@ -286,6 +288,7 @@ bool I2CHelper::WriteReg8(uint8_t SlaveAddress,
     blk.size       = I2C_SMBUS_BYTE_DATA;
     blk.data       = &i2cdata;
 
+    fTransactions++;
     if(ioctl(fdI2C, I2C_SMBUS, &blk)<0)
     {
 	log->LogTime(" Unable to write I2C byte data\n");
@@ -343,6 +346,7 @@ int I2CHelper::ReadWord(uint8_t SlaveAddress, unsigned char Register)
     blk.size       = I2C_SMBUS_WORD_DATA;
     blk.data       = &i2cdata;
 
+    fTransactions++;
     if(ioctl( fdI2C, I2C_SMBUS, &blk)<0)
     {
 	fError = true;
@@ -415,6 +419,7 @@ bool I2CHelper::WriteWord(uint8_t SlaveAddress, uint8_t Register,
     blk.size       = I2C_SMBUS_WORD_DATA;
     blk.data       = &i2cdata;
 
+    fTransactions++;
     if(ioctl( fdI2C, I2C_SMBUS, &blk)<0)
     {
 	fError = true;
@@ -423,3 +428,41 @@ bool I2CHelper::WriteWord(uint8_t SlaveAddress, uint8_t Register,
     }
     return true;
 }
+/**
+ ******************************************************************
+ *
+ * Function Name : Combined
+ *
+ * Description : Hand n messages to the kernel in a single I2C_RDWR
+ *     ioctl. Messages to different slave addresses may be mixed, no
+ *     I2C_SLAVE select is needed.
+ *
+ * Inputs : 
+ *     Msgs - messages
+ *     n    - how many
+ *
+ * Returns : 0 on success, else errno
+ *
+ * Error Conditions : 
+ *     EOPNOTSUPP from i2c-bcm2835 for a read before the last message.
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int I2CHelper::Combined(struct i2c_msg *Msgs, size_t n)
+{
+    SET_DEBUG_STACK;
+    struct i2c_rdwr_ioctl_data xfer;
+
+    if (fdI2C < 0)
+	return EBADF;
+    xfer.msgs  = Msgs;
+    xfer.nmsgs = n;
+    if (ioctl(fdI2C, I2C_RDWR, &xfer) < 0)
+	return errno;
+    return 0;
+}
@@ -10,6 +10,9 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  Added I2C_RDWR transaction batch, Begin/Queue/Submit.
+ * 17-Oct-26  CBL  Now the i2c-dev backend of I2CBus.
+ * 17-Oct-26  CBL  Combined replaces Submit, I2CBus splits batches.
  *
  * Classification : Unclassified
  *
@@ -27,12 +30,10 @@
 #    include <stdint.h>
 #    include <fcntl.h>
 #    include <sys/ioctl.h>
-// specific to talking to I2C
-#    include <linux/i2c-dev.h>
-#    include <linux/i2c.h>
+#    include "I2CBus.hh"
 
-/// I2CHelper documentation here. 
-class I2CHelper {
+/// I2CHelper - i2c-dev backend for I2CBus.
+class I2CHelper : public I2CBus {
 public:
     /// Default Constructor
     I2CHelper(const char *I2CDeviceName);
@@ -40,7 +41,6 @@ public:
     ~I2CHelper();
     /// I2CHelper function
 
-    inline bool Error(void) {return fError;};
     inline int  FD(void)    {return fdI2C;};
 
     uint8_t ReadReg8(uint8_t SlaveAddress, uint8_t Register);
@@ -54,28 +54,12 @@ public:
 
     bool    WriteWord(uint8_t SlaveAddress, uint8_t Register, 
 			  uint16_t value);
-    /*! Access the This pointer. */
-    static I2CHelper* GetThis(void) {return fI2C;};
 
-    /*!
-     * Description: 
-     *   
-     *
-     * Arguments:
-     *   
-     *
-     * Returns:
-     *
-     * Errors:
-     *
-     */
+protected:
+    /*! n messages to the kernel in one I2C_RDWR ioctl, 0 or errno. */
+    int     Combined(struct i2c_msg *Msgs, size_t n);
 
 private:
     int    fdI2C;   // Pointer to I2C device. 
-    bool   fError;  // returns true if error on last function call. 
-
-    /*! The static 'this' pointer. */
-    static I2CHelper *fI2C;
-
 };
 #endif
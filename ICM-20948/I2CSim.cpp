@@ -0,0 +1,1338 @@
+/********************************************************************
+ *
+ * Module Name : I2CSim.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Register level simulation of the ICM-20948 and
+ *     AK09916 behind the I2CBus interface.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  I2C master SLV0 model.
+ * 17-Oct-26  CBL  Combined, SetReadLast for the i2c-bcm2835 rule.
+ * 17-Oct-26  CBL  Advance block zeroed, warning clean at -O2 -Wextra.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "I2CSim.hh"
+#include "ICM-20948.hh"
+#include "AK09916.hh"
+
+/*
+ * Bits used by the model.
+ */
+static const uint8_t kSLEEP        = 0x40;  // PWR_MGMT_1
+static const uint8_t kDEVICE_RESET = 0x80;  // PWR_MGMT_1
+static const uint8_t kBYPASS_EN    = 0x02;  // INT_PIN_CFG
+static const uint8_t kANYRD_2CLEAR = 0x10;  // INT_PIN_CFG
+static const uint8_t kI2C_MST_EN   = 0x20;  // USER_CTRL
+static const uint8_t kFIFO_EN      = 0x40;  // USER_CTRL
+static const uint8_t kRAW_DATA_RDY = 0x01;  // INT_STATUS_1
+static const uint8_t kFIFO_OVF     = 0x01;  // INT_STATUS_2, FIFO 0
+static const uint8_t kSNAPSHOT     = 0x01;  // FIFO_MODE
+static const uint8_t kSLV_0_FIFO   = 0x01;  // FIFO_EN_1
+static const uint8_t kSLV_EN       = 0x80;  // I2C_SLVx_CTRL
+static const uint8_t kSLV_RNW      = 0x80;  // I2C_SLVx_ADDR
+static const uint8_t kSLV0_NACK    = 0x01;  // I2C_MST_STATUS
+
+static const uint8_t kMagDRDY      = 0x01;  // ST1
+static const uint8_t kMagDOR       = 0x02;  // ST1
+static const uint8_t kMagHOFL      = 0x08;  // ST2
+static const uint8_t kWIA1         = 0x00;
+static const uint8_t kTMPS         = 0x17;
+
+/* ICM sensor block, ACCEL_XOUT_H through TEMP_OUT_L */
+static const size_t  kBlock        = 14;
+/* EXT_SLV_SENS_DATA_00 .. 23 */
+static const size_t  kExtSens      = 24;
+/* Single measurement time of the AK09916, seconds. */
+static const double  kMagMeasTime  = 0.0085;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : I2CSim constructor
+ *
+ * Description : Power on both models.
+ *
+ * Inputs :
+ *    IMUAddress - bus address of the ICM-20948
+ *    MagAddress - bus address of the AK09916
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+I2CSim::I2CSim (uint8_t IMUAddress, uint8_t MagAddress) : I2CBus()
+{
+    SET_DEBUG_STACK;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    fStart      = (double) ts.tv_sec + 1.0e-9 * (double) ts.tv_nsec;
+    fNow        = 0.0;
+    fIMUAddress = IMUAddress;
+    fMagAddress = MagAddress;
+    fNSamples   = 0;
+    fSeed       = 12345;
+    fReadLast   = false;
+
+    IMUReset();
+    MagReset();
+    CLogger::GetThis()->Log("# I2C simulator, ICM-20948 0x%2X, AK09916 0x%2X\n",
+			    fIMUAddress, fMagAddress);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : I2CSim destructor
+ *
+ * Description :
+ *
+ * Inputs :
+ *
+ * Returns :
+ *
+ * Error Conditions :
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+I2CSim::~I2CSim (void)
+{
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadReg8
+ *
+ * Description : Single register read.
+ *
+ * Inputs :
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to read from
+ *
+ * Returns : register value, 0xFF on NACK
+ *
+ * Error Conditions : NACK sets fError
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint8_t I2CSim::ReadReg8(uint8_t SlaveAddress, uint8_t Register)
+{
+    SET_DEBUG_STACK;
+    uint8_t rv = 0xFF;
+    RegisterIO(SlaveAddress, Register, true, 1, &rv);
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadBlock
+ *
+ * Description : Same semantics as the SMBus I2C block read,
+ *     at most I2C_SMBUS_BLOCK_MAX bytes.
+ *
+ * Inputs :
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to read from
+ *     size         - number of bytes to read
+ *     data         - user provided data array to store data.
+ *
+ * Returns : number of bytes read, -1 on error
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int I2CSim::ReadBlock(uint8_t SlaveAddress, unsigned char Register,
+		      size_t  size,  void* data)
+{
+    SET_DEBUG_STACK;
+    if (size > I2C_SMBUS_BLOCK_MAX) size = I2C_SMBUS_BLOCK_MAX;
+    if (!RegisterIO(SlaveAddress, Register, true, size, (uint8_t *)data))
+    {
+	return -1;
+    }
+    return (int) size;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteReg8
+ *
+ * Description : Single register write
+ *
+ * Inputs :
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to write to
+ *     value        - to write
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::WriteReg8(uint8_t SlaveAddress, unsigned char Register,
+		       unsigned char value)
+{
+    SET_DEBUG_STACK;
+    return RegisterIO(SlaveAddress, Register, false, 1, &value);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadWord
+ *
+ * Description : SMBus word read, low byte first.
+ *
+ * Inputs :
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to read from
+ *
+ * Returns : word, -1 on error
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int I2CSim::ReadWord(uint8_t SlaveAddress, unsigned char Register)
+{
+    SET_DEBUG_STACK;
+    uint8_t data[2];
+    if (!RegisterIO(SlaveAddress, Register, true, 2, data))
+    {
+	return -1;
+    }
+    return (int) data[0] | ((int) data[1] << 8);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteWord
+ *
+ * Description : SMBus word write, low byte first.
+ *
+ * Inputs :
+ *     SlaveAddress - address of the subsystem on the bus.
+ *     Register     - to write to
+ *     value        - to write
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::WriteWord(uint8_t SlaveAddress, uint8_t Register,
+		       uint16_t value)
+{
+    SET_DEBUG_STACK;
+    uint8_t data[2];
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+    return RegisterIO(SlaveAddress, Register, false, 2, data);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Combined
+ *
+ * Description : Run n messages against the models. All of them see
+ *     the same instant in time, as would a short combined transfer
+ *     on the real bus. With fReadLast a read anywhere but last is
+ *     refused up front, like i2c-bcm2835.
+ *
+ * Inputs : 
+ *     Msgs - messages
+ *     n    - how many
+ *
+ * Returns : 0 on success, else errno
+ *
+ * Error Conditions : 
+ *     EOPNOTSUPP read before the last message with fReadLast,
+ *     ENXIO NACK on any message.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int I2CSim::Combined(struct i2c_msg *Msgs, size_t n)
+{
+    SET_DEBUG_STACK;
+    size_t i;
+
+    if (fReadLast)
+    {
+	for (i=0; i+1<n; i++)
+	{
+	    if (Msgs[i].flags & I2C_M_RD)
+		return EOPNOTSUPP;
+	}
+    }
+    Advance();
+    for (i=0; i<n; i++)
+    {
+	if (!Transfer(&Msgs[i]))
+	    return ENXIO;
+    }
+    SET_DEBUG_STACK;
+    return 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : RegisterIO
+ *
+ * Description : One register access transaction, used by the
+ *     SMBus style calls.
+ *
+ * Inputs :
+ *     Address  - slave address
+ *     Register - first register
+ *     Read     - true for read, false for write
+ *     n        - number of bytes
+ *     data     - data in/out
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::RegisterIO(uint8_t Address, uint8_t Register, bool Read,
+			size_t n, uint8_t *data)
+{
+    SET_DEBUG_STACK;
+    struct i2c_msg msg[2];
+    uint8_t        tx[I2C_SMBUS_BLOCK_MAX+1];
+
+    if (n > I2C_SMBUS_BLOCK_MAX) n = I2C_SMBUS_BLOCK_MAX;
+    tx[0] = Register;
+
+    msg[0].addr  = Address;
+    msg[0].flags = 0;
+    msg[0].buf   = tx;
+    if (Read)
+    {
+	msg[0].len   = 1;
+	msg[1].addr  = Address;
+	msg[1].flags = I2C_M_RD;
+	msg[1].len   = n;
+	msg[1].buf   = data;
+    }
+    else
+    {
+	memcpy(&tx[1], data, n);
+	msg[0].len   = n+1;
+    }
+
+    fTransactions++;
+    Advance();
+    fError = !Transfer(&msg[0]);
+    if (!fError && Read)
+    {
+	fError = !Transfer(&msg[1]);
+    }
+    SET_DEBUG_STACK;
+    return !fError;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Transfer
+ *
+ * Description : Route one i2c_msg to the device at its address.
+ *     A write sets the register pointer from the first byte and
+ *     writes any following bytes, a read returns bytes from the
+ *     register pointer. Both devices auto increment the pointer.
+ *
+ * Inputs : msg - message to execute
+ *
+ * Returns : true if the address was acknowledged.
+ *
+ * Error Conditions : no device, or AK09916 not visible on the bus.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::Transfer(struct i2c_msg *msg)
+{
+    SET_DEBUG_STACK;
+    uint16_t i;
+
+    if (msg->addr == fIMUAddress)
+    {
+	if (msg->flags & I2C_M_RD)
+	{
+	    for (i=0;i<msg->len;i++) msg->buf[i] = IMURead();
+	}
+	else if (msg->len>0)
+	{
+	    fIMUPointer = msg->buf[0] & 0x7F;
+	    for (i=1;i<msg->len;i++) IMUWrite(msg->buf[i]);
+	}
+	return true;
+    }
+    else if ((msg->addr == fMagAddress) && MagVisible())
+    {
+	if (msg->flags & I2C_M_RD)
+	{
+	    for (i=0;i<msg->len;i++) msg->buf[i] = MagRead();
+	}
+	else if (msg->len>0)
+	{
+	    fMagPointer = msg->buf[0] & 0x3F;
+	    for (i=1;i<msg->len;i++) MagWrite(msg->buf[i]);
+	}
+	return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Advance
+ *
+ * Description : Bring both models up to the current time.
+ *     Every ICM sample period that has elapsed is generated, and
+ *     pushed into the FIFO if enabled. The data registers hold the
+ *     latest sample.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::Advance(void)
+{
+    SET_DEBUG_STACK;
+    struct timespec ts;
+    uint8_t  block[kBlock] = {0};
+    uint8_t  ext[kExtSens];
+    uint8_t  packet[kBlock+kExtSens];
+    uint64_t n, k, first;
+    size_t   np, next = 0;
+    double   rate, t;
+    bool     fifo, master;
+    uint8_t  sel;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    fNow = (double) ts.tv_sec + 1.0e-9 * (double) ts.tv_nsec - fStart;
+
+    if (IMUSleep())
+    {
+	// No conversions while asleep, restart the sample clock.
+	fTBase  = fNow;
+	fSample = 0;
+    }
+    else
+    {
+	rate = ODR();
+	n    = (uint64_t) floor((fNow - fTBase) * rate);
+	if (n > fSample)
+	{
+	    fifo   = (fReg[0][USER_CTRL] & kFIFO_EN) != 0;
+	    master = ((fReg[0][USER_CTRL] & kI2C_MST_EN) != 0) &&
+		((fReg[3][I2C_SLV0_CTRL] & kSLV_EN) != 0);
+	    sel    = fReg[0][FIFO_EN_2];
+	    first  = fSample + 1;
+	    if (!fifo && !master)
+	    {
+		first = n;
+	    }
+	    else if (n - fSample > kFIFOSize)
+	    {
+		// More samples than FIFO bytes, the rest are lost anyway.
+		first = n - kFIFOSize;
+		if (fifo) fReg[0][INT_STATUS_2] |= kFIFO_OVF;
+	    }
+	    for (k=first; k<=n; k++)
+	    {
+		t = fTBase + (double) k / rate;
+		IMULatch(t, block);
+		if (master)
+		{
+		    // The master reads the slave at every sample.
+		    MagAdvance(t);
+		    next = MasterRead(ext);
+		}
+		if (fifo)
+		{
+		    /*
+		     * FIFO packet in register order,
+		     * accel, gyro X, Y, Z, temperature, SLV0.
+		     */
+		    np = 0;
+		    if (sel & 0x10) {memcpy(&packet[np], &block[0], 6); np+=6;}
+		    if (sel & 0x02) {memcpy(&packet[np], &block[6], 2); np+=2;}
+		    if (sel & 0x04) {memcpy(&packet[np], &block[8], 2); np+=2;}
+		    if (sel & 0x08) {memcpy(&packet[np], &block[10],2); np+=2;}
+		    if (sel & 0x01) {memcpy(&packet[np], &block[12],2); np+=2;}
+		    if (master && (fReg[0][FIFO_EN_1] & kSLV_0_FIFO))
+		    {
+			memcpy(&packet[np], ext, next); 
+			np += next;
+		    }
+		    FIFOPush(packet, np);
+		}
+	    }
+	    memcpy(&fReg[0][ACCEL_XOUT_H], block, kBlock);
+	    if (master)
+	    {
+		memcpy(&fReg[0][EXT_SENS_DATA_00], ext, next);
+	    }
+	    fReg[0][INT_STATUS_1] |= kRAW_DATA_RDY;
+	    fNSamples += n - fSample;
+	    fSample    = n;
+	}
+    }
+    MagAdvance(fNow);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMUReset
+ *
+ * Description : Power on/DEVICE_RESET register state.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::IMUReset(void)
+{
+    SET_DEBUG_STACK;
+    memset(fReg, 0, sizeof(fReg));
+    fReg[0][WHO_AM_I_ICM20948] = 0xEA;
+    fReg[0][LP_CONFIG]         = 0x40;
+    fReg[0][PWR_MGMT_1]        = 0x41;
+    fBankSel    = 0;
+    fIMUPointer = 0;
+    fTBase      = fNow;
+    fSample     = 0;
+    fFIFOHead   = 0;
+    fFIFOCount  = 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMUSleep
+ *
+ * Description : true if PWR_MGMT_1 SLEEP is set
+ *
+ * Inputs : NONE
+ *
+ * Returns : sleep state
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::IMUSleep(void) const
+{
+    return (fReg[0][PWR_MGMT_1] & kSLEEP) != 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ODR
+ *
+ * Description : Sample rate, 1.125 kHz/(1+GYRO_SMPLRT_DIV)
+ *
+ * Inputs : NONE
+ *
+ * Returns : rate in Hz
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double I2CSim::ODR(void) const
+{
+    return 1125.0/(1.0 + (double) fReg[2][GYRO_SMPLRT_DIV]);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMURead
+ *
+ * Description : Read the register at the pointer in the selected
+ *     bank and apply any read side effects. The pointer does
+ *     not advance on FIFO_R_W.
+ *
+ * Inputs : NONE
+ *
+ * Returns : register value
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint8_t I2CSim::IMURead(void)
+{
+    SET_DEBUG_STACK;
+    uint8_t reg  = fIMUPointer;
+    uint8_t bank = (fBankSel >> 4) & 0x03;
+    uint8_t rv;
+
+    if (reg == REG_BANK_SEL)
+    {
+	rv = fBankSel;
+    }
+    else if (bank != 0)
+    {
+	rv = fReg[bank][reg];
+    }
+    else
+    {
+	switch (reg)
+	{
+	case INT_STATUS_1:
+	case INT_STATUS_2:
+	    rv = fReg[0][reg];
+	    fReg[0][reg] = 0;
+	    break;
+	case FIFO_COUNTH:
+	    rv = (fFIFOCount >> 8) & 0x1F;
+	    break;
+	case FIFO_COUNTL:
+	    rv = fFIFOCount & 0xFF;
+	    break;
+	case FIFO_R_W:
+	    rv = 0xFF;
+	    if (fFIFOCount>0)
+	    {
+		rv = fFIFO[fFIFOHead];
+		fFIFOHead = (fFIFOHead+1) % kFIFOSize;
+		fFIFOCount--;
+	    }
+	    return rv;
+	default:
+	    rv = fReg[0][reg];
+	    if ((fReg[0][INT_PIN_CFG] & kANYRD_2CLEAR) &&
+		(reg >= ACCEL_XOUT_H) && (reg <= TEMP_OUT_L))
+	    {
+		fReg[0][INT_STATUS_1] = 0;
+	    }
+	    break;
+	}
+    }
+    fIMUPointer = (reg + 1) & 0x7F;
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMUWrite
+ *
+ * Description : Write the register at the pointer in the selected
+ *     bank. Read only registers ignore the write.
+ *
+ * Inputs : value - to write
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::IMUWrite(uint8_t value)
+{
+    SET_DEBUG_STACK;
+    uint8_t reg  = fIMUPointer;
+    uint8_t bank = (fBankSel >> 4) & 0x03;
+
+    fIMUPointer = (reg + 1) & 0x7F;
+    if (reg == REG_BANK_SEL)
+    {
+	fBankSel = value & 0x30;
+	return;
+    }
+    if (bank == 0)
+    {
+	switch (reg)
+	{
+	case PWR_MGMT_1:
+	    if (value & kDEVICE_RESET)
+	    {
+		IMUReset();
+		return;
+	    }
+	    break;
+	case FIFO_RST:
+	    if (value & 0x1F)
+	    {
+		fFIFOHead  = 0;
+		fFIFOCount = 0;
+	    }
+	    break;
+	case WHO_AM_I_ICM20948:
+	case INT_STATUS:
+	case INT_STATUS_1:
+	case INT_STATUS_2:
+	case INT_STATUS_3:
+	case FIFO_COUNTH:
+	case FIFO_COUNTL:
+	case FIFO_R_W:
+	    return;
+	default:
+	    if ((reg >= ACCEL_XOUT_H) && (reg <= EXT_SENS_DATA_23)) return;
+	    break;
+	}
+    }
+    else if ((bank == 2) && (reg == GYRO_SMPLRT_DIV))
+    {
+	// New sample rate, restart the sample clock.
+	fTBase  = fNow;
+	fSample = 0;
+    }
+    fReg[bank][reg] = value;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMULatch
+ *
+ * Description : Generate the 14 byte sensor block for time t
+ *     using the current full scale settings.
+ *
+ * Inputs :
+ *     t     - seconds since start
+ *     block - output ACCEL_XOUT_H ... TEMP_OUT_L
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::IMULatch(double t, uint8_t *block)
+{
+    SET_DEBUG_STACK;
+    double  Acc[3], Gyro[3], Mag[3], Temp;
+    double  AFS = (double) (2   << ((fReg[2][ACCEL_CONFIG]  >> 1) & 0x03));
+    double  GFS = (double) (250 << ((fReg[2][GYRO_CONFIG_1] >> 1) & 0x03));
+    double  counts[7];
+    int16_t v;
+    size_t  i;
+
+    Motion(t, Acc, Gyro, Mag, &Temp);
+    for (i=0;i<3;i++)
+    {
+	counts[i]   = Acc[i]  * 32768.0 / AFS;
+	counts[i+3] = Gyro[i] * 32768.0 / GFS;
+    }
+    counts[6] = (Temp - 21.0) * 333.87 + 40.0;
+
+    for (i=0;i<7;i++)
+    {
+	if (counts[i] >  32767.0) counts[i] =  32767.0;
+	if (counts[i] < -32768.0) counts[i] = -32768.0;
+	v = (int16_t) lrint(counts[i]);
+	block[2*i]   = ((uint16_t) v >> 8) & 0xFF;
+	block[2*i+1] = (uint16_t) v & 0xFF;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : FIFOPush
+ *
+ * Description : Append bytes to the FIFO. In stream mode the
+ *     oldest data is discarded when full, in snapshot mode the
+ *     new data is. Either way the overflow status is set.
+ *
+ * Inputs :
+ *     data - bytes to add
+ *     n    - number of bytes
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::FIFOPush(const uint8_t *data, size_t n)
+{
+    size_t i;
+    for (i=0;i<n;i++)
+    {
+	if (fFIFOCount == kFIFOSize)
+	{
+	    fReg[0][INT_STATUS_2] |= kFIFO_OVF;
+	    if (fReg[0][FIFO_MODE] & kSNAPSHOT) return;
+	    fFIFOHead = (fFIFOHead+1) % kFIFOSize;
+	    fFIFOCount--;
+	}
+	fFIFO[(fFIFOHead + fFIFOCount) % kFIFOSize] = data[i];
+	fFIFOCount++;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagVisible
+ *
+ * Description : The AK09916 sits on the ICM auxiliary bus, it
+ *     only answers on the host bus in bypass mode with the
+ *     internal I2C master off.
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if the AK09916 can be addressed directly
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool I2CSim::MagVisible(void) const
+{
+    return ((fReg[0][INT_PIN_CFG] & kBYPASS_EN) != 0) &&
+	((fReg[0][USER_CTRL] & kI2C_MST_EN) == 0);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MasterRead
+ *
+ * Description : One SLV0 read by the ICM I2C master. Only the
+ *     AK09916 is on the auxiliary bus, anything else NACKs and 
+ *     sets I2C_SLV0_NACK in I2C_MST_STATUS. 
+ *
+ * Inputs : ext - EXT_SLV_SENS_DATA bytes read
+ *
+ * Returns : number of bytes, I2C_SLV0_CTRL length
+ *
+ * Error Conditions : NACK
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t I2CSim::MasterRead(uint8_t *ext)
+{
+    SET_DEBUG_STACK;
+    uint8_t addr = fReg[3][I2C_SLV0_ADDR];
+    size_t  len  = fReg[3][I2C_SLV0_CTRL] & 0x0F;
+    size_t  i;
+
+    if (((addr & 0x7F) == fMagAddress) && (addr & kSLV_RNW))
+    {
+	fMagPointer = fReg[3][I2C_SLV0_REG] & 0x3F;
+	for (i=0;i<len;i++) ext[i] = MagRead();
+    }
+    else
+    {
+	memset(ext, 0, len);
+	fReg[0][I2C_MST_STATUS] |= kSLV0_NACK;
+    }
+    return len;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagReset
+ *
+ * Description : AK09916 power on state, power down mode.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::MagReset(void)
+{
+    SET_DEBUG_STACK;
+    memset(fMagReg, 0, sizeof(fMagReg));
+    fMagReg[kWIA1]            = 0x48;
+    fMagReg[WHO_AM_I_AK09916] = 0x09;
+    fMagPointer = 0;
+    fMagTBase   = fNow;
+    fMagSample  = 0;
+    fMagReading = false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagRate
+ *
+ * Description : continuous measurement rate from CNTL2
+ *
+ * Inputs : NONE
+ *
+ * Returns : rate in Hz, 0 if not in a continuous mode
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double I2CSim::MagRate(void) const
+{
+    switch(fMagReg[AK09916_CNTL2])
+    {
+    case AK09916::kM_10HZ:
+	return 10.0;
+    case AK09916::kM_20HZ:
+	return 20.0;
+    case AK09916::kM_50HZ:
+	return 50.0;
+    case AK09916::kM_100HZ:
+	return 100.0;
+    }
+    return 0.0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagAdvance
+ *
+ * Description : Complete any measurement that is due. Data is
+ *     protected while a read cycle is open.
+ *
+ * Inputs : t - time to advance to
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::MagAdvance(double t)
+{
+    SET_DEBUG_STACK;
+    uint8_t  mode = fMagReg[AK09916_CNTL2];
+    double   rate;
+    uint64_t m;
+
+    if (fMagReading) return;
+
+    if ((mode == AK09916::kSINGLE_MEAS) || (mode == AK09916::kSELF_TEST))
+    {
+	if (t - fMagTBase >= kMagMeasTime)
+	{
+	    MagLatch(t, (mode == AK09916::kSELF_TEST));
+	    // Back to power down on completion.
+	    fMagReg[AK09916_CNTL2] = AK09916::kPOWER_DOWN;
+	}
+    }
+    else
+    {
+	rate = MagRate();
+	if (rate > 0.0)
+	{
+	    m = (uint64_t) floor((t - fMagTBase) * rate);
+	    if (m > fMagSample)
+	    {
+		MagLatch(fMagTBase + (double) m / rate, false);
+		fMagSample = m;
+	    }
+	}
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagLatch
+ *
+ * Description : Store a measurement, set DRDY, DOR if the previous
+ *     measurement was never read.
+ *
+ * Inputs :
+ *     t        - time of the measurement
+ *     SelfTest - use the internal self test field instead
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::MagLatch(double t, bool SelfTest)
+{
+    SET_DEBUG_STACK;
+    const double kRes = 4912.0/32767.0;   // uT/LSB
+    double  Acc[3], Gyro[3], Mag[3], Temp;
+    double  c;
+    int16_t v;
+    bool    overflow = false;
+    size_t  i;
+
+    if (SelfTest)
+    {
+	Mag[0] = 0.0; Mag[1] = 0.0; Mag[2] = -80.0;
+    }
+    else
+    {
+	Motion(t, Acc, Gyro, Mag, &Temp);
+    }
+    for (i=0;i<3;i++)
+    {
+	c = Mag[i]/kRes;
+	if (fabs(c) > 32752.0) overflow = true;
+	if (c >  32767.0) c =  32767.0;
+	if (c < -32768.0) c = -32768.0;
+	v = (int16_t) lrint(c);
+	// Little endian, L then H
+	fMagReg[AK09916_XOUT_L+2*i] = (uint16_t) v & 0xFF;
+	fMagReg[AK09916_XOUT_H+2*i] = ((uint16_t) v >> 8) & 0xFF;
+    }
+    fMagReg[kTMPS]       = 0;
+    fMagReg[AK09916_ST2] = overflow ? kMagHOFL : 0;
+    if (fMagReg[AK09916_ST1] & kMagDRDY)
+    {
+	fMagReg[AK09916_ST1] |= kMagDOR;
+    }
+    fMagReg[AK09916_ST1] |= kMagDRDY;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagRead
+ *
+ * Description : Read at the AK09916 register pointer. Reading any
+ *     of HXL..TMPS opens a read cycle and clears DRDY, reading ST2
+ *     closes it and clears DOR.
+ *
+ * Inputs : NONE
+ *
+ * Returns : register value
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint8_t I2CSim::MagRead(void)
+{
+    SET_DEBUG_STACK;
+    uint8_t reg = fMagPointer;
+    uint8_t rv  = fMagReg[reg];
+
+    if ((reg >= AK09916_XOUT_L) && (reg <= kTMPS))
+    {
+	fMagReading = true;
+	fMagReg[AK09916_ST1] &= ~kMagDRDY;
+    }
+    else if (reg == AK09916_ST2)
+    {
+	fMagReading = false;
+	fMagReg[AK09916_ST1] &= ~(kMagDRDY|kMagDOR);
+    }
+    fMagPointer = (reg + 1) & 0x3F;
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : MagWrite
+ *
+ * Description : Write at the AK09916 register pointer, only
+ *     CNTL2 and CNTL3 are writable.
+ *
+ * Inputs : value - to write
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::MagWrite(uint8_t value)
+{
+    SET_DEBUG_STACK;
+    uint8_t reg = fMagPointer;
+
+    fMagPointer = (reg + 1) & 0x3F;
+    if (reg == AK09916_CNTL2)
+    {
+	fMagReg[AK09916_CNTL2] = value & 0x1F;
+	fMagTBase  = fNow;
+	fMagSample = 0;
+    }
+    else if ((reg == AK09916_CNTL3) && (value & 0x01))
+    {
+	MagReset();
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Motion
+ *
+ * Description : Synthetic motion at time t. Roll and pitch
+ *     oscillate slowly while yaw turns at a constant rate.
+ *     The accelerometer sees gravity and the magnetometer a
+ *     fixed earth field (NED) rotated into the body frame,
+ *     the gyro the body rates from the Euler rates.
+ *
+ * Inputs :
+ *     t    - seconds
+ *     Acc  - output g
+ *     Gyro - output dps
+ *     Mag  - output uT
+ *     Temp - output C
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void I2CSim::Motion(double t, double *Acc, double *Gyro, double *Mag,
+		    double *Temp)
+{
+    const double kDeg2Rad = M_PI/180.0;
+    const double kRollAmp = 10.0 * kDeg2Rad, kRollW  = 2.0*M_PI*0.50;
+    const double kPitchAmp=  5.0 * kDeg2Rad, kPitchW = 2.0*M_PI*0.20;
+    const double kYawRate =  6.0 * kDeg2Rad;
+    const double kMagN    = 20.0, kMagD = 45.0;   // uT
+
+    double phi   = kRollAmp  * sin(kRollW  * t);
+    double theta = kPitchAmp * sin(kPitchW * t);
+    double psi   = kYawRate  * t;
+    double dphi  = kRollAmp  * kRollW  * cos(kRollW  * t);
+    double dtheta= kPitchAmp * kPitchW * cos(kPitchW * t);
+    double dpsi  = kYawRate;
+
+    double sf = sin(phi),   cf = cos(phi);
+    double st = sin(theta), ct = cos(theta);
+    double sp = sin(psi),   cp = cos(psi);
+
+    // Body rates from Euler rates, ZYX.
+    Gyro[0] = (dphi - st*dpsi)              / kDeg2Rad + Noise(0.05);
+    Gyro[1] = (cf*dtheta + sf*ct*dpsi)      / kDeg2Rad + Noise(0.05);
+    Gyro[2] = (-sf*dtheta + cf*ct*dpsi)     / kDeg2Rad + Noise(0.05);
+
+    // Gravity, third column of the nav to body DCM.
+    Acc[0]  = -st    + Noise(0.002);
+    Acc[1]  = sf*ct  + Noise(0.002);
+    Acc[2]  = cf*ct  + Noise(0.002);
+
+    // Earth field (N, 0, D) into the body frame.
+    Mag[0]  = ct*cp*kMagN                 - st*kMagD    + Noise(0.3);
+    Mag[1]  = (sf*st*cp - cf*sp)*kMagN    + sf*ct*kMagD + Noise(0.3);
+    Mag[2]  = (cf*st*cp + sf*sp)*kMagN    + cf*ct*kMagD + Noise(0.3);
+
+    *Temp   = 30.0 + 0.5*sin(2.0*M_PI*t/60.0);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Noise
+ *
+ * Description : Approximately gaussian noise, sum of four
+ *     uniform deviates from a linear congruential generator.
+ *
+ * Inputs : sigma - standard deviation
+ *
+ * Returns : noise sample
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double I2CSim::Noise(double sigma)
+{
+    double sum = 0.0;
+    int    i;
+    for (i=0;i<4;i++)
+    {
+	fSeed = fSeed * 1664525U + 1013904223U;
+	sum  += ((double) (fSeed >> 8) / 16777216.0) - 0.5;
+    }
+    // Variance of the sum is 4/12.
+    return sigma * sum * sqrt(3.0);
+}
@@ -0,0 +1,144 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : I2CSim.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : In process I2C backend that models the ICM-20948
+ *     and the AK09916 at the register level. Used to run the full
+ *     IMU stack, and benchmark IMU::Do, on a machine without the
+ *     sensor attached.
+ *
+ *     ICM-20948
+ *        four register banks selected by REG_BANK_SEL
+ *        PWR_MGMT_1 reset and sleep
+ *        sample clock from GYRO_SMPLRT_DIV, 1125/(1+div) Hz
+ *        accel/gyro full scale from ACCEL_CONFIG/GYRO_CONFIG_1
+ *        data registers latched per sample, INT_STATUS_1 DRDY
+ *        FIFO, FIFO_EN_2 selection, FIFO_COUNT, FIFO_R_W, FIFO_RST
+ *        stream/snapshot mode and overflow in INT_STATUS_2
+ *        BYPASS_EN in INT_PIN_CFG gates access to the AK09916
+ *        I2C master SLV0 reads into EXT_SLV_SENS_DATA every sample,
+ *        and into the FIFO with FIFO_EN_1 SLV_0_FIFO_EN
+ *
+ *     AK09916
+ *        WIA1/WIA2, CNTL2 modes (single, 10/20/50/100Hz, self test)
+ *        ST1 DRDY/DOR, read cycle closed by reading ST2, CNTL3 SRST
+ *
+ *     Motion is synthetic, slow roll and pitch oscillation with a
+ *     constant yaw rate, gravity and a fixed earth field rotated
+ *     into the body frame, plus a little noise.
+ *
+ * Restrictions/Limitations :
+ *     Bus timing is not modelled, transfers are instantaneous.
+ *     Any message order is taken unless SetReadLast, which refuses
+ *     a read before the last message with EOPNOTSUPP as the Pi's
+ *     i2c-bcm2835 does.
+ *     The AK09916 axes are taken to be the same as the ICM axes.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  I2C master SLV0 model.
+ * 17-Oct-26  CBL  Combined, SetReadLast for the i2c-bcm2835 rule.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     ICM-20948 data sheet DS-000189
+ *     AK09916 data sheet
+ *
+ *******************************************************************
+ */
+#ifndef __I2CSIM_hh_
+#define __I2CSIM_hh_
+#    include "I2CBus.hh"
+
+/// I2CSim - simulated bus with ICM-20948 and AK09916 attached.
+class I2CSim : public I2CBus {
+public:
+    /// Default Constructor
+    I2CSim(uint8_t IMUAddress = 0x69, uint8_t MagAddress = 0x0C);
+    /// Default destructor
+    ~I2CSim(void);
+
+    uint8_t ReadReg8(uint8_t SlaveAddress, uint8_t Register);
+    int     ReadBlock(uint8_t SlaveAddress, unsigned char Register,
+		      size_t  size,  void* data);
+    bool    WriteReg8(uint8_t SlaveAddress, unsigned char Register,
+		      unsigned char value);
+    int     ReadWord(uint8_t SlaveAddress, unsigned char Register);
+    bool    WriteWord(uint8_t SlaveAddress, uint8_t Register,
+		      uint16_t value);
+
+    /*! Refuse a read that is not the last message, as i2c-bcm2835. */
+    inline void SetReadLast(bool value) {fReadLast = value;};
+
+    /*! Number of ICM samples generated since start. */
+    inline uint64_t Samples(void) const {return fNSamples;};
+
+private:
+    static const size_t kNBank    = 4;
+    static const size_t kBankSize = 128;
+    static const size_t kFIFOSize = 512;
+
+    uint8_t   fIMUAddress;
+    uint8_t   fMagAddress;
+    double    fStart;       // CLOCK_MONOTONIC at construction
+    double    fNow;         // time of the current transaction, from fStart
+
+    /* ICM-20948 state. */
+    uint8_t   fReg[kNBank][kBankSize];
+    uint8_t   fBankSel;     // REG_BANK_SEL, bank in bits 5:4
+    uint8_t   fIMUPointer;  // register address pointer
+    double    fTBase;       // time sample 0 was taken
+    uint64_t  fSample;      // last sample latched into data registers
+    uint64_t  fNSamples;    // total samples generated
+    uint8_t   fFIFO[kFIFOSize];
+    size_t    fFIFOHead;
+    size_t    fFIFOCount;
+
+    /* AK09916 state. */
+    uint8_t   fMagReg[0x40];
+    uint8_t   fMagPointer;
+    double    fMagTBase;    // time the current mode was set
+    uint64_t  fMagSample;   // last measurement index latched
+    bool      fMagReading;  // data read started, ST2 not yet read
+
+    uint32_t  fSeed;        // noise generator
+    bool      fReadLast;    // adapter takes a read only last
+
+protected:
+    int       Combined(struct i2c_msg *Msgs, size_t n);
+
+private:
+    /* Bus level. */
+    bool      Transfer(struct i2c_msg *msg);
+    bool      RegisterIO(uint8_t Address, uint8_t Register, bool Read,
+			 size_t n, uint8_t *data);
+    void      Advance(void);
+
+    /* ICM-20948 model. */
+    void      IMUReset(void);
+    bool      IMUSleep(void) const;
+    double    ODR(void) const;
+    uint8_t   IMURead(void);
+    void      IMUWrite(uint8_t value);
+    void      IMULatch(double t, uint8_t *block);
+    void      FIFOPush(const uint8_t *data, size_t n);
+    bool      MagVisible(void) const;
+    size_t    MasterRead(uint8_t *ext);
+
+    /* AK09916 model. */
+    void      MagReset(void);
+    double    MagRate(void) const;
+    void      MagAdvance(double t);
+    void      MagLatch(double t, bool SelfTest);
+    uint8_t   MagRead(void);
+    void      MagWrite(uint8_t value);
+
+    /* Synthetic motion. */
+    void      Motion(double t, double *Acc, double *Gyro, double *Mag,
+		     double *Temp);
+    double    Noise(double sigma);
+};
+#endif
@@ -7,6 +7,13 @@
  * Modified   BY   Reason
  * --------   --   ------
  * 15-Dec-23  CBL  stopped using wiring-pi
+ * 17-Oct-26  CBL  readAll burst read, signed temperature conversion
+ * 17-Oct-26  CBL  QueueRead/Decode for combined I2C transactions
+ * 17-Oct-26  CBL  FIFO streaming acquisition
+ * 17-Oct-26  CBL  AK09916 through the internal I2C master
+ * 17-Oct-26  CBL  SetIntLatch, pulsed data ready for GPIO edge wait
+ * 17-Oct-26  CBL  DecodeRaw/Scale for the IMURaw format
+ * 17-Oct-26  CBL  ReadFIFO bus errors counted, first logged
  *
  * Description : Generic ICM-20948
  *
@@ -34,6 +41,7 @@
 using namespace std;
 #include <string>
 #include <cstring>
+#include <cerrno>
 #include <cmath>
 #include <unistd.h>
 #include <limits.h>
@@ -42,7 +50,7 @@ using namespace std;
 #include "debug.h"
 #include "CLogger.hh"
 #include "ICM-20948.hh"
-#include "I2CHelper.hh"
+#include "I2CBus.hh"
 
 /**
  ******************************************************************
@@ -87,6 +95,17 @@ ICM20948::ICM20948 (uint8_t IMU_address) : CObject()
     fAres = getAres();
     fIMU_address = IMU_address;
 
+    // 1.125kHz/(1+4) = 225Hz
+    fSampleDiv     = 4;
+    fBlockSize     = kSensorBlockSize;
+    fMagMaster     = false;
+    fIntLatch      = true;
+    fFIFOPacketSize= kFIFOPacket;
+    fFIFOSync      = false;
+    fFIFOLast      = 0;
+    fFIFOOverflows = 0;
+    fFIFOBusErrors = 0;
+
     if(!InitICM20948())
     {
 	SetError(-1, __LINE__);
@@ -146,7 +165,7 @@ bool ICM20948::InitICM20948(void)
 {
     SET_DEBUG_STACK;
     CLogger   *log  = CLogger::GetThis();
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     ClearError(__LINE__);
 
     if (fIMU_address <= 0)
@@ -216,7 +235,7 @@ bool ICM20948::InitICM20948(void)
      * Gyro sample rate divider Section 10.1
      *  
      */
-    rv = pI2C->WriteReg8( fIMU_address, GYRO_SMPLRT_DIV, 0x04);
+    rv = pI2C->WriteReg8( fIMU_address, GYRO_SMPLRT_DIV, fSampleDiv);
 
     /*
      *
@@ -256,7 +275,7 @@ bool ICM20948::InitICM20948(void)
      * 
      * Section 10.12 (LSB for sample rate) 1.125kHz/(1+ACCEL_SSMPLRT_DIV[11:0]
      */
-    rv = pI2C->WriteReg8( fIMU_address, ACCEL_SMPLRT_DIV_2, 0x04);
+    rv = pI2C->WriteReg8( fIMU_address, ACCEL_SMPLRT_DIV_2, fSampleDiv);
 
     /*
      * Do we neet to set MSB too - lets be complete, CBL addition
@@ -425,27 +444,49 @@ double ICM20948::getAres(void)
 double ICM20948::readTempData(void)
 {
     SET_DEBUG_STACK;
-    const double RoomTemp_Offset  = 40.0;    // lower end of temperature scale
-    const double Temp_Sensitivity = 333.87;  // LSB/C
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
 
-    double   Temp = 0.0;
     uint8_t  Hi, Lo;
-    uint16_t itemp;
+    int16_t  counts;
 
     // Turn the MSB and LSB into a 16-bit value
     Hi = pI2C->ReadReg8( fIMU_address, TEMP_OUT_H);
     Lo = pI2C->ReadReg8( fIMU_address,TEMP_OUT_L);
-    itemp = ((int16_t)Hi << 8) | Lo;
+    counts = (int16_t)(((uint16_t)Hi << 8) | Lo);
 
+    SET_DEBUG_STACK;
+    return ConvertTemp(counts);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ConvertTemp
+ *
+ * Description : 
+ *     Convert raw TEMP_OUT counts to degrees C. The register is 
+ *     a signed two's complement value, it was previously treated
+ *     as unsigned which gave nonsense below 21C. 
+ *
+ * Inputs : counts - raw TEMP_OUT_H:TEMP_OUT_L
+ *
+ * Returns : Temperature in degrees C
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double ICM20948::ConvertTemp(int16_t counts) const
+{
     /*
      * Temp C = ((TempOut - RoomTemp_Offset)/Temp_Sensitivity)+21.0
      * I think RoomTemp_Offset is wrong. 
      */
-    Temp = ((double)itemp - RoomTemp_Offset)/Temp_Sensitivity + 21.0;
-
-    SET_DEBUG_STACK;
-    return Temp;
+    return ((double)counts - kRoomTempOffset)/kTempSensitivity + 21.0;
 }
 
 /**
@@ -471,7 +512,7 @@ double ICM20948::readTempData(void)
 bool ICM20948::readAccelData(double *XYZ)
 {
     SET_DEBUG_STACK;
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
 
     uint8_t *ptr;
     ptr = (uint8_t *)&itemp;
@@ -524,7 +565,7 @@ bool ICM20948::readAccelData(double *XYZ)
 bool ICM20948::readGyroData(double *XYZ)
 {
     SET_DEBUG_STACK;
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
 
     uint8_t *ptr;
     ptr = (uint8_t *)&itemp;
@@ -554,6 +595,586 @@ bool ICM20948::readGyroData(double *XYZ)
     return true;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name : readAll
+ *
+ * Description : Burst read of the full sensor block, 
+ *     ACCEL_XOUT_H ... GYRO_ZOUT_L, TEMP_OUT_H, TEMP_OUT_L
+ *     (and EXT_SLV_SENS_DATA in I2C master mode)
+ *     in one I2C transaction. The chip keeps the data registers
+ *     stable for the duration of a burst so all 7 values belong
+ *     to the same sample, and the bus cost is one transaction 
+ *     rather than 14. 
+ *
+ * Inputs : 
+ *     Acc  - user supplied array of 3 for the accelerations (g)
+ *     Gyro - user supplied array of 3 for the rates (dps)
+ *     Temp - pointer to temperature (C)
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : I2C read failure, outputs not modified. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::readAll(double *Acc, double *Gyro, double *Temp)
+{
+    SET_DEBUG_STACK;
+    I2CBus    *pI2C = I2CBus::GetThis();
+
+    if (pI2C->ReadBlock(fIMU_address, ACCEL_XOUT_H, fBlockSize, fBlock)
+	!= (int) fBlockSize)
+    {
+	SET_DEBUG_STACK;
+	return false;
+    }
+    Decode(Acc, Gyro, Temp);
+
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : QueueRead
+ *
+ * Description : Add the sensor block read to the current combined
+ *     I2C transaction. Nothing is on the bus until Submit. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if queued. 
+ *
+ * Error Conditions : transaction full
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::QueueRead(void)
+{
+    SET_DEBUG_STACK;
+    I2CBus    *pI2C = I2CBus::GetThis();
+    return pI2C->QueueRead(fIMU_address, ACCEL_XOUT_H, fBlockSize, fBlock);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Decode
+ *
+ * Description : Unpack the sensor block, 
+ *     ACCEL_XOUT_H ... GYRO_ZOUT_L, TEMP_OUT_H, TEMP_OUT_L
+ *
+ * Inputs : 
+ *     Acc  - user supplied array of 3 for the accelerations (g)
+ *     Gyro - user supplied array of 3 for the rates (dps)
+ *     Temp - pointer to temperature (C)
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ICM20948::Decode(double *Acc, double *Gyro, double *Temp)
+{
+    SET_DEBUG_STACK;
+    int16_t   rAcc[3], rGyro[3], rTemp;
+    size_t    i;
+
+    DecodeRaw(rAcc, rGyro, &rTemp);
+    for (i=0;i<3;i++)
+    {
+	Acc[i]  = (double)rAcc[i]  * fAres;
+	Gyro[i] = (double)rGyro[i] * fGres;
+    }
+    *Temp = ConvertTemp(rTemp);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : DecodeRaw
+ *
+ * Description : Unpack the sensor block into register counts, 
+ *     ACCEL_XOUT_H ... GYRO_ZOUT_L, TEMP_OUT_H, TEMP_OUT_L
+ *
+ * Inputs : 
+ *     Acc  - user supplied array of 3
+ *     Gyro - user supplied array of 3
+ *     Temp - TEMP_OUT
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ICM20948::DecodeRaw(int16_t *Acc, int16_t *Gyro, int16_t *Temp) const
+{
+    int16_t   raw[kSensorBlockSize/2];
+    size_t    i;
+
+    // Registers are big endian, high byte first. 
+    for (i=0;i<kSensorBlockSize/2;i++)
+    {
+	raw[i] = (int16_t)(((uint16_t)fBlock[2*i] << 8) | fBlock[2*i+1]);
+    }
+    for (i=0;i<3;i++)
+    {
+	Acc[i]  = raw[i];
+	Gyro[i] = raw[i+3];
+    }
+    *Temp = raw[6];
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Scale
+ *
+ * Description : Count to engineering unit conversions in force, 
+ *     matches Decode and ConvertTemp. 
+ *
+ * Inputs : s - user supplied, Acc, Gyro and Temp filled in
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ICM20948::Scale(IMUScale *s) const
+{
+    s->Acc        = fAres;
+    s->Gyro       = fGres;
+    s->TempScale  = 1.0/kTempSensitivity;
+    s->TempOffset = 21.0 - kRoomTempOffset/kTempSensitivity;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : EnableFIFO
+ *
+ * Description : Stream accel and gyro into the FIFO. Same register
+ *     sequence as calibrateICM20948, but stream mode so the 
+ *     FIFO keeps running. Packets are 12 bytes, 
+ *     ACCEL X,Y,Z then GYRO X,Y,Z, big endian, followed by
+ *     the 9 magnetometer bytes in I2C master mode. 
+ *
+ * Inputs : Enable - true to start streaming, false to stop
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : I2C write fail
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::EnableFIFO(bool Enable)
+{
+    SET_DEBUG_STACK;
+    CLogger   *log  = CLogger::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
+    bool      rv;
+    uint8_t   c;
+
+    // Bank 0 holds all the FIFO registers.
+    rv = pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x00);
+
+    /*
+     * accel + gyro X,Y,Z, and SLV0 (the magnetometer) if the I2C 
+     * master is reading it. Packet order follows the registers, 
+     * accel, gyro, then EXT_SLV_SENS_DATA. 
+     */
+    fFIFOPacketSize = kFIFOPacket;
+    if (fMagMaster && Enable)
+    {
+	fFIFOPacketSize += AK09916::kBlockSize;
+    }
+    rv = rv && pI2C->WriteReg8( fIMU_address, FIFO_EN_1, 
+				(fMagMaster && Enable) ? 0x01 : 0x00);
+    rv = rv && pI2C->WriteReg8( fIMU_address, FIFO_EN_2, Enable ? 0x1E : 0x00);
+
+    // Stream mode, oldest data is overwritten on overflow. 
+    rv = rv && pI2C->WriteReg8( fIMU_address, FIFO_MODE, 0x00);
+
+    // Overflow shows up in INT_STATUS_2
+    rv = rv && pI2C->WriteReg8( fIMU_address, INT_ENABLE_2, Enable ? 0x01 : 0x00);
+
+    // USER_CTRL bit 6 FIFO_EN, leave the rest alone
+    c = pI2C->ReadReg8( fIMU_address, USER_CTRL);
+    if (Enable)
+	c |= 0x40;
+    else
+	c &= ~0x40;
+    rv = rv && pI2C->WriteReg8( fIMU_address, USER_CTRL, c);
+
+    rv = rv && ResetFIFO();
+    fFIFOOverflows = 0;
+    fFIFOBusErrors = 0;
+
+    if (rv)
+    {
+	log->Log("# ICM20948 FIFO %s, ODR %.1f Hz\n", 
+		 Enable ? "streaming" : "off", ODR());
+    }
+    else
+    {
+	log->LogError(__FILE__,__LINE__,'W', "ICM20948 FIFO setup failed.\n");
+    }
+    SET_DEBUG_STACK;
+    return rv;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ResetFIFO
+ *
+ * Description : Assert then release FIFO_RST, clear any pending
+ *     overflow status. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : I2C write fail
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::ResetFIFO(void)
+{
+    SET_DEBUG_STACK;
+    I2CBus    *pI2C = I2CBus::GetThis();
+    bool      rv;
+
+    rv = pI2C->WriteReg8( fIMU_address, FIFO_RST, 0x1F);
+    rv = rv && pI2C->WriteReg8( fIMU_address, FIFO_RST, 0x00);
+    // Read clears
+    pI2C->ReadReg8( fIMU_address, INT_STATUS_2);
+    fFIFOSync = false;
+    SET_DEBUG_STACK;
+    return rv;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadFIFO
+ *
+ * Description : Drain the FIFO in two bus transactions. 
+ *     1) INT_STATUS_2, FIFO_COUNTH/L and TEMP_OUT_H/L, submitted
+ *        together with whatever the caller has queued. On an
+ *        adapter that takes a read only last, i2c-bcm2835, 
+ *        I2CBus::Submit splits this into write/read pairs. 
+ *     2) all complete packets from FIFO_R_W, one read. 
+ *
+ *     Timestamps: the newest packet was taken within one sample 
+ *     period before the count was read. Samples are spaced by 
+ *     1/ODR from the last sample of the previous drain. The chip
+ *     oscillator is only good to a percent or so, so if the 
+ *     newest stamp lands in the future, or falls more than two
+ *     periods behind the host clock, the block is shifted to 
+ *     line up with the host clock again. 
+ *
+ * Inputs : 
+ *     samples - user array
+ *     n       - size of user array
+ *     Temp    - temperature at drain time (C)
+ *
+ * Returns : number of samples, 0 on overflow, -1 on bus error
+ *
+ * Error Conditions : overflow or bus error, both counted and the
+ *     first bus error logged with its errno
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int ICM20948::ReadFIFO(FIFOSample *samples, size_t n, double *Temp)
+{
+    SET_DEBUG_STACK;
+    CLogger   *log  = CLogger::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
+    struct timespec now;
+    size_t    count, npacket, i, j;
+    int16_t   raw[6];
+    uint8_t   *p;
+    int64_t   tread, period, newest, shift;
+
+    /* Status, count and temperature, one transaction. */
+    pI2C->QueueRead(fIMU_address, INT_STATUS_2, 1, &fFIFOStatus[0]);
+    pI2C->QueueRead(fIMU_address, FIFO_COUNTH,  2, &fFIFOStatus[1]);
+    pI2C->QueueRead(fIMU_address, TEMP_OUT_H,   2, &fFIFOStatus[3]);
+    if (!pI2C->Submit())
+    {
+	if (fFIFOBusErrors++ == 0)
+	{
+	    log->LogTime(" ICM20948 FIFO read failed, %s\n", 
+			 strerror(pI2C->LastErrno()));
+	}
+	SET_DEBUG_STACK;
+	return -1;
+    }
+    clock_gettime(CLOCK_REALTIME, &now);
+    tread = (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
+
+    *Temp = ConvertTemp((int16_t)(((uint16_t)fFIFOStatus[3] << 8) | 
+				  fFIFOStatus[4]));
+    count = (((size_t)fFIFOStatus[1] & 0x1F) << 8) | fFIFOStatus[2];
+
+    /*
+     * On overflow the oldest data has been overwritten and the 
+     * packet boundaries are lost. Start over. 
+     */
+    if ((fFIFOStatus[0] & 0x1F) || (count >= kFIFOSize))
+    {
+	fFIFOOverflows++;
+	log->LogTime(" ICM20948 FIFO overflow %u, count %u\n", 
+		     fFIFOOverflows, (unsigned) count);
+	ResetFIFO();
+	SET_DEBUG_STACK;
+	return 0;
+    }
+
+    npacket = count / fFIFOPacketSize;
+    if (npacket > n) npacket = n;
+    if (npacket == 0)
+    {
+	SET_DEBUG_STACK;
+	return 0;
+    }
+
+    /* Bulk read, FIFO_R_W does not auto increment. */
+    pI2C->BeginTransaction();
+    pI2C->QueueRead(fIMU_address, FIFO_R_W, npacket*fFIFOPacketSize, 
+		    fFIFOData);
+    if (!pI2C->Submit())
+    {
+	if (fFIFOBusErrors++ == 0)
+	{
+	    log->LogTime(" ICM20948 FIFO read failed, %s\n", 
+			 strerror(pI2C->LastErrno()));
+	}
+	SET_DEBUG_STACK;
+	return -1;
+    }
+
+    period = (int64_t) llrint(1.0e9/ODR());
+    if (!fFIFOSync)
+    {
+	fFIFOLast = tread - (int64_t) npacket * period;
+	fFIFOSync = true;
+    }
+    newest = fFIFOLast + (int64_t) npacket * period;
+    shift  = 0;
+    if ((newest > tread) || (newest < tread - 2*period))
+    {
+	shift = tread - newest;
+    }
+
+    for (i=0;i<npacket;i++)
+    {
+	p = &fFIFOData[i*fFIFOPacketSize];
+	for (j=0;j<6;j++)
+	{
+	    raw[j] = (int16_t)(((uint16_t)p[2*j] << 8) | p[2*j+1]);
+	}
+	for (j=0;j<3;j++)
+	{
+	    samples[i].RawAcc[j]  = raw[j];
+	    samples[i].RawGyro[j] = raw[j+3];
+	    samples[i].Acc[j]  = (double)raw[j]   * fAres;
+	    samples[i].Gyro[j] = (double)raw[j+3] * fGres;
+	}
+	samples[i].HasMag = (fFIFOPacketSize > kFIFOPacket);
+	if (samples[i].HasMag)
+	{
+	    memcpy(samples[i].Mag, &p[kFIFOPacket], AK09916::kBlockSize);
+	}
+	newest = fFIFOLast + (int64_t)(i+1) * period + shift;
+	samples[i].Time.tv_sec  = newest / 1000000000LL;
+	samples[i].Time.tv_nsec = newest % 1000000000LL;
+    }
+    fFIFOLast = newest;
+
+    SET_DEBUG_STACK;
+    return (int) npacket;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : EnableMagMaster
+ *
+ * Description : Hand the AK09916 over to the internal I2C master. 
+ *     SLV0 reads ST1..ST2 (9 bytes) on every sample into 
+ *     EXT_SLV_SENS_DATA_00, which directly follows TEMP_OUT_L so
+ *     one burst returns all nine axes and temperature from the 
+ *     same sample. ST2 is the last byte read which closes the 
+ *     AK09916 read cycle, as required. 
+ *
+ * Inputs : 
+ *     MagAddress - AK09916 address (0x0C)
+ *     Enable     - true for I2C master, false for bypass
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : I2C write fail
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::EnableMagMaster(uint8_t MagAddress, bool Enable)
+{
+    SET_DEBUG_STACK;
+    CLogger   *log  = CLogger::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
+    bool      rv;
+    uint8_t   c;
+
+    rv = pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x00);
+    c  = pI2C->ReadReg8( fIMU_address, USER_CTRL);
+
+    if (Enable)
+    {
+	// Bypass off, keep the interrupt mode, see InitICM20948
+	rv = rv && pI2C->WriteReg8( fIMU_address, INT_PIN_CFG, 
+				    fIntLatch ? 0x20 : 0x00);
+
+	// Bank 3, I2C master setup. 
+	rv = rv && pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x30);
+	// 345.6 kHz, the recommended master clock. Section 12.2
+	rv = rv && pI2C->WriteReg8( fIMU_address, I2C_MST_CTRL, 0x07);
+	// SLV0 read from the magnetometer starting at ST1
+	rv = rv && pI2C->WriteReg8( fIMU_address, I2C_SLV0_ADDR, 
+				    0x80 | MagAddress);
+	rv = rv && pI2C->WriteReg8( fIMU_address, I2C_SLV0_REG, AK09916_ST1);
+	rv = rv && pI2C->WriteReg8( fIMU_address, I2C_SLV0_CTRL, 
+				    0x80 | AK09916::kBlockSize);
+	rv = rv && pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x00);
+
+	// I2C_MST_EN
+	rv = rv && pI2C->WriteReg8( fIMU_address, USER_CTRL, c | 0x20);
+    }
+    else
+    {
+	rv = rv && pI2C->WriteReg8( fIMU_address, USER_CTRL, c & ~0x20);
+	rv = rv && pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x30);
+	rv = rv && pI2C->WriteReg8( fIMU_address, I2C_SLV0_CTRL, 0x00);
+	rv = rv && pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x00);
+	// Back to bypass, see InitICM20948
+	rv = rv && pI2C->WriteReg8( fIMU_address, INT_PIN_CFG, 
+				    fIntLatch ? 0x22 : 0x02);
+    }
+
+    if (rv)
+    {
+	fMagMaster = Enable;
+	fBlockSize = kSensorBlockSize + (Enable ? AK09916::kBlockSize : 0);
+	log->Log("# ICM20948 magnetometer %s\n", 
+		 Enable ? "via I2C master SLV0" : "in bypass");
+    }
+    else
+    {
+	log->LogError(__FILE__,__LINE__,'W', 
+		      "ICM20948 I2C master setup failed.\n");
+    }
+    SET_DEBUG_STACK;
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SetIntLatch
+ *
+ * Description : Select how the INT pin reports data ready. 
+ *     Latched (the InitICM20948 default) holds the pin high until 
+ *     INT_STATUS is read. Pulsed gives a 50us pulse on every sample
+ *     whether or not anyone reads the chip, which is what an edge 
+ *     triggered GPIO wait wants, samples may be skipped without 
+ *     clearing the latch and the next edge still arrives. 
+ *     The bypass setting is preserved. 
+ *
+ * Inputs : 
+ *     Latch - true to latch, false for 50us pulses
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : I2C write fail
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ICM20948::SetIntLatch(bool Latch)
+{
+    SET_DEBUG_STACK;
+    I2CBus    *pI2C = I2CBus::GetThis();
+    bool      rv;
+    uint8_t   c;
+
+    rv = pI2C->WriteReg8( fIMU_address, REG_BANK_SEL, 0x00);
+    // Bit 5 INT1_LATCH_EN, bypass (bit 1) stays as it is. 
+    c  = fMagMaster ? 0x00 : 0x02;
+    if (Latch) c |= 0x20;
+    rv = rv && pI2C->WriteReg8( fIMU_address, INT_PIN_CFG, c);
+    // Clear anything pending so the next sample gives an edge. 
+    pI2C->ReadReg8( fIMU_address, INT_STATUS_1);
+    if (rv)
+    {
+	fIntLatch = Latch;
+    }
+    SET_DEBUG_STACK;
+    return rv;
+}
+
 /**
  ******************************************************************
  *
@@ -589,7 +1210,7 @@ bool ICM20948::ICM20948SelfTest(double * destination)
     const uint8_t FS    = 0;         // Full Scale??
     const double scale  = (double)(2620/(1<<FS));
     SET_DEBUG_STACK;
-    I2CHelper *pI2C = I2CHelper::GetThis();
+    I2CBus    *pI2C = I2CBus::GetThis();
     CLogger   *pLog  = CLogger::GetThis();
 
     // Working variables
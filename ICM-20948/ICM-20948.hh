@@ -21,6 +21,13 @@
  *
  *  29-Mar-24 Checking to see that all the registers in the magnetic 
  *            subsystem are properly defined. 
+ *  17-Oct-26 Added readAll, single burst read of accel, gyro and temp. 
+ *            QueueRead/Decode for batched I2C_RDWR transactions. 
+ *            FIFO streaming, EnableFIFO/ResetFIFO/ReadFIFO. 
+ *            Bank 3, AK09916 read through the I2C master SLV0. 
+ *            SetIntLatch, pulsed INT for GPIO edge triggered reads. 
+ *            DecodeRaw/Scale, register counts for the IMURaw format. 
+ *            FIFOBusErrors. 
  *
  * Classification : Unclassified
  *
@@ -38,7 +45,8 @@
 #   include "CObject.hh"
 #   include "IMUData.hh"    // Keep all the IMU data in one class
 #   include "AK09916.hh"    // Magnetometer 
-#   include "I2CHelper.hh"
+#   include "I2CBus.hh"
+#   include "IMURaw.hh"     // Packed counts and scale factors
 
 /// Define Registers here
 // See also ICM-20948 Datasheet, Register Map and Descriptions, Revision 1.3,
@@ -150,10 +158,55 @@
 #define TEMP_CONFIG	      	0x53 
 #define MOD_CTRL_USR	       	0x54 
 
+// USER BANK 3 REGISTER MAP - SECTION 12 in manual, I2C master
+#define I2C_MST_ODR_CONFIG     	0x00
+#define I2C_MST_CTRL           	0x01
+#define I2C_MST_DELAY_CTRL     	0x02
+#define I2C_SLV0_ADDR          	0x03  // bit 7 set for read
+#define I2C_SLV0_REG           	0x04
+#define I2C_SLV0_CTRL          	0x05  // bit 7 enable, 3:0 length
+#define I2C_SLV0_DO            	0x06
+#define I2C_SLV1_ADDR          	0x07
+#define I2C_SLV1_REG           	0x08
+#define I2C_SLV1_CTRL          	0x09
+#define I2C_SLV1_DO            	0x0A
+#define I2C_SLV2_ADDR          	0x0B
+#define I2C_SLV2_REG           	0x0C
+#define I2C_SLV2_CTRL          	0x0D
+#define I2C_SLV2_DO            	0x0E
+#define I2C_SLV3_ADDR          	0x0F
+#define I2C_SLV3_REG           	0x10
+#define I2C_SLV3_CTRL          	0x11
+#define I2C_SLV3_DO            	0x12
+#define I2C_SLV4_ADDR          	0x13
+#define I2C_SLV4_REG           	0x14
+#define I2C_SLV4_CTRL          	0x15
+#define I2C_SLV4_DO            	0x16
+#define I2C_SLV4_DI            	0x17
+
 /// ICM-20948 documentation here. 
 class ICM20948 : public CObject
 {
 public:
+    /*!
+     * One accel/gyro sample recovered from the FIFO. Time is 
+     * reconstructed from the sample rate, CLOCK_REALTIME. 
+     */
+    struct FIFOSample {
+	struct timespec Time;
+	double          Acc[3];   // g
+	double          Gyro[3];  // dps
+	int16_t         RawAcc[3];  // counts, as read
+	int16_t         RawGyro[3];
+	bool            HasMag;   // Mag is valid, I2C master mode
+	uint8_t         Mag[AK09916::kBlockSize]; // ST1..ST2 raw
+    };
+
+    /*! FIFO size in bytes and accel+gyro packet size. */
+    static const size_t kFIFOSize   = 512;
+    static const size_t kFIFOPacket = 12;
+    static const size_t kFIFOMaxSamples = kFIFOSize/kFIFOPacket;
+
     /*!
      * Description:  Constructor for ICM20948, also initializes AK09916
      *               magnetometer chip. 
@@ -278,6 +331,94 @@ public:
      */
     bool readGyroData(double *XYZ);
 
+    /*!
+     * Description: 
+     *   Read ACCEL_XOUT_H through TEMP_OUT_L as one contiguous 14 byte
+     *   block in a single I2C transaction. Since the chip latches the
+     *   data registers for the duration of a burst read, all axes 
+     *   and the temperature come from the same internal sample. 
+     *
+     * Arguments:
+     *   Acc  - user supplied vector of 3, acceleration in g
+     *   Gyro - user supplied vector of 3, rate in dps
+     *   Temp - chip temperature in C
+     *
+     * Returns:
+     *    true on success
+     *
+     * Errors:
+     *    I2C read fail, the output values are left untouched.
+     *
+     */
+    bool readAll(double *Acc, double *Gyro, double *Temp);
+
+    /*!
+     * Description: 
+     *   Queue the 14 byte sensor block read onto the current 
+     *   I2CBus transaction. Call Decode after a successful Submit.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *    true if queued
+     *
+     * Errors:
+     *    transaction full
+     */
+    bool QueueRead(void);
+
+    /*!
+     * Description: 
+     *   Convert the sensor block last filled by readAll or 
+     *   QueueRead/Submit into engineering units. 
+     *
+     * Arguments:
+     *   Acc  - user supplied vector of 3, acceleration in g
+     *   Gyro - user supplied vector of 3, rate in dps
+     *   Temp - chip temperature in C
+     *
+     * Returns:
+     *    NONE
+     *
+     * Errors:
+     *    NONE
+     */
+    void Decode(double *Acc, double *Gyro, double *Temp);
+
+    /*!
+     * Description: 
+     *   Same block as Decode, left as register counts. 
+     *
+     * Arguments:
+     *   Acc  - user supplied vector of 3
+     *   Gyro - user supplied vector of 3
+     *   Temp - TEMP_OUT
+     *
+     * Returns:
+     *    NONE
+     *
+     * Errors:
+     *    NONE
+     */
+    void DecodeRaw(int16_t *Acc, int16_t *Gyro, int16_t *Temp) const;
+
+    /*!
+     * Description: 
+     *   Fill in the accel, gyro and temperature conversions for the
+     *   current full scale settings. Mag is not touched. 
+     *
+     * Arguments:
+     *   s - user supplied
+     *
+     * Returns:
+     *    NONE
+     *
+     * Errors:
+     *    NONE
+     */
+    void Scale(IMUScale *s) const;
+
     /*!
      * Description: 
      *   Run an internal test to look at how the internal settings
@@ -301,6 +442,138 @@ public:
 
     inline int32_t Address(void) const {return fIMU_address;};
 
+    /*!
+     * Description: 
+     *   Internal sample rate set by GYRO_SMPLRT_DIV. 
+     *   1.125kHz/(1+div)
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   rate in Hz
+     *
+     * Errors:
+     *   NONE
+     */
+    inline double ODR(void) const {return 1125.0/(1.0+(double)fSampleDiv);};
+
+    /*!
+     * Description: 
+     *   Turn on streaming of accel and gyro (FIFO_EN_2 0x1E) into the
+     *   FIFO at the full internal rate, or turn it off. The FIFO is
+     *   reset either way. 
+     *
+     * Arguments:
+     *   Enable - true to stream into the FIFO 
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   I2C write fail
+     */
+    bool EnableFIFO(bool Enable);
+
+    /*!
+     * Description: 
+     *   Empty the FIFO and restart the timestamp reconstruction. 
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   I2C write fail
+     */
+    bool ResetFIFO(void);
+
+    /*!
+     * Description: 
+     *   Drain the FIFO. The first transaction reads INT_STATUS_2, 
+     *   FIFO_COUNT and TEMP_OUT along with anything the caller has
+     *   already queued on the bus, the second reads every complete
+     *   packet from FIFO_R_W in one bulk read. 
+     *
+     *   Sample times are spaced by 1/ODR and kept aligned to the
+     *   host clock at the time the count is read. 
+     *
+     * Arguments:
+     *   samples - user supplied array of at least n
+     *   n       - maximum number of samples to return
+     *   Temp    - chip temperature at the time of the drain (C)
+     *
+     * Returns:
+     *   number of samples returned, 0 after an overflow, 
+     *   -1 on bus error. 
+     *
+     * Errors:
+     *   On overflow the FIFO is reset and the overflow count 
+     *   incremented. 
+     */
+    int  ReadFIFO(FIFOSample *samples, size_t n, double *Temp);
+
+    /*!
+     * Description: 
+     *   Have the internal I2C master read the AK09916 ST1..ST2 
+     *   (9 bytes) through SLV0 into EXT_SLV_SENS_DATA_00 on every 
+     *   sample. Bypass is turned off, so the AK09916 is no longer
+     *   visible on the host bus, set it up before calling this. 
+     *   The magnetometer then comes back in the same burst as
+     *   accel and gyro (MagBlock), and in the FIFO if EnableFIFO 
+     *   is called afterwards. 
+     *
+     * Arguments:
+     *   MagAddress - address of the AK09916 on the auxiliary bus
+     *   Enable     - true for master mode, false to go back to bypass
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   I2C write fail
+     */
+    bool EnableMagMaster(uint8_t MagAddress, bool Enable);
+
+    /*! true if the AK09916 is read by the I2C master. */
+    inline bool MagMaster(void) const {return fMagMaster;};
+
+    /*!
+     * Description: 
+     *   Choose latched (INT high until INT_STATUS is read) or 50us
+     *   pulsed data ready on the INT pin. Pulsed suits an edge
+     *   triggered wait that does not read every sample. 
+     *
+     * Arguments:
+     *   Latch - true latched, false pulsed
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   I2C write fail
+     */
+    bool SetIntLatch(bool Latch);
+
+    /*!
+     * ST1..ST2 block from the last readAll or QueueRead/Submit, 
+     * NULL if not in I2C master mode. 
+     */
+    inline const uint8_t* MagBlock(void) const 
+	{return fMagMaster ? &fBlock[kSensorBlockSize] : NULL;};
+
+    /*! TEMP_OUT counts read with the last ReadFIFO */
+    inline int16_t FIFOTemp(void) const 
+	{return (int16_t)(((uint16_t)fFIFOStatus[3] << 8) | fFIFOStatus[4]);};
+
+    /*! Number of FIFO overflows seen since EnableFIFO */
+    inline uint32_t FIFOOverflows(void) const {return fFIFOOverflows;};
+
+    /*! Number of ReadFIFO bus errors since EnableFIFO */
+    inline uint32_t FIFOBusErrors(void) const {return fFIFOBusErrors;};
+
 
 protected:
 
@@ -358,6 +631,41 @@ private:
     int32_t   fIMUAddress;
     int16_t   itemp;
 
+    /*!
+     * Number of bytes from ACCEL_XOUT_H through TEMP_OUT_L inclusive. 
+     */
+    static const size_t kSensorBlockSize = 14;
+
+    /*!
+     * Sensor block plus EXT_SLV_SENS_DATA when the I2C master is 
+     * reading the magnetometer, they are contiguous. 
+     */
+    uint8_t   fBlock[kSensorBlockSize + AK09916::kBlockSize];
+    size_t    fBlockSize;
+    bool      fMagMaster;
+    bool      fIntLatch;               // INT_PIN_CFG INT1_LATCH_EN
+    size_t    fFIFOPacketSize;          // 12, or 21 with the mag
+
+    /*! GYRO_SMPLRT_DIV and ACCEL_SMPLRT_DIV setting. */
+    uint8_t   fSampleDiv;
+
+    /* FIFO streaming state. */
+    uint8_t   fFIFOStatus[5];          // INT_STATUS_2, COUNTH/L, TEMP H/L
+    uint8_t   fFIFOData[kFIFOSize];
+    bool      fFIFOSync;               // fFIFOLast is valid
+    int64_t   fFIFOLast;               // time of last sample returned, ns
+    uint32_t  fFIFOOverflows;
+    uint32_t  fFIFOBusErrors;
+
+    /*!
+     * Convert the raw temperature counts to C
+     */
+    double ConvertTemp(int16_t counts) const;
+
+    /*! TEMP_OUT offset (LSB) and sensitivity (LSB/C), see ConvertTemp */
+    static constexpr double kRoomTempOffset  = 40.0;
+    static constexpr double kTempSensitivity = 333.87;
+
     /*!
      * Setup the primary registers on the IMU unit.
      * Also open the I2C channel
@@ -12,6 +12,29 @@
  * Change Descriptions : 
  * 20-Dec-23   CBL   was not changing filenames on the chosen interval. 
  * 27-Apr-26   CBL   put the I2C bus definition into the cfg file. 
+ * 17-Oct-26   CBL   single burst read of accel/gyro/temp.
+ * 17-Oct-26   CBL   accel/gyro/temp/mag in one I2C_RDWR per sample.
+ * 17-Oct-26   CBL   Simulate option selects the I2CSim backend,
+ *                   throughput summary at the end of Do.
+ * 17-Oct-26   CBL   FIFO streaming mode. 
+ * 17-Oct-26   CBL   MagMaster, AK09916 through the ICM I2C master.
+ * 17-Oct-26   CBL   GPIOChip/GPIOLine, wait on the data ready edge.
+ * 17-Oct-26   CBL   Absolute deadlines instead of a relative sleep, 
+ *                   lateness statistics into IMU_Jitter. 
+ * 17-Oct-26   CBL   HDF5 writes and file changes on a logger thread.
+ * 17-Oct-26   CBL   RealTime profile applied at the start of Do.
+ * 17-Oct-26   CBL   Samples kept as IMURaw counts, converted to
+ *                   engineering units only where needed. RawLog
+ *                   writes the counts with IMURawLogger. 
+ * 17-Oct-26   CBL   Sample rate to the registry through fIPC. 
+ * 17-Oct-26   CBL   SimReadLast, I2CSim refuses reads before the last
+ *                   message, as the Pi's i2c-bcm2835 does. 
+ * 17-Oct-26   CBL   Failed sample reads counted in fReadErrors, the
+ *                   first logged with errno. 
+ * 17-Oct-26   CBL   FIFO overflows and bus errors in the summary. 
+ * 17-Oct-26   CBL   RawLog rows carry the GGA position again. 
+ * 17-Oct-26   CBL   fChangeFile taken with exchange, samples with no
+ *                   file open counted in fNoFile and logged. 
  *
  * Classification : Unclassified
  *
@@ -25,6 +48,7 @@
 using namespace std;
 
 #include <string>
+#include <cstring>
 #include <cmath>
 #include <csignal>
 #include <ctime>
@@ -45,10 +69,15 @@ using namespace libconfig;
 #include "tools.h"
 #include "debug.h"
 #include "H5Logger.hh"
+#include "IMURawLogger.hh"
 #include "ICM-20948.hh"
 #include "filename.hh"
 #include "smIPC.hh"
 #include "I2CHelper.hh"
+#include "I2CSim.hh"
+#include "GPIOInterrupt.hh"
+#include "LoopTimer.hh"
+#include "RealTime.hh"
 
 #define SM_IPC 1
 
@@ -84,13 +113,35 @@ IMU::IMU(const char* ConfigFile) : CObject(), IMUData()
     SetError(); // No error.
 
     fRun         = true;
+    fI2C         = NULL;
+    fSimulate    = false;
+    fSimReadLast = true;
+    fFIFO        = false;
+    fMagMaster   = false;
+    fDRDY        = NULL;
+    fLoop        = NULL;
+    fRT          = new RealTime();
+    fGPIOLine    = 0;
+    fDecimate    = 1;
+    fNEdge       = 0;
+    fDRDYTimeout = 1000;
     fICM20948    = NULL;
     fAK09916     = NULL;
     fIPC         = NULL;
     fSampleRate  = 1;     // 1 Hz
     fNSamples    = 10;    // 10 samples
     f5Logger     = NULL;
+    fRawLogger   = NULL;
+    fRawLog      = false;
     fn           = NULL;
+    fChangeFile  = false;
+    fWriterStarted = false;
+    fWriterRun   = false;
+    fLogDropped  = 0;
+    fReadErrors  = 0;
+    fNoFile      = 0;
+    memset(&fRaw,   0, sizeof(fRaw));
+    memset(&fScale, 0, sizeof(fScale));
 
 
     time_t     t = time(NULL);
@@ -141,6 +192,17 @@ IMU::IMU(const char* ConfigFile) : CObject(), IMUData()
 #else
     fIPC = 0;
 #endif
+    if (fIPC)
+    {
+	fIPC->UpdateScale(fScale);
+	fIPC->SetRate((double) fSampleRate);
+    }
+
+    /* Logger thread last, it uses fIPC for the file name. */
+    if (f5Logger || fRawLogger)
+    {
+	StartWriter();
+    }
 
     Logger->Log("# IMU constructed.\n");
 
@@ -175,9 +237,14 @@ IMU::~IMU(void)
     SET_DEBUG_STACK;
     CLogger *Logger = CLogger::GetThis();
 
+    /* Everything queued goes to disk before the file is closed. */
+    StopWriter();
+
     /* Clean up do this first, may fix issues with closing file. */
     delete f5Logger;
     f5Logger = NULL;
+    delete fRawLogger;
+    fRawLogger = NULL;
 
     // Do some other stuff as well. 
     if(!WriteConfiguration())
@@ -188,6 +255,9 @@ IMU::~IMU(void)
     }
     free(fConfigFileName);
 
+    delete fDRDY;
+    delete fLoop;
+    delete fRT;
     delete fI2C;
     delete fAK09916;
     delete fICM20948;
@@ -204,8 +274,9 @@ IMU::~IMU(void)
  *
  * Function Name : UpdateFileName
  *
- * Description : Flush and close current log file, update the name, 
- *               and reopen.
+ * Description : Request a new log file. The logger thread flushes
+ *               and closes the current file, updates the name, 
+ *               and reopens between samples. 
  *
  * Inputs : NONE
  *
@@ -221,25 +292,290 @@ IMU::~IMU(void)
  *******************************************************************
  */
 void IMU::UpdateFileName(void)
+{
+    fChangeFile = true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : StartWriter
+ *
+ * Description : Start the logger thread. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : 
+ *     pthread_create fails, samples are then queued but never
+ *     written, this is logged. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool IMU::StartWriter(void)
 {
     SET_DEBUG_STACK;
-    /*
-     * flush and close existing file
-     * get a new unique filename
-     * reset the timer
-     * and go!
-     *
-     * Check to see that logging is enabled. 
-     */
-    if(f5Logger)
+    CLogger *Logger = CLogger::GetThis();
+
+    fWriterRun = true;
+    if (pthread_create(&fWriter, NULL, WriterThread, this) == 0)
     {
-	// This will close and flush the existing logfile. 
-	delete f5Logger;
-	f5Logger = NULL;
-	// Now reopen
-	OpenLogFile();
+	fWriterStarted = true;
+	Logger->Log("# Logger thread successfully created.\n");
+    }
+    else
+    {
+	fWriterRun = false;
+	Logger->LogError(__FILE__,__LINE__,'W', 
+			 "Logger thread failed.\n");
+    }
+    SET_DEBUG_STACK;
+    return fWriterStarted;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : StopWriter
+ *
+ * Description : Tell the logger thread to finish what is queued 
+ *               and wait for it. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU::StopWriter(void)
+{
+    SET_DEBUG_STACK;
+    if (fWriterStarted)
+    {
+	fWriterRun = false;
+	pthread_join(fWriter, NULL);
+	fWriterStarted = false;
+	CLogger::GetThis()->Log("# Logger thread stopped, %llu samples dropped, %llu with no file open.\n",
+				(unsigned long long) fLogDropped,
+				(unsigned long long) fNoFile);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WriterThread
+ *
+ * Description : pthread entry point, arg is the IMU. 
+ *
+ * Inputs : arg - IMU pointer
+ *
+ * Returns : NULL
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void* IMU::WriterThread(void *arg)
+{
+    ((IMU *) arg)->Writer();
+    return NULL;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Writer
+ *
+ * Description : 
+ *    Logger thread. Empty the queue into the HDF5 file, then sleep
+ *    a little. File changes, on the logging interval or when asked
+ *    for, happen here so a slow close/open only backs up the queue.
+ *    On stop the queue is drained before returning. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU::Writer(void)
+{
+    SET_DEBUG_STACK;
+    const struct timespec Idle = {0L, 10000000L};  // 10ms
+    IMURaw    Batch[kWriteBatch];
+    IMURawPosition Pos;
+    size_t    i, n, total;
+    bool      Run;
+
+    CLogger::GetThis()->LogTime("Logger thread starts.\n");
+    do
+    {
+	// Read the flag first so nothing pushed before Stop is missed.
+	Run = fWriterRun;
+
+	/* Check to see if the logging interval has rolled over. */
+	if (fChangeFile.exchange(false) || (fn && fn->ChangeNames()))
+	{
+	    // This will close and flush the existing logfile. 
+	    delete f5Logger;
+	    f5Logger = NULL;
+	    delete fRawLogger;
+	    fRawLogger = NULL;
+	    // Now reopen
+	    if (!OpenLogFile())
+	    {
+		CLogger::GetThis()->Log("# Logger has no file, samples are discarded until the next change.\n");
+	    }
+	}
+
+	total = 0;
+	do
+	{
+	    for (n=0; (n<kWriteBatch) && fLogQueue.Pop(Batch[n]); n++);
+	    if (fRawLogger && (n > 0))
+	    {
+		GetPosition(&Pos);
+		fRawLogger->Append(Batch, n, Pos);
+	    }
+	    else if (f5Logger)
+	    {
+		for (i=0;i<n;i++)
+		{
+		    LogSI(Batch[i]);
+		}
+	    }
+	    else
+	    {
+		// Popped anyway so the acquisition never blocks. 
+		fNoFile += n;
+	    }
+	    total += n;
+	} while (n == kWriteBatch);
+
+	if ((total == 0) && Run)
+	{
+	    nanosleep(&Idle, NULL);
+	}
+    } while (Run);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : GetPosition
+ *
+ * Description : Latest GGA from GTOP through fIPC, the Lat, Lon, Z
+ *     and UTC columns of both logs. 
+ *
+ * Inputs : Pos - filled in, zero if there is no position
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU::GetPosition(IMURawPosition *Pos)
+{
+    GGA    *pGGA = NULL;
+
+    if (fIPC)
+    {
+	pGGA = fIPC->GetPosition();
     }
+    if (pGGA)
+    {
+	Pos->Lat = pGGA->Latitude()*RadToDeg;
+	Pos->Lon = pGGA->Longitude()*RadToDeg;
+	Pos->Z   = pGGA->Altitude();
+	Pos->UTC = pGGA->UTC();
+    }
+    else
+    {
+	Pos->Lat = 0.0;
+	Pos->Lon = 0.0;
+	Pos->Z   = 0.0;
+	Pos->UTC = 0.0;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : LogSI
+ *
+ * Description : One row of the double H5Logger file, the sample in
+ *     engineering units and the GPS position. The position is read
+ *     here on the logger thread, it is the latest at write time, 
+ *     tens of ms after the sample at most. 
+ *
+ * Inputs : r - sample
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU::LogSI(const IMURaw &r)
+{
     SET_DEBUG_STACK;
+    IMURawPosition Pos;
+    double Var[kNVar];
+    size_t i;
+
+    Var[0] = (double) r.Time * 1.0e-9;
+    IMURawToSI(r, fScale, &Var[1], &Var[4], &Var[7], &Var[10]);
+
+    GetPosition(&Pos);
+    Var[11] = Pos.Lat;
+    Var[12] = Pos.Lon;
+    Var[13] = Pos.Z;
+    Var[14] = Pos.UTC;
+
+    for (i=0;i<kNVar;i++)
+    {
+	f5Logger->FillInternalVector(Var[i], i);
+    }
+    f5Logger->Fill();
 }
 
 /**
@@ -265,56 +601,325 @@ void IMU::UpdateFileName(void)
 void IMU::Do(void)
 {
     SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
     fRun = true;
-    int32_t i = 0;
+    int32_t  i = 0;
+    bool     rc;
+    I2CBus   *pI2C = I2CBus::GetThis();
+    uint64_t NSample = 0;
+    uint32_t Drained;
+    uint64_t NTransaction = pI2C->Transactions();
+    struct timespec Start, End;
+    double   dt;
+    LoopStats Stats;
+    uint32_t NPublish;
+    int16_t  Acc[3], Gyro[3], Mag[3], Temp;
+
+    /*
+     * Deadlines on a fixed grid, so the time taken to read, log and
+     * reopen files does not stretch the period. Publish the jitter
+     * statistics about once a second. 
+     */
+    /*
+     * Acquisition thread only, the logger thread was started in the
+     * constructor and keeps the normal policy. 
+     */
+    fRT->Apply();
+
+    delete fLoop;
+    fLoop = new LoopTimer(fSampleTime);
+    fLoop->Stats(&Stats);
+    NPublish = (uint32_t) ceil(1.0/Stats.Period);
+    if (NPublish < 1) NPublish = 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &Start);
+    fLoop->Start();
 
     /*
      * if fNSamples is negative, means infinite.
      */
     do 
     {
-	if (fn)
+	// File changes are up to the logger thread. 
+	if (fFIFO)
+	{
+	    // Every sample taken since the last drain. 
+	    Drained  = DrainFIFO();
+	}
+	else if (!WaitDRDY())
+	{
+	    // Edge seen, not one we keep. 
+	    Drained = 0;
+	}
+	else
+	{
+	    /* Read everything. */
+	    if (!fDRDY)
+		clock_gettime(CLOCK_REALTIME, &fReadTime);
+	    fReadTime.tv_sec -= fGMTOffset;
+
+	    /*
+	     * Assume if we got this far, fICM20948 pointer is valid
+	     * Queue the accel/gyro/temp block and the magnetometer 
+	     * ST1..ST2 block and hand them to the kernel as one 
+	     * I2C_RDWR, one system call per sample. With the I2C 
+	     * master the magnetometer is part of the ICM block. 
+	     */
+	    pI2C->BeginTransaction();
+	    fICM20948->QueueRead();
+	    if (fAK09916 && !fMagMaster)
+	    {
+		fAK09916->QueueRead();
+	    }
+	    rc = pI2C->Submit();
+	    if (rc)
+	    {
+		// Aligned copies, fRaw is packed. 
+		fICM20948->DecodeRaw(Acc, Gyro, &Temp);
+		memcpy(fRaw.Acc,  Acc,  sizeof(fRaw.Acc));
+		memcpy(fRaw.Gyro, Gyro, sizeof(fRaw.Gyro));
+		fRaw.Temp  = Temp;
+		fRaw.Flags = 0;
+		if (fAK09916)
+		{
+		    // In master mode it came back in the ICM burst, 
+		    // MagBlock is NULL otherwise. 
+		    if (fAK09916->DecodeRaw(fICM20948->MagBlock(), Mag))
+			fRaw.Flags |= kRawMagNew;
+		    if (fAK09916->Error())
+			fRaw.Flags |= kRawMagOverflow;
+		    memcpy(fRaw.Mag, Mag, sizeof(fRaw.Mag));
+		}
+		RawToData();
+	    }
+	    else
+	    {
+		// Counted, the first one says why. 
+		if (fReadErrors++ == 0)
+		{
+		    Logger->LogTime(" IMU::Do sample read failed, %s\n",
+				    strerror(pI2C->LastErrno()));
+		}
+	    }
+
+	    // Don't log stale data if the bus read failed. 
+	    if (fn && rc) 
+		Update();
+
+	    if (fDebug>0)
+		cout << *this;
+
+	    Drained = rc ? 1 : 0;
+	}
+	NSample += Drained;
+	// The edge wait paces the loop when it is active. 
+	if (fFIFO || !fDRDY)
 	{
-	    /* Check to see if the logging interval has rolled over. */
-	    if (fn->ChangeNames())
+	    fLoop->Wait();
+	    fLoop->Stats(&Stats);
+	    if (Stats.N >= NPublish)
 	    {
-		UpdateFileName();
+		if (fIPC)
+		    fIPC->UpdateJitter(Stats);
+		fLoop->ResetWindow();
 	    }
 	}
+	if (fNSamples>0)
+	{
+	    i += Drained;
+	    if (i>fNSamples) fRun = false;
+	}
+	
+    } while (fRun);
 
+    /* Throughput summary, useful with the simulator. */
+    clock_gettime(CLOCK_MONOTONIC, &End);
+    dt = (double)(End.tv_sec - Start.tv_sec) + 
+	1.0e-9 * (double)(End.tv_nsec - Start.tv_nsec);
+    NTransaction = pI2C->Transactions() - NTransaction;
+    Logger->Log("# IMU::Do %llu samples in %.3f s, %.1f samples/s, %llu bus transactions\n",
+		(unsigned long long) NSample, dt, 
+		(dt>0.0) ? (double) NSample/dt : 0.0,
+		(unsigned long long) NTransaction);
+    if (fReadErrors > 0)
+    {
+	Logger->Log("# IMU::Do %llu sample reads failed on the bus\n",
+		    (unsigned long long) fReadErrors);
+    }
+    if (fFIFO)
+    {
+	Logger->Log("# IMU::Do %u FIFO overflows, %u FIFO bus errors\n",
+		    fICM20948->FIFOOverflows(), fICM20948->FIFOBusErrors());
+    }
+    fLoop->Stats(&Stats);
+    if (fLoop->Wakeups() > 0)
+    {
+	Logger->Log("# IMU::Do period %.6f s, %u overruns, %u slots skipped, max lateness %.1f us\n",
+		    Stats.Period, Stats.Overruns, Stats.Skipped,
+		    1.0e6*fLoop->MaxLateness());
+    }
+    if (fLogDropped > 0)
+    {
+	Logger->Log("# IMU::Do %llu samples dropped, logger queue full\n",
+		    (unsigned long long) fLogDropped);
+    }
+    if (fDRDY)
+    {
+	Logger->Log("# IMU::Do %llu data ready edges, %llu missed, %llu timeouts\n",
+		    (unsigned long long) fDRDY->Events(),
+		    (unsigned long long) fDRDY->Missed(),
+		    (unsigned long long) fDRDY->Timeouts());
+    }
+    SET_DEBUG_STACK;
+}
 
-	/* Read everything. */
+/**
+ ******************************************************************
+ *
+ * Function Name : WaitDRDY
+ *
+ * Description : 
+ *    Block until the ICM signals data ready on the INT pin and 
+ *    decide whether this sample is read. fReadTime is set to the 
+ *    edge time, which is within microseconds of when the sample 
+ *    was latched. If no edge arrives in fDRDYTimeout the read goes
+ *    ahead anyway so a dead line degrades to timed polling. 
+ *    Without a GPIO this always says read. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : true to read the sensor now. 
+ *
+ * Error Conditions : 
+ *    read error on the line, the GPIO is dropped and the loop 
+ *    falls back to nanosleep. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool IMU::WaitDRDY(void)
+{
+    SET_DEBUG_STACK;
+    int n;
 
-	clock_gettime(CLOCK_REALTIME, &fReadTime);
-	fReadTime.tv_sec -= fGMTOffset;
+    if (!fDRDY)
+	return true;
 
-	// Assume if we got this far, fICM20948 pointer is valid
-	fTemp = fICM20948->readTempData();
-	fICM20948->readAccelData(fAcc);
-	fICM20948->readGyroData(fGyro);
+    n = fDRDY->Wait(fDRDYTimeout, &fReadTime);
+    if (n > 0)
+    {
+	fNEdge += n;
+	if (fNEdge < fDecimate)
+	    return false;
+	fNEdge = 0;
+	return true;
+    }
 
-	if (fAK09916)
+    if (n == 0)
+    {
+	if (fDRDY->Timeouts() == 1)
 	{
-	    fAK09916->DRead(fMagXYZ);
+	    CLogger::GetThis()->LogError(__FILE__,__LINE__,'W',
+			 "No data ready edge, reading on timeout.\n");
 	}
+    }
+    else
+    {
+	CLogger::GetThis()->LogError(__FILE__,__LINE__,'W',
+			 "Data ready GPIO failed, timed polling.\n");
+	delete fDRDY;
+	fDRDY = NULL;
+    }
+    clock_gettime(CLOCK_REALTIME, &fReadTime);
+    SET_DEBUG_STACK;
+    return true;
+}
 
-	if (fn) 
-	    Update();
+/**
+ ******************************************************************
+ *
+ * Function Name : DrainFIFO
+ *
+ * Description : 
+ *    Read everything in the ICM FIFO and process each sample. 
+ *    The magnetometer read rides along in the FIFO status 
+ *    transaction, its latest value is used for all the samples. 
+ *    With the I2C master each FIFO packet carries its own. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : number of samples processed
+ *
+ * Error Conditions : bus error or FIFO overflow, returns 0
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t IMU::DrainFIFO(void)
+{
+    SET_DEBUG_STACK;
+    I2CBus   *pI2C = I2CBus::GetThis();
+    ICM20948::FIFOSample Samples[ICM20948::kFIFOMaxSamples];
+    int      n, i;
+    uint16_t MagFlags = 0;
+    int16_t  Mag[3];
 
-	if (fDebug>0)
-	    cout << *this;
+    pI2C->BeginTransaction();
+    if (fAK09916 && !fMagMaster)
+    {
+	fAK09916->QueueRead();
+    }
+    n = fICM20948->ReadFIFO(Samples, ICM20948::kFIFOMaxSamples, &fTemp);
+    if (n < 0)
+    {
+	SET_DEBUG_STACK;
+	return 0;
+    }
+    fRaw.Temp = fICM20948->FIFOTemp();
+    if (fAK09916 && !fMagMaster)
+    {
+	if (fAK09916->DecodeRaw(NULL, Mag))
+	    MagFlags |= kRawMagNew;
+	if (fAK09916->Error())
+	    MagFlags |= kRawMagOverflow;
+	memcpy(fRaw.Mag, Mag, sizeof(fRaw.Mag));
+    }
 
-	nanosleep(&fSampleTime, NULL);
-	if (fNSamples>0)
+    for (i=0;i<n;i++)
+    {
+	fReadTime         = Samples[i].Time;
+	fReadTime.tv_sec -= fGMTOffset;
+	memcpy(fRaw.Acc,  Samples[i].RawAcc,  sizeof(fRaw.Acc));
+	memcpy(fRaw.Gyro, Samples[i].RawGyro, sizeof(fRaw.Gyro));
+	if (fAK09916 && Samples[i].HasMag)
 	{
-	    i++;
-	    if (i>fNSamples) fRun = false;
+	    MagFlags = 0;
+	    if (fAK09916->DecodeRaw(Samples[i].Mag, Mag))
+		MagFlags |= kRawMagNew;
+	    if (fAK09916->Error())
+		MagFlags |= kRawMagOverflow;
+	    memcpy(fRaw.Mag, Mag, sizeof(fRaw.Mag));
 	}
-	
-    } while (fRun);
+	fRaw.Flags = kRawFIFO | MagFlags;
+	// A bypass read is fresh for the first sample only. 
+	MagFlags &= ~kRawMagNew;
+	RawToData();
+	if (fn)
+	    Update();
+	if (fDebug>1)
+	    cout << *this;
+    }
     SET_DEBUG_STACK;
+    return (uint32_t) n;
 }
-
 /**
  ******************************************************************
  *
@@ -322,7 +927,7 @@ void IMU::Do(void)
  *
  * Description :
  *    Update the data in the IPC if active
- *    If Logger is enabled, log the data. 
+ *    If Logger is enabled, queue the data for the logger thread. 
  *
  * Inputs : NONE
  *
@@ -340,51 +945,56 @@ void IMU::Do(void)
 void IMU::Update(void)
 {
     SET_DEBUG_STACK;
-    GGA *pGGA = NULL;
+
+    fRaw.Time = (uint64_t) fReadTime.tv_sec * 1000000000ULL + 
+	(uint64_t) fReadTime.tv_nsec;
 
     // Do IPC
     if (fIPC)
     {
     	fIPC->Update();
-	pGGA = fIPC->GetPosition();
+	fIPC->UpdateRaw(fRaw);
     }
 
-    // Any user code or logging belongs here. 
-    if (f5Logger!=NULL)
-    {
-
-	double t = (double) fReadTime.tv_sec + 
-	    (double)fReadTime.tv_nsec*1.0e-9;
-	f5Logger->FillInternalVector( t,             0);
-	f5Logger->FillInternalVector(  fAcc[0],      1);
-	f5Logger->FillInternalVector(  fAcc[1],      2);
-	f5Logger->FillInternalVector(  fAcc[2],      3);
-	f5Logger->FillInternalVector(  fGyro[0],     4);
-	f5Logger->FillInternalVector(  fGyro[1],     5);
-	f5Logger->FillInternalVector(  fGyro[2],     6);
-	f5Logger->FillInternalVector(  fMagXYZ[0],   7);
-	f5Logger->FillInternalVector(  fMagXYZ[1],   8);
-	f5Logger->FillInternalVector(  fMagXYZ[2],   9);
-	f5Logger->FillInternalVector(  fTemp,       10);
-	if (pGGA)
-	{
-	    f5Logger->FillInternalVector(pGGA->Latitude()*RadToDeg, 11);
-	    f5Logger->FillInternalVector(pGGA->Longitude()*RadToDeg, 12);
-	    f5Logger->FillInternalVector(pGGA->Altitude(), 13);
-	    f5Logger->FillInternalVector(pGGA->UTC(), 14);
-	}
-	else
+    /*
+     * Any user code or logging belongs here. Never wait on the disk
+     * from here, hand the sample to the logger thread, if it is 
+     * behind drop it and count it. 
+     */
+    if (fWriterStarted)
+    {
+	if (!fLogQueue.Push(fRaw))
 	{
-	    f5Logger->FillInternalVector(0.0, 11);
-	    f5Logger->FillInternalVector(0.0, 12);
-	    f5Logger->FillInternalVector(0.0, 13);
-	    f5Logger->FillInternalVector(0.0, 14);
+	    fLogDropped++;
 	}
-
-	f5Logger->Fill();
     }    
     SET_DEBUG_STACK;
 } 
+/**
+ ******************************************************************
+ *
+ * Function Name : RawToData
+ *
+ * Description : Engineering units for the IMUData members, the
+ *     legacy IMU shared memory segment and the debug print. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU::RawToData(void)
+{
+    IMURawToSI(fRaw, fScale, fAcc, fGyro, fMagXYZ, &fTemp);
+}
 /**
  ******************************************************************
  *
@@ -418,15 +1028,29 @@ bool IMU::OpenLogFile(void)
     fn->NewUpdateTime();
     SET_DEBUG_STACK;
 
-    f5Logger = new H5Logger(name,"IMU Dataset", kNVar, false);
-    if (f5Logger->CheckError())
+    if (fRawLog)
     {
-	pLogger->Log("# Failed to open H5 log file: %s\n", name);
-	delete f5Logger;
-	f5Logger = NULL;
-	return false;
+	fRawLogger = new IMURawLogger(name, fScale, "IMU raw dataset");
+	if (fRawLogger->CheckError())
+	{
+	    pLogger->Log("# Failed to open H5 log file: %s\n", name);
+	    delete fRawLogger;
+	    fRawLogger = NULL;
+	    return false;
+	}
+    }
+    else
+    {
+	f5Logger = new H5Logger(name,"IMU Dataset", kNVar, false);
+	if (f5Logger->CheckError())
+	{
+	    pLogger->Log("# Failed to open H5 log file: %s\n", name);
+	    delete f5Logger;
+	    f5Logger = NULL;
+	    return false;
+	}
+	f5Logger->WriteDataTags(Names);
     }
-    f5Logger->WriteDataTags(Names);
 
     /* Log that this was done in the local text log file. */
     time_t now;
@@ -443,8 +1067,6 @@ bool IMU::OpenLogFile(void)
     {
  	fIPC->UpdateFilename(name);
     }
-    
-    fChangeFile = false;
 
     return true;
 }
@@ -573,6 +1195,14 @@ bool IMU::ReadConfiguration(void)
 	MM.lookupValue("SampleRate",    fSampleRate);
 	MM.lookupValue("NumberSamples", fNSamples);
 	MM.lookupValue("I2Cdev",        fICMDeviceName);
+	MM.lookupValue("Simulate",      fSimulate);
+	MM.lookupValue("SimReadLast",   fSimReadLast);
+	MM.lookupValue("FIFO",          fFIFO);
+	MM.lookupValue("MagMaster",     fMagMaster);
+	MM.lookupValue("GPIOChip",      fGPIOChip);
+	MM.lookupValue("GPIOLine",      fGPIOLine);
+	MM.lookupValue("RawLog",        fRawLog);
+	fRT->ReadConfiguration(MM);
 	
 	double ival;
 	double Period = 1.0/((double) fSampleRate);
@@ -591,7 +1221,16 @@ bool IMU::ReadConfiguration(void)
 
     // Configuration read, setup devices. 
     // Initialize I2C subsystem. 
-    fI2C = new I2CHelper(fICMDeviceName.c_str());
+    if (fSimulate)
+    {
+	I2CSim *Sim = new I2CSim(IMUAddress, MagAddress);
+	Sim->SetReadLast(fSimReadLast);
+	fI2C = Sim;
+    }
+    else
+    {
+	fI2C = new I2CHelper(fICMDeviceName.c_str());
+    }
     if (fI2C->Error())
     {
 	Logger->Log("# FAIL ON to open I2C %s.\n", fICMDeviceName.c_str());
@@ -612,8 +1251,11 @@ bool IMU::ReadConfiguration(void)
 
     /*
      * Second argument is the mode to acquire data. 
+     * The I2C master reads it every ICM sample (225Hz) so run the
+     * magnetometer at its fastest in that case. 
      */
-    fAK09916 = new AK09916(MagAddress, AK09916::kM_10HZ);
+    fAK09916 = new AK09916(MagAddress, 
+			   fMagMaster ? AK09916::kM_100HZ : AK09916::kM_10HZ);
     if(fAK09916->Error())
     {
 	Logger->Log("# FAIL ON AK09916 setup.\n");
@@ -625,7 +1267,72 @@ bool IMU::ReadConfiguration(void)
 
 	return false;
     }
-    Logger->Log("# Mag sensor mode: %X\n", AK09916::kM_10HZ);
+    Logger->Log("# Mag sensor mode: %X\n", fAK09916->Mode());
+
+    /*
+     * From here on the AK09916 is only reachable through the ICM,
+     * must come before the FIFO setup so SLV0 goes into the FIFO. 
+     */
+    if (fMagMaster && !fICM20948->EnableMagMaster(MagAddress, true))
+    {
+	Logger->Log("# FAIL ON I2C master setup.\n");
+	return false;
+    }
+
+    /*
+     * FIFO streaming. The FIFO holds 512/12 = 42 samples, 187ms at
+     * 225Hz. Drain at 20Hz so there is plenty of margin, SampleRate
+     * no longer sets the data rate in this mode. 
+     */
+    if (fFIFO)
+    {
+	if (!fICM20948->EnableFIFO(true))
+	{
+	    Logger->Log("# FAIL ON FIFO setup.\n");
+	    return false;
+	}
+	fSampleTime.tv_sec  = 0;
+	fSampleTime.tv_nsec = 50000000L;
+	Logger->Log("# FIFO mode, drain every 50ms.\n");
+    }
+
+    /*
+     * Data ready on the INT pin. Switch the pin to 50us pulses so an
+     * edge arrives every sample whether or not it is read, then only
+     * read every fDecimate'th to keep SampleRate. Any problem here 
+     * just leaves us with timed polling. 
+     */
+    if (!fGPIOChip.empty())
+    {
+	if (fFIFO)
+	{
+	    Logger->Log("# FIFO mode, GPIO %s not used.\n", fGPIOChip.c_str());
+	}
+	else
+	{
+	    fDRDY = new GPIOInterrupt(fGPIOChip.c_str(), fGPIOLine);
+	    if (fDRDY->Error() || !fICM20948->SetIntLatch(false))
+	    {
+		Logger->Log("# No data ready GPIO, timed polling.\n");
+		delete fDRDY;
+		fDRDY = NULL;
+	    }
+	    else
+	    {
+		fDecimate = (uint32_t) lround(fICM20948->ODR()/
+					      (double) fSampleRate);
+		if (fDecimate < 1) fDecimate = 1;
+		// Two missed sample periods.
+		fDRDYTimeout = 2000/fSampleRate + 10;
+		Logger->Log("# Data ready on %s line %d, read 1 in %u.\n",
+			    fGPIOChip.c_str(), fGPIOLine, fDecimate);
+	    }
+	}
+    }
+
+    /* Conversions for the IMURaw counts, fixed from here on. */
+    fICM20948->Scale(&fScale);
+    fScale.Mag = fAK09916->getMres();
 
     SET_DEBUG_STACK;
     return true;
@@ -681,6 +1388,14 @@ bool IMU::WriteConfiguration(void)
     MM.add("SampleRate", Setting::TypeInt)     = (int) fSampleRate;
     MM.add("NumberSamples", Setting::TypeInt)  = (int) fNSamples;
     MM.add("I2Cdev",     Setting::TypeString)  = fICMDeviceName;
+    MM.add("Simulate",   Setting::TypeBoolean) = fSimulate;
+    MM.add("SimReadLast", Setting::TypeBoolean) = fSimReadLast;
+    MM.add("FIFO",       Setting::TypeBoolean) = fFIFO;
+    MM.add("MagMaster",  Setting::TypeBoolean) = fMagMaster;
+    MM.add("GPIOChip",   Setting::TypeString)  = fGPIOChip;
+    MM.add("GPIOLine",   Setting::TypeInt)     = (int) fGPIOLine;
+    MM.add("RawLog",     Setting::TypeBoolean) = fRawLog;
+    fRT->WriteConfiguration(MM);
 
     // Write out the new configuration.
     try
@@ -13,6 +13,15 @@
  * 30-Mar-24 moved I2C and mag sensor to this level. 
  * 08-Sep-25 CBL put in ability to force a log filename change. 
  * 27-Apr-26 Moved the declaration of the I2C bus to the cfg file. 
+ * 17-Oct-26 CBL GPIOChip/GPIOLine, read on the data ready edge. 
+ * 17-Oct-26 CBL Absolute deadline loop timing, LoopTimer. 
+ * 17-Oct-26 CBL HDF5 logging on its own thread, fed by an SPSC ring. 
+ * 17-Oct-26 CBL RealTime profile from the configuration. 
+ * 17-Oct-26 CBL IMURaw counts through the queue, RawLog option. 
+ * 17-Oct-26 CBL SimReadLast. 
+ * 17-Oct-26 CBL fReadErrors. 
+ * 17-Oct-26 CBL GetPosition, shared by both logs. 
+ * 17-Oct-26 CBL fChangeFile atomic, fNoFile. 
  *
  * Classification : Unclassified
  *
@@ -25,16 +34,25 @@
 #define __IMU_hh_
 #  include <stdint.h>
 #  include <string>
+#  include <atomic>
+#  include <pthread.h>
 #  include "CObject.hh" // Base class with all kinds of intermediate
 #  include "IMUData.hh"
+#  include "SPSCQueue.hh"
+#  include "IMURaw.hh"
 
 class H5Logger;
+class IMURawLogger;
+struct IMURawPosition;
 class ICM20948;
 class FileName;
 class PreciseTime;
 class IMU_IPC;
-class I2CHelper;
+class I2CBus;
 class AK09916;
+class GPIOInterrupt;
+class LoopTimer;
+class RealTime;
 
 class IMU : public CObject, public IMUData
 {
@@ -99,7 +117,9 @@ public:
     bool MagCal(double *b, double *s); 
 
     /*! 
-     * Ask the program to change filenames. 
+     * Ask the program to change filenames. Only sets a flag, the
+     * logger thread does the close and reopen, so this is safe
+     * from a signal handler. 
      */
     void UpdateFileName(void);
 
@@ -124,7 +144,14 @@ public:
     static const unsigned int kVerboseMax      = 0x8000;
  
 protected:
-    const size_t kNVar = 15;
+    /*! Columns in the double H5Logger file. */
+    static const size_t kNVar = 15;
+
+    /*! 4.5s at the full 225Hz ODR. */
+    static const size_t kLogQueueSize = 1024;
+
+    /*! Samples handed to IMURawLogger in one write. */
+    static const size_t kWriteBatch = 64;
 
 private:
 
@@ -134,12 +161,28 @@ private:
      */
     FileName*    fn;          /*! File nameing utilities. */
     PreciseTime* fTimer;      /*! */
-    bool         fChangeFile; /*! Tell the system to change the file name. */
+    std::atomic<bool> fChangeFile; /*! Tell the system to change the file name. */
 
     /*!
      * Logging tool, log data to HDF5 file.  
      */
     H5Logger        *f5Logger;
+    IMURawLogger    *fRawLogger; /*! Used instead when fRawLog. */
+
+    /*!
+     * Samples go from the acquisition thread to the logger thread 
+     * through fLogQueue as IMURaw counts, f5Logger, fRawLogger and
+     * fn are only touched by the logger thread once it is running.
+     * A full queue drops the sample and counts it in fLogDropped,
+     * one popped while no file is open is counted in fNoFile. 
+     */
+    SPSCQueue<IMURaw, kLogQueueSize> fLogQueue;
+    pthread_t         fWriter;
+    bool              fWriterStarted;
+    std::atomic<bool> fWriterRun;
+    uint64_t          fLogDropped;
+    uint64_t          fReadErrors; /*! Sample reads failed on the bus. */
+    uint64_t          fNoFile;     /*! Popped with no file open, writer. */
 
     /*!
      * IPC pointer. FIXME
@@ -153,18 +196,44 @@ private:
 
     /*! Collection of configuration parameters. */
     bool            fLogging;    /*! Turn logging on. */
+    bool            fRawLog;     /*! Log counts, IMURawLogger. */
     uint32_t        fSampleRate; /*! Integer Hz. */
     int32_t         fNSamples;   /*! Number of Samples to take before quit. */
     struct timespec fSampleTime; /*! Time for the above. */
+    LoopTimer       *fLoop;      /*! Deadlines every fSampleTime. */
+    RealTime        *fRT;        /*! Scheduling for the Do loop. */
+
 
+    /*! Pointer to I2C bus backend for read/write. */
+    I2CBus          *fI2C;      /* I2C comms.         */
+    bool            fSimulate;  /* Use I2CSim instead of i2c-dev. */
+    bool            fSimReadLast; /* I2CSim read last, as i2c-bcm2835. */
+    bool            fFIFO;      /* Stream through the ICM FIFO. */
+    bool            fMagMaster; /* AK09916 read by the ICM I2C master. */
 
-    /*! Pointer to I2C helper subsystem for read/write. */
-    I2CHelper       *fI2C;      /* I2C comms.         */
+    /*! 
+     * Data ready wait on the ICM INT pin, NULL for timed polling. 
+     * Every fDecimate'th edge is read. 
+     */
+    GPIOInterrupt   *fDRDY;
+    std::string     fGPIOChip;  /* /dev/gpiochipN, empty for none. */
+    int32_t         fGPIOLine;  /* Line offset on fGPIOChip. */
+    uint32_t        fDecimate;  /* ODR/SampleRate. */
+    uint32_t        fNEdge;     /* Edges since the last read. */
+    int             fDRDYTimeout; /* ms before falling back to a timed read. */
 
     /*! The sensor itself. */
     ICM20948        *fICM20948;
     AK09916         *fAK09916;      /* Magnetometer data. */
 
+    /*! 
+     * Last sample as counts, filled by the reads, and the 
+     * conversions for it, fixed once the devices are set up. 
+     * The IMUData engineering values are derived from these. 
+     */
+    IMURaw          fRaw;
+    IMUScale        fScale;
+
     time_t          fGMTOffset; 
 
     std::string     fICMDeviceName; /* I2C bus. */  
@@ -176,11 +245,39 @@ private:
      */
     bool OpenLogFile(void);
 
+    /*!
+     * Logger thread, start/stop and body. Stop drains the queue
+     * before returning. 
+     */
+    bool StartWriter(void);
+    void StopWriter(void);
+    void Writer(void);
+    void LogSI(const IMURaw &r);
+    void GetPosition(IMURawPosition *Pos);
+    static void* WriterThread(void *arg);
+
     /*!
      * Update - Update all the data, log the data, fill IPC ...
      */
     void Update(void);
 
+    /*!
+     * Fill the IMUData members from fRaw. 
+     */
+    void RawToData(void);
+
+    /*!
+     * FIFO mode, drain the ICM FIFO and Update for every sample. 
+     * Returns the number of samples processed. 
+     */
+    uint32_t DrainFIFO(void);
+
+    /*!
+     * Wait for the data ready edge, true if this sample is to be
+     * read. Always true without a GPIO. 
+     */
+    bool WaitDRDY(void);
+
     /*!
      * Read the configuration file. 
      */
@@ -10,6 +10,9 @@
  *
  * Change Descriptions :
  * 17-Dec-23 Added in Lat/Lon data
+ * 17-Oct-26 FromRaw
+ * 17-Oct-26 Schema. DataSize used to count a bool past fTemp that
+ *           is not in the class.
  *
  * Classification : Unclassified
  *
@@ -86,6 +89,70 @@ IMUData::IMUData(void)
 IMUData::~IMUData (void)
 {
 }
+/**
+ ******************************************************************
+ *
+ * Function Name : FromRaw
+ *
+ * Description : Convert an IMURaw sample into this. 
+ *
+ * Inputs : 
+ *     r - sample in counts
+ *     s - conversions
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMUData::FromRaw(const IMURaw &r, const IMUScale &s)
+{
+    fReadTime = IMURawTime(r);
+    IMURawToSI(r, s, fAcc, fGyro, fMagXYZ, &fTemp);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Schema
+ *
+ * Description : Layout of the data segment, fReadTime to fTemp, as
+ *     it goes in shared memory. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : the schema
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const SMSchema& IMUData::Schema(void)
+{
+    static const SMField kFields[] = {
+	SM_MEMBER(IMUData, fReadTime.tv_sec,  "ReadTime.tv_sec"),
+	SM_MEMBER(IMUData, fReadTime.tv_nsec, "ReadTime.tv_nsec"),
+	SM_MEMBER(IMUData, fAcc,    "Acc"),
+	SM_MEMBER(IMUData, fMagXYZ, "Mag"),
+	SM_MEMBER(IMUData, fGyro,   "Gyro"),
+	SM_MEMBER(IMUData, fTemp,   "Temp"),
+    };
+    static const SMSchema kSchema("IMUData", kFields, SM_NFIELDS(kFields));
+    // DataPointer is fReadTime, offsets are from there.
+    static_assert(offsetof(IMUData, fReadTime) == 0,
+		  "IMUData data segment must start the class");
+    return kSchema;
+}
 /**
  ******************************************************************
  *
@@ -11,6 +11,8 @@
  *
  * Change Descriptions :
  *     29-Mar-24 Changed fMag to fMagXYZ
+ *     17-Oct-26 FromRaw, fill from an IMURaw sample. 
+     17-Oct-26 Schema, DataSize from it. 
  *
  * Classification : Unclassified
  *
@@ -21,6 +23,8 @@
 #ifndef __IMUDATA_hh_
 #define __IMUDATA_hh_
 #    include <time.h>
+#    include "IMURaw.hh"
+#    include "SMSchema.hh"
 
 class IMUData 
 {
@@ -35,16 +39,20 @@ public:
 
     /*!
      * Description: 
-     *   
+     *   Fill in the time and engineering values from a sample in
+     *   counts, as read from the IMU_Ring segment. 
      *
      * Arguments:
-     *   
+     *   r - sample
+     *   s - conversions, from the IMUScale segment
      *
      * Returns:
+     *   NONE
      *
      * Errors:
-     *
+     *   NONE
      */
+    void FromRaw(const IMURaw &r, const IMUScale &s);
 
 
     /* ******************** ACCESS METHODS ******************* */
@@ -73,9 +81,10 @@ public:
     /* THINGS USED to relay in shared memory. --------------------- */
     /*! Get a pointer to the beginning of the data storage. */
     inline void* DataPointer(void) {return (void*)&fReadTime;};
+    /*! Field layout of the data, for the shared memory registry. */
+    static const SMSchema& Schema(void);
     /*! Return the overall data size for the structure. */
-    inline static size_t DataSize(void) 
-	{return (sizeof(struct timespec)+10*sizeof(double)+sizeof(bool));};
+    inline static size_t DataSize(void) {return Schema().Size();};
 
     /*! Enable a more friendly way of printing the contents of the class. */
     friend std::ostream& operator<<(std::ostream& output, const IMUData &n);
@@ -0,0 +1,119 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : IMURaw.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Compact IMU sample, the register counts exactly as
+ *     read from the ICM-20948 and AK09916 plus a 64 bit time. 30
+ *     bytes against ~96 for IMUData. This is what goes through the
+ *     logger queue, the IMURaw shared memory segment and the raw
+ *     HDF5 log. The scale factors do not change while running so
+ *     they are published once, IMUScale, in the IMUScale segment
+ *     and as attributes on the HDF5 dataset. Consumers convert to
+ *     engineering units when they need them, IMURawToSI.
+ *
+ * Restrictions/Limitations :
+ *     Packed, little endian (the Pi). Python readers use
+ *     '<Q3h3h3hhH'.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  IMURawSchema for the registry. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __IMURAW_hh_
+#define __IMURAW_hh_
+#    include <stdint.h>
+#    include <time.h>
+#    include "SMSchema.hh"
+
+/*! IMURaw Flags */
+const uint16_t kRawMagNew      = 0x0001; // AK09916 DRDY, fresh field
+const uint16_t kRawMagOverflow = 0x0002; // AK09916 ST2 HOFL
+const uint16_t kRawFIFO        = 0x0004; // recovered from the FIFO
+
+/*!
+ * One sample in counts.
+ */
+struct IMURaw {
+    uint64_t Time;      // ns since the epoch, same clock as IMUData
+    int16_t  Acc[3];    // ACCEL_[XYZ]OUT
+    int16_t  Gyro[3];   // GYRO_[XYZ]OUT
+    int16_t  Mag[3];    // AK09916 HX, HY, HZ
+    int16_t  Temp;      // TEMP_OUT
+    uint16_t Flags;
+} __attribute__((packed));
+
+/*!
+ * Multiply the counts by these to get engineering units.
+ * Temp C = Temp*TempScale + TempOffset
+ */
+struct IMUScale {
+    double Acc;         // g/count
+    double Gyro;        // dps/count
+    double Mag;         // uT/count
+    double TempScale;   // C/count
+    double TempOffset;  // C
+};
+
+/*!
+ * Description:
+ *   Convert a raw sample to engineering units, any output may
+ *   be NULL.
+ *
+ * Arguments:
+ *   r    - raw sample
+ *   s    - scale factors it was taken with
+ *   Acc  - 3, g
+ *   Gyro - 3, dps
+ *   Mag  - 3, uT
+ *   Temp - C
+ *
+ * Returns:
+ *   NONE
+ *
+ * Errors:
+ *   NONE
+ */
+inline void IMURawToSI(const IMURaw &r, const IMUScale &s, double *Acc,
+		       double *Gyro, double *Mag, double *Temp)
+{
+    for (int i=0;i<3;i++)
+    {
+	if (Acc)  Acc[i]  = (double) r.Acc[i]  * s.Acc;
+	if (Gyro) Gyro[i] = (double) r.Gyro[i] * s.Gyro;
+	if (Mag)  Mag[i]  = (double) r.Mag[i]  * s.Mag;
+    }
+    if (Temp) *Temp = (double) r.Temp * s.TempScale + s.TempOffset;
+}
+
+/*! IMURaw layout, for the shared memory registry. */
+inline const SMSchema& IMURawSchema(void)
+{
+    static const SMField kFields[] = {
+	SM_MEMBER(IMURaw, Time,  "Time"),
+	SM_MEMBER(IMURaw, Acc,   "Acc"),
+	SM_MEMBER(IMURaw, Gyro,  "Gyro"),
+	SM_MEMBER(IMURaw, Mag,   "Mag"),
+	SM_MEMBER(IMURaw, Temp,  "Temp"),
+	SM_MEMBER(IMURaw, Flags, "Flags"),
+    };
+    static const SMSchema kSchema("IMURaw", kFields, SM_NFIELDS(kFields));
+    return kSchema;
+}
+
+/*! IMURaw time as a timespec. */
+inline struct timespec IMURawTime(const IMURaw &r)
+{
+    struct timespec t;
+    t.tv_sec  = (time_t)(r.Time / 1000000000ULL);
+    t.tv_nsec = (long)  (r.Time % 1000000000ULL);
+    return t;
+}
+#endif
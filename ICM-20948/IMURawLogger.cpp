@@ -0,0 +1,253 @@
+/********************************************************************
+ *
+ * Module Name : IMURawLogger.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : HDF5 compound dataset of IMURaw samples.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Rows carry the GGA position. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "IMURawLogger.hh"
+
+using namespace H5;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMURawLogger constructor
+ *
+ * Description : Create the file, the compound type laid out exactly
+ *     as the packed IMURawRecord, the extendable dataset and the
+ *     scale attributes.
+ *
+ * Inputs :
+ *     Name        - file name
+ *     Scale       - conversions for this file
+ *     Description - stored as the Description attribute
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : any HDF5 failure, CheckError is true.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+IMURawLogger::IMURawLogger(const char *Name, const IMUScale &Scale,
+			   const char *Description) : fType(sizeof(IMURawRecord))
+{
+    SET_DEBUG_STACK;
+    hsize_t d3[1]    = {3};
+    hsize_t dims[1]  = {0};
+    hsize_t maxd[1]  = {H5S_UNLIMITED};
+    hsize_t chunk[1] = {kChunk};
+    // Raw is first, its members are at their IMURaw offsets. 
+    const size_t Pos = offsetof(IMURawRecord, Pos);
+
+    fError   = false;
+    fNRows   = 0;
+    fFile    = NULL;
+    fDataSet = NULL;
+
+    try
+    {
+	Exception::dontPrint();
+	ArrayType A3(PredType::NATIVE_INT16, 1, d3);
+
+	fType.insertMember("Time",  offsetof(IMURaw, Time),
+			   PredType::NATIVE_UINT64);
+	fType.insertMember("Acc",   offsetof(IMURaw, Acc),   A3);
+	fType.insertMember("Gyro",  offsetof(IMURaw, Gyro),  A3);
+	fType.insertMember("Mag",   offsetof(IMURaw, Mag),   A3);
+	fType.insertMember("Temp",  offsetof(IMURaw, Temp),
+			   PredType::NATIVE_INT16);
+	fType.insertMember("Flags", offsetof(IMURaw, Flags),
+			   PredType::NATIVE_UINT16);
+	fType.insertMember("Lat",   Pos + offsetof(IMURawPosition, Lat),
+			   PredType::NATIVE_DOUBLE);
+	fType.insertMember("Lon",   Pos + offsetof(IMURawPosition, Lon),
+			   PredType::NATIVE_DOUBLE);
+	fType.insertMember("Z",     Pos + offsetof(IMURawPosition, Z),
+			   PredType::NATIVE_DOUBLE);
+	fType.insertMember("UTC",   Pos + offsetof(IMURawPosition, UTC),
+			   PredType::NATIVE_DOUBLE);
+
+	fFile = new H5File(Name, H5F_ACC_TRUNC);
+
+	DataSpace Space(1, dims, maxd);
+	DSetCreatPropList Prop;
+	Prop.setChunk(1, chunk);
+	fDataSet = new DataSet(fFile->createDataSet("IMURaw", fType,
+						    Space, Prop));
+
+	ScaleAttribute("AccScale",   Scale.Acc);
+	ScaleAttribute("GyroScale",  Scale.Gyro);
+	ScaleAttribute("MagScale",   Scale.Mag);
+	ScaleAttribute("TempScale",  Scale.TempScale);
+	ScaleAttribute("TempOffset", Scale.TempOffset);
+
+	StrType   Str(PredType::C_S1, strlen(Description)+1);
+	DataSpace Scalar(H5S_SCALAR);
+	Attribute a = fDataSet->createAttribute("Description", Str, Scalar);
+	a.write(Str, Description);
+    }
+    catch (const Exception &e)
+    {
+	CLogger::GetThis()->Log("# IMURawLogger %s: %s\n", Name,
+				e.getCDetailMsg());
+	fError = true;
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : IMURawLogger destructor
+ *
+ * Description : Close the dataset and file, HDF5 flushes.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+IMURawLogger::~IMURawLogger(void)
+{
+    SET_DEBUG_STACK;
+    delete fDataSet;
+    if (fFile)
+    {
+	fFile->close();
+	delete fFile;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ScaleAttribute
+ *
+ * Description : Scalar double attribute on the dataset.
+ *
+ * Inputs : Name, Value
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : throws H5::Exception
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMURawLogger::ScaleAttribute(const char *Name, double Value)
+{
+    DataSpace Scalar(H5S_SCALAR);
+    Attribute a = fDataSet->createAttribute(Name, PredType::NATIVE_DOUBLE,
+					    Scalar);
+    a.write(PredType::NATIVE_DOUBLE, &Value);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Append
+ *
+ * Description : Copy the samples into rows with the position, then
+ *     extend the dataset by n and write the block into the new rows.
+ *
+ * Inputs :
+ *     r   - samples
+ *     n   - count
+ *     Pos - GGA position for the block
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : HDF5 failure, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool IMURawLogger::Append(const IMURaw *r, size_t n,
+			  const IMURawPosition &Pos)
+{
+    SET_DEBUG_STACK;
+    hsize_t Size[1], Offset[1], Count[1];
+    size_t  i;
+
+    if (fError || (n == 0))
+    {
+	return !fError;
+    }
+
+    // Grows to the largest batch once, then no allocation. 
+    if (fRecords.size() < n)
+    {
+	fRecords.resize(n);
+    }
+    for (i=0;i<n;i++)
+    {
+	fRecords[i].Raw = r[i];
+	fRecords[i].Pos = Pos;
+    }
+
+    try
+    {
+	Size[0]   = fNRows + n;
+	Offset[0] = fNRows;
+	Count[0]  = n;
+	fDataSet->extend(Size);
+
+	DataSpace File = fDataSet->getSpace();
+	File.selectHyperslab(H5S_SELECT_SET, Count, Offset);
+	DataSpace Memory(1, Count);
+	fDataSet->write(fRecords.data(), fType, Memory, File);
+	fNRows = Size[0];
+    }
+    catch (const Exception &e)
+    {
+	CLogger::GetThis()->LogError(__FILE__,__LINE__,'W',
+				     "IMURaw HDF5 write failed.\n");
+	return false;
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
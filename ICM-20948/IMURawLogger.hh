@@ -0,0 +1,101 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : IMURawLogger.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : HDF5 log of IMURaw samples. One extendable,
+ *     chunked, one dimensional dataset "IMURaw" of a compound type
+ *     matching struct IMURawRecord field for field,
+ *         Time (uint64 ns), Acc[3], Gyro[3], Mag[3], Temp (int16),
+ *         Flags (uint16), Lat, Lon (deg), Z (m), UTC (double)
+ *     with the IMUScale factors as double attributes on the
+ *     dataset, AccScale, GyroScale, MagScale, TempScale and
+ *     TempOffset. The position columns are the GGA ones of the
+ *     double log. 62 bytes a sample against 120 for the 15 column
+ *     double log.
+ *
+ *     In python
+ *         d = h5py.File(name)['IMURaw']
+ *         acc = d['Acc'] * d.attrs['AccScale']
+ *
+ * Restrictions/Limitations :
+ *     The position is the latest GGA when the batch is written, as
+ *     in the double log, zero when there is none. 
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Lat, Lon, Z and UTC columns. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __IMURAWLOGGER_hh_
+#define __IMURAWLOGGER_hh_
+#    include <stddef.h>
+#    include <vector>
+#    include "H5Cpp.h"
+#    include "IMURaw.hh"
+
+/*! GGA position stored with each sample, as in the double log. */
+struct IMURawPosition {
+    double Lat;         // deg
+    double Lon;         // deg
+    double Z;           // m
+    double UTC;         // GGA time of day
+};
+
+/*! One row of the dataset. */
+struct IMURawRecord {
+    IMURaw         Raw;
+    IMURawPosition Pos;
+} __attribute__((packed));
+
+/// IMURawLogger - compound HDF5 dataset of raw IMU samples.
+class IMURawLogger {
+public:
+    /// Create Name, truncating any existing file.
+    IMURawLogger(const char *Name, const IMUScale &Scale,
+		 const char *Description);
+    /// Flush and close.
+    ~IMURawLogger(void);
+
+    /*! true if the file or dataset could not be created. */
+    inline bool CheckError(void) const {return fError;};
+
+    /*!
+     * Description:
+     *   Append n samples to the end of the dataset in one write.
+     *
+     * Arguments:
+     *   r   - samples
+     *   n   - number of samples
+     *   Pos - position for all of them
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   HDF5 write failure, logged.
+     */
+    bool Append(const IMURaw *r, size_t n, const IMURawPosition &Pos);
+
+    /*! Samples written. */
+    inline hsize_t Rows(void) const {return fNRows;};
+
+private:
+    static const hsize_t kChunk = 1024;
+
+    bool         fError;
+    hsize_t      fNRows;
+    H5::H5File   *fFile;
+    H5::DataSet  *fDataSet;
+    H5::CompType fType;
+    std::vector<IMURawRecord> fRecords;  // Append's scratch
+
+    void ScaleAttribute(const char *Name, double Value);
+};
+#endif
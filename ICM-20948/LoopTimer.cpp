@@ -0,0 +1,309 @@
+/********************************************************************
+ *
+ * Module Name : LoopTimer.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Absolute deadline loop pacing and jitter statistics.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cerrno>
+
+// Local Includes.
+#include "debug.h"
+#include "LoopTimer.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : LoopTimer constructor
+ *
+ * Description : Store the period and Start, call Start again to
+ *     restart the grid when the loop actually begins.
+ *
+ * Inputs : Period - loop period
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+LoopTimer::LoopTimer(const struct timespec &Period)
+{
+    SET_DEBUG_STACK;
+    fPeriod = (int64_t)Period.tv_sec*1000000000LL + (int64_t)Period.tv_nsec;
+    if (fPeriod < 1) fPeriod = 1;
+    Start();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : LoopTimer destructor
+ *
+ * Description : NONE
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+LoopTimer::~LoopTimer(void)
+{
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Now
+ *
+ * Description : CLOCK_MONOTONIC in ns
+ *
+ * Inputs : NONE
+ *
+ * Returns : time in ns
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int64_t LoopTimer::Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec*1000000000LL + (int64_t)t.tv_nsec;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Start
+ *
+ * Description : First deadline one period out, clear statistics.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void LoopTimer::Start(void)
+{
+    SET_DEBUG_STACK;
+    fNext     = Now() + fPeriod;
+    fWakeups  = 0;
+    fOverruns = 0;
+    fSkipped  = 0;
+    fMaxAll   = 0;
+    ResetWindow();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ResetWindow
+ *
+ * Description : Clear the lateness window.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void LoopTimer::ResetWindow(void)
+{
+    fN   = 0;
+    fMin = 0;
+    fMax = 0;
+    fSum = 0.0;
+    memset(fHist, 0, sizeof(fHist));
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Record
+ *
+ * Description : Add one lateness measurement.
+ *
+ * Inputs : Late - ns after the deadline
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void LoopTimer::Record(int64_t Late)
+{
+    uint64_t bin;
+
+    if (Late < 0) Late = 0;
+    if ((fN == 0) || (Late < fMin)) fMin = Late;
+    if ((fN == 0) || (Late > fMax)) fMax = Late;
+    if (Late > fMaxAll) fMaxAll = Late;
+    fSum += (double) Late;
+    fN++;
+    fWakeups++;
+
+    bin = (uint64_t) Late/1000;
+    if (bin > kNBins) bin = kNBins;
+    fHist[bin]++;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Wait
+ *
+ * Description :
+ *    If the deadline is still ahead, sleep to it. If not this is
+ *    an overrun, no sleep, and any whole periods already gone are
+ *    dropped so the next deadline is back in the future and on
+ *    the original grid.
+ *
+ * Inputs : NONE
+ *
+ * Returns : slots skipped
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t LoopTimer::Wait(void)
+{
+    SET_DEBUG_STACK;
+    struct timespec Deadline;
+    int64_t  t = Now();
+    uint32_t Skip = 0;
+    int      rc;
+
+    if (t >= fNext)
+    {
+	fOverruns++;
+	Record(t - fNext);
+	Skip = (uint32_t)((t - fNext)/fPeriod);
+	fSkipped += Skip;
+	fNext += (int64_t)(Skip+1)*fPeriod;
+	return Skip;
+    }
+
+    Deadline.tv_sec  = fNext / 1000000000LL;
+    Deadline.tv_nsec = fNext % 1000000000LL;
+    do
+    {
+	rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL);
+    } while (rc == EINTR);
+
+    Record(Now() - fNext);
+    fNext += fPeriod;
+    SET_DEBUG_STACK;
+    return Skip;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Stats
+ *
+ * Description : Summarize the window, p99 from the histogram.
+ *
+ * Inputs : s - user supplied structure to fill
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void LoopTimer::Stats(LoopStats *s) const
+{
+    SET_DEBUG_STACK;
+    uint64_t Count = 0;
+    uint64_t Target;
+    uint32_t i;
+
+    s->Period   = 1.0e-9 * (double) fPeriod;
+    s->Min      = 1.0e-9 * (double) fMin;
+    s->Max      = 1.0e-9 * (double) fMax;
+    s->Mean     = (fN>0) ? 1.0e-9 * fSum/(double) fN : 0.0;
+    s->N        = fN;
+    s->Overruns = fOverruns;
+    s->Skipped  = fSkipped;
+
+    // Smallest bin edge with at least 99% of the window below it.
+    s->P99 = 0.0;
+    Target = ((uint64_t) fN * 99 + 99)/100;
+    for (i=0; (i<=kNBins) && (fN>0); i++)
+    {
+	Count += fHist[i];
+	if (Count >= Target)
+	{
+	    s->P99 = (i<kNBins) ? 1.0e-6*(double)(i+1) : s->Max;
+	    if (s->P99 > s->Max) s->P99 = s->Max;
+	    break;
+	}
+    }
+}
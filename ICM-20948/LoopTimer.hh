@@ -0,0 +1,126 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : LoopTimer.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Absolute deadline pacing for a periodic loop.
+ *     Deadlines are kept on a fixed CLOCK_MONOTONIC grid,
+ *     start + k*period, and reached with clock_nanosleep
+ *     TIMER_ABSTIME so the time spent reading, logging and in
+ *     IPC does not add to the period and nothing accumulates.
+ *
+ *     Lateness is how long after the deadline the loop actually
+ *     woke. An overrun is a deadline that had already passed when
+ *     Wait was called, if whole periods were lost those slots are
+ *     counted as skipped and the loop rejoins the grid at the next
+ *     future deadline rather than trying to catch up.
+ *
+ * Restrictions/Limitations :
+ *     Lateness histogram is 1us bins out to 10ms, the 99th
+ *     percentile above that is reported as the window maximum.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     man clock_nanosleep
+ *
+ *******************************************************************
+ */
+#ifndef __LOOPTIMER_hh_
+#define __LOOPTIMER_hh_
+#    include <stdint.h>
+#    include <time.h>
+
+/*!
+ * Loop timing statistics, as published in shared memory.
+ * Lateness values are for the window since the last ResetWindow,
+ * the counters are totals since Start.
+ */
+struct LoopStats {
+    double   Period;    // s
+    double   Min;       // lateness, s
+    double   Max;
+    double   Mean;
+    double   P99;
+    uint32_t N;         // wakeups in the window
+    uint32_t Overruns;  // deadlines already passed on entry to Wait
+    uint32_t Skipped;   // whole periods lost to overruns
+};
+
+/// LoopTimer - periodic absolute deadlines on CLOCK_MONOTONIC.
+class LoopTimer {
+public:
+    /// Default Constructor
+    LoopTimer(const struct timespec &Period);
+    /// Default destructor
+    ~LoopTimer(void);
+
+    /*!
+     * Description:
+     *   Set the first deadline one period from now and clear
+     *   all statistics.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE
+     */
+    void Start(void);
+
+    /*!
+     * Description:
+     *   Sleep until the next deadline and advance it one period,
+     *   or past any lost slots after an overrun.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   number of slots skipped, normally 0.
+     *
+     * Errors:
+     *   NONE
+     */
+    uint32_t Wait(void);
+
+    /*! Fill in the current statistics. */
+    void Stats(LoopStats *s) const;
+
+    /*! Start a new lateness window, counters are not touched. */
+    void ResetWindow(void);
+
+    /*! Largest lateness since Start, s */
+    inline double MaxLateness(void) const {return 1.0e-9*(double)fMaxAll;};
+
+    /*! Number of wakeups since Start */
+    inline uint64_t Wakeups(void) const {return fWakeups;};
+
+private:
+    static const uint32_t kNBins = 10000;   // 1us each
+
+    int64_t   fPeriod;      // ns
+    int64_t   fNext;        // next deadline, ns CLOCK_MONOTONIC
+    uint64_t  fWakeups;
+    uint32_t  fOverruns;
+    uint32_t  fSkipped;
+    int64_t   fMaxAll;      // ns
+
+    /* Window. */
+    uint32_t  fN;
+    int64_t   fMin;
+    int64_t   fMax;
+    double    fSum;
+    uint32_t  fHist[kNBins+1];   // last bin is overflow
+
+    static int64_t Now(void);
+    void      Record(int64_t Late);
+};
+#endif
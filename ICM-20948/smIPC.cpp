@@ -9,6 +9,14 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  IMU_Jitter segment, loop timing statistics. 
+ * 17-Oct-26  CBL  IMURaw and IMUScale segments. 
+ * 17-Oct-26  CBL  IMU_Ring. 
+ * 17-Oct-26  CBL  Position from GGA_Snap, no LAM. 
+ * 17-Oct-26  CBL  Position from GPS_Fix. 
+ * 17-Oct-26  CBL  IMU_Snap, IMUData without the semaphore. 
+ * 17-Oct-26  CBL  IMU_Ring and IMU_Snap listed in the registry,
+ *                 GPS_Fix layout checked against it. 
  *
  * Classification : Unclassified
  *
@@ -68,7 +76,13 @@ IMU_IPC::IMU_IPC(void) : CObject()
 
     pSM          = NULL;
     pSM_Position = NULL;
+    fFix         = NULL;
     fSM_Filename = NULL;
+    fSM_Jitter   = NULL;
+    fSM_Raw      = NULL;
+    fSM_Scale    = NULL;
+    fRing        = NULL;
+    fSnap        = NULL;
     fGGA         = NULL;
 
     pSM = new SharedMem2("IMU", IMUData::DataSize(), true);
@@ -100,12 +114,75 @@ IMU_IPC::IMU_IPC(void) : CObject()
 		     __FILE__,  __LINE__);
     }
 
-    // Connect to GGA message if available. 
-    pSM_Position = new SharedMem2("GGA"); 
-    if (pSM_Position->CheckError())
+    fSM_Jitter = new SharedMem2("IMU_Jitter", sizeof(LoopStats), true);
+    if (fSM_Jitter->CheckError())
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
-			 "GGA data SM failed.");
+			 "IMU_Jitter SM failed.");
+	delete fSM_Jitter;
+	fSM_Jitter = NULL;
+	// Not fatal, diagnostics only. 
+    }
+
+    /*
+     * 30 bytes a sample. Readers convert with the IMUScale segment,
+     * written once. 
+     */
+    fSM_Raw = new SharedMem2("IMURaw", sizeof(IMURaw), true);
+    if (fSM_Raw->CheckError())
+    {
+	plogger->LogError(__FILE__, __LINE__, 'W',
+			 "IMURaw SM failed.");
+	delete fSM_Raw;
+	fSM_Raw = NULL;
+    }
+    fSM_Scale = new SharedMem2("IMUScale", sizeof(IMUScale), true);
+    if (fSM_Scale->CheckError())
+    {
+	plogger->LogError(__FILE__, __LINE__, 'W',
+			 "IMUScale SM failed.");
+	delete fSM_Scale;
+	fSM_Scale = NULL;
+    }
+
+    /*
+     * 18s at the full 225Hz ODR. Readers that fall further behind
+     * are told how many they lost. 
+     */
+    fRing = new SMRing("IMU_Ring", sizeof(IMURaw), kRingSize);
+    if (fRing->CheckError())
+    {
+	plogger->LogError(__FILE__, __LINE__, 'W',
+			 "IMU_Ring SM failed.");
+	delete fRing;
+	fRing = NULL;
+    }
+    else
+    {
+	fRing->Register(IMURawSchema(), 0.0);
+    }
+
+    fSnap = new SMSnapshot("IMU_Snap", IMUData::DataSize());
+    if (fSnap->CheckError())
+    {
+	plogger->LogError(__FILE__, __LINE__, 'W',
+			 "IMU_Snap SM failed.");
+	delete fSnap;
+	fSnap = NULL;
+    }
+    else
+    {
+	fSnap->Register(IMUData::Schema(), 0.0);
+    }
+
+    // Connect to the GPS fix, GGA, if available. 
+    pSM_Position = new SMSnapshot("GPS_Fix"); 
+    if (pSM_Position->CheckError() ||
+	(pSM_Position->RecordSize() != GPSFix::Size()) ||
+	!pSM_Position->Expect(GPSFix::Schema()))
+    {
+	plogger->LogError(__FILE__, __LINE__, 'W',
+			 "GPS_Fix SM failed.");
 	delete pSM_Position;
 	pSM_Position = 0;
 	SET_DEBUG_STACK;
@@ -113,7 +190,8 @@ IMU_IPC::IMU_IPC(void) : CObject()
     }
     else
     {
-	plogger->Log("# GGA SM successfully attached.\n");
+	plogger->Log("# GPS_Fix SM successfully attached.\n");
+	fFix = new GPSFix();
 	fGGA = new GGA();
     }
 
@@ -148,6 +226,10 @@ void IMU_IPC::Update(void)
     if (ptr)
     {
 	pSM->PutData(ptr->DataPointer());
+	if (fSnap)
+	{
+	    fSnap->Put(ptr->DataPointer());
+	}
     }
     SET_DEBUG_STACK;
 }
@@ -176,12 +258,12 @@ GGA* IMU_IPC::GetPosition(void) const
     SET_DEBUG_STACK;
     if (fGGA && pSM_Position)
     {
-	/* Is the data "new" */
-	if (pSM_Position->GetLAM())
-	{
-	    pSM_Position->GetData(fGGA->DataPointer());
-	    pSM_Position->ClearLAM();
-	}
+	/*
+	 * Only copies if the generation moved since our last look,
+	 * other readers of GPS_Fix are not affected.
+	 */
+	if (pSM_Position->Get(fFix->Buffer()))
+	    fFix->Unpack(fGGA, NULL, NULL, NULL);
     }
     SET_DEBUG_STACK;
     return fGGA;
@@ -223,6 +305,136 @@ void IMU_IPC::UpdateFilename(const char *name)
     SET_DEBUG_STACK;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name :  UpdateJitter
+ *
+ * Description : Publish the acquisition loop timing statistics. 
+ *
+ * Inputs : Stats - current LoopTimer statistics
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU_IPC::UpdateJitter(const LoopStats &Stats)
+{
+    SET_DEBUG_STACK;
+    if (fSM_Jitter)
+    {
+	fSM_Jitter->PutData(&Stats);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  UpdateRaw
+ *
+ * Description : Publish the last sample in counts, and append it
+ *     to IMU_Ring.
+ *
+ * Inputs : Raw - sample
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU_IPC::UpdateRaw(const IMURaw &Raw)
+{
+    SET_DEBUG_STACK;
+    if (fSM_Raw)
+    {
+	fSM_Raw->PutData(&Raw);
+    }
+    if (fRing)
+    {
+	fRing->Put(&Raw);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  UpdateScale
+ *
+ * Description : Publish the IMURaw conversions. 
+ *
+ * Inputs : Scale - conversions
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU_IPC::UpdateScale(const IMUScale &Scale)
+{
+    SET_DEBUG_STACK;
+    if (fSM_Scale)
+    {
+	fSM_Scale->PutData(&Scale);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name :  SetRate
+ *
+ * Description : Samples a second, as published in IMU_Ring and
+ *     IMU_Snap, for their registry entries. 
+ *
+ * Inputs : Rate - Hz
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void IMU_IPC::SetRate(double Rate)
+{
+    SET_DEBUG_STACK;
+    if (fRing)
+    {
+	fRing->SetRate(Rate);
+    }
+    if (fSnap)
+    {
+	fSnap->SetRate(Rate);
+    }
+    SET_DEBUG_STACK;
+}
+
 /**
  ******************************************************************
  *
@@ -248,7 +460,13 @@ IMU_IPC::~IMU_IPC(void)
     SET_DEBUG_STACK;
     delete pSM;
     delete fSM_Filename;
+    delete fSM_Jitter;
+    delete fSM_Raw;
+    delete fSM_Scale;
+    delete fRing;
+    delete fSnap;
     delete pSM_Position;
+    delete fFix;
     delete fGGA;
     SET_DEBUG_STACK;
 }
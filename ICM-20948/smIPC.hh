@@ -10,6 +10,14 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  IMU_Jitter segment, loop timing statistics. 
+ * 17-Oct-26  CBL  IMURaw and IMUScale segments. 
+ * 17-Oct-26  CBL  IMU_Ring, every sample for consumers that want
+ *                 them all. 
+ * 17-Oct-26  CBL  Position from GGA_Snap, no LAM. 
+ * 17-Oct-26  CBL  Position from GPS_Fix, one epoch per read. 
+ * 17-Oct-26  CBL  IMU_Snap, IMUData without the semaphore. 
+ * 17-Oct-26  CBL  IMU_Ring and IMU_Snap in the registry, SetRate. 
  *
  * Classification : Unclassified
  *
@@ -22,6 +30,11 @@
 #   include "ICM-20948.hh"
 #   include "SharedMem2.hh"
 #   include "NMEA_GPS.hh"   // to get position data. 
+#   include "LoopTimer.hh"  // LoopStats
+#   include "IMURaw.hh"     // IMURaw, IMUScale
+#   include "SMRing.hh"
+#   include "SMSnapshot.hh"
+#   include "GPSFix.hh"
 
 class IMU_IPC : public CObject 
 {
@@ -36,6 +49,18 @@ public:
     /*! Update filename in shared memory. */
     void UpdateFilename(const char *name);
 
+    /*! Publish loop timing statistics in IMU_Jitter. */
+    void UpdateJitter(const LoopStats &Stats);
+
+    /*! Publish the last sample as counts in IMURaw and IMU_Ring. */
+    void UpdateRaw(const IMURaw &Raw);
+
+    /*! Publish the conversions for IMURaw, once at start. */
+    void UpdateScale(const IMUScale &Scale);
+
+    /*! Sample rate in Hz, for the registry entries. */
+    void SetRate(double Rate);
+
     GGA *GetPosition(void) const;
 
 private:
@@ -44,15 +69,41 @@ private:
      */
     SharedMem2   *pSM;
     /**
-     * Position shared memory, read. 
+     * The same IMUData as a seqlock snapshot, IMU_Snap. Every sample
+     * is published, a reader can never hold up the loop. 
      */
-    SharedMem2   *pSM_Position;
+    SMSnapshot   *fSnap;
+    /**
+     * Position shared memory, read. GPS_Fix, this reader keeps its
+     * own generation so it does not take updates from the others.
+     * The GGA is unpacked from the epoch in fFix. 
+     */
+    SMSnapshot   *pSM_Position;
+    GPSFix       *fFix;
 
     /**
      * Shared memory segment for current data file name. 
      */
     SharedMem2   *fSM_Filename;
 
+    /**
+     * Loop lateness and overrun statistics, struct LoopStats. 
+     */
+    SharedMem2   *fSM_Jitter;
+
+    /**
+     * Last sample in counts, struct IMURaw, and its conversions,
+     * struct IMUScale. 
+     */
+    SharedMem2   *fSM_Raw;
+    SharedMem2   *fSM_Scale;
+
+    /**
+     * Every IMURaw sample, kRingSize deep. 
+     */
+    SMRing       *fRing;
+    static const uint32_t kRingSize = 4096;
+
     GGA          *fGGA;
 };
 #endif
@@ -10,6 +10,9 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  Take every fix from the GPS rings, report the IMU
+ *                 samples between fixes. 
+ * 17-Oct-26  CBL  Block on the next fix instead of a 100ms sleep. 
  *
  * Classification : Unclassified
  *
@@ -190,7 +193,8 @@ Processor::~Processor(void)
  */
 void Processor::Do(void)
 {
-    const struct timespec sleeptime = {0L, 100000000L};
+    // Longest wait for a fix before fRun is looked at again.
+    const uint32_t kWaitMS = 1000;
     SET_DEBUG_STACK;
     Point current;
     Point  delta;
@@ -204,7 +208,8 @@ void Processor::Do(void)
     fRun = true;
     while(fRun)
     {
-	if(fGPS->Update())
+	// Every fix since the last pass, in order. 
+	while(fRun && fGPS->Update())
 	{
 	    Lat = pRMC->Latitude();
 	    Lon = pRMC->Longitude();
@@ -229,6 +234,9 @@ void Processor::Do(void)
 		tdelta += (double)(Seconds-IMUTime.tv_sec);
 		tdelta += pRMC->Delta();
 		cout << *pData << endl;
+		cout << " IMU samples: " << fIMU->NSamples()
+		     << " missed: " << fIMU->Missed()
+		     << endl;
 		cout << " DTIME S: " 
 		     << Seconds - IMUTime.tv_sec 
 		     << " Milli: " << milli
@@ -238,7 +246,8 @@ void Processor::Do(void)
 	    }
 	    Update();
 	}
-	nanosleep( &sleeptime, NULL);
+	// Woken by GTOP's next put, a signal, or the timeout. 
+	fGPS->Wait(kWaitMS);
     }
     SET_DEBUG_STACK;
 }
@@ -9,6 +9,11 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  GGA_Ring and RMC_Ring. 
+ * 17-Oct-26  CBL  _Snap segments in place of the SharedMem2 LAM. 
+ * 17-Oct-26  CBL  Wait. 
+ * 17-Oct-26  CBL  GPS_Fix, one consistent epoch per Update. 
+ * 17-Oct-26  CBL  GPS_Fix layout checked against the registry. 
  *
  * Classification : Unclassified
  *
@@ -67,13 +72,17 @@ GPS_IPC::GPS_IPC(void) : CObject()
     pSM_SolutionData  = NULL;
     pSM_VelocityData  = NULL;
     pSM_Minimum       = NULL;
+    fGGARing          = NULL;
+    fRMCRing          = NULL;
+    fFixSnap          = NULL;
+    fFix              = NULL;
 
     fRMC = NULL;
     fGGA = NULL;
     fVTG = NULL;
     fGSA = NULL;
 
-    pSM_PositionData = new SharedMem2("GGA"); 
+    pSM_PositionData = new SMSnapshot("GGA_Snap"); 
     if (pSM_PositionData->CheckError())
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
@@ -88,7 +97,7 @@ GPS_IPC::GPS_IPC(void) : CObject()
 	plogger->Log("# GGA SM successfully attached.\n");
     }
 
-    pSM_SolutionData = new SharedMem2("GSA");
+    pSM_SolutionData = new SMSnapshot("GSA_Snap");
     if (pSM_SolutionData->CheckError())
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
@@ -103,7 +112,7 @@ GPS_IPC::GPS_IPC(void) : CObject()
 	plogger->Log("# GSA status SM successfully attached.\n");
     }
 
-    pSM_VelocityData = new SharedMem2("VTG");
+    pSM_VelocityData = new SMSnapshot("VTG_Snap");
     if (pSM_VelocityData->CheckError())
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
@@ -125,7 +134,7 @@ GPS_IPC::GPS_IPC(void) : CObject()
      * Put the entire GPSTime structure out there
      */
 
-    pSM_Minimum = new  SharedMem2("RMC");
+    pSM_Minimum = new  SMSnapshot("RMC_Snap");
     if (pSM_Minimum->CheckError())
     {
 	plogger->LogError(__FILE__, __LINE__, 'W', 
@@ -142,6 +151,43 @@ GPS_IPC::GPS_IPC(void) : CObject()
     fVTG = new VTG();
     fGSA = new GSA();
 
+    /*
+     * GPS_Fix has all four messages of an epoch in one record,
+     * nothing else is read if we have it. 
+     */
+    fFixSnap = new SMSnapshot("GPS_Fix");
+    if (fFixSnap->CheckError() || (fFixSnap->RecordSize() != GPSFix::Size()) ||
+	!fFixSnap->Expect(GPSFix::Schema()))
+    {
+	delete fFixSnap;
+	fFixSnap = NULL;
+    }
+    else
+    {
+	fFix = new GPSFix();
+	plogger->Log("# GPS_Fix attached.\n");
+    }
+
+    /*
+     * Older GTOP does not have the rings, fall back on the snapshots. 
+     */
+    fGGARing = new SMRing("GGA_Ring");
+    fRMCRing = new SMRing("RMC_Ring");
+    if (fGGARing->CheckError() || fRMCRing->CheckError() ||
+	(fGGARing->RecordSize() != GGA::DataSize()) ||
+	(fRMCRing->RecordSize() != RMC::DataSize()))
+    {
+	plogger->Log("# GPS rings not available, polling GGA_Snap/RMC_Snap.\n");
+	delete fGGARing;
+	delete fRMCRing;
+	fGGARing = NULL;
+	fRMCRing = NULL;
+    }
+    else
+    {
+	plogger->Log("# GGA_Ring and RMC_Ring attached.\n");
+    }
+
     SET_DEBUG_STACK;
 }
 
@@ -155,16 +201,14 @@ GPS_IPC::GPS_IPC(void) : CObject()
  *       Update all gps data in shared memory.
  *       We can easily turn off checking of any of the shared memory
  *       items by setting any of the pointers to NULL. Assuming they 
- *       are not null, then we check if the LAM is set to true. 
+ *       are not null, each snapshot Get copies the data only if its
+ *       generation moved since our last Get. Nothing is cleared, the
+ *       IMU, barometer and timing readers of the same segments are
+ *       not affected. 
  *
- *       If LAM is true, then the sender has populated with new data. 
- *       Alternatively you can check the date/time of the shared memory
- *       update. The user is responsible for Clearing the LAM saying
- *       that the data has been retrieved. 
- *
- *       For this particular implementation, any one of the LAMs being
- *       set indicates that the entire set is valid. This is based
- *       on the coding of the sender but is not in general true. 
+ *       For this particular implementation, any one of the segments
+ *       being new indicates that the entire set is valid. This is
+ *       based on the coding of the sender but is not in general true. 
  *
  * Inputs : none
  *
@@ -192,57 +236,91 @@ bool GPS_IPC::Update(void)
      * Check to see if the SM placement is new???
      */
 
-    if (fGGA && pSM_PositionData)
+    /* One epoch, the four messages are consistent. */
+    if (fFixSnap)
     {
-	/* Is the data "new" */
-	if (pSM_PositionData->GetLAM())
+	if (fFixSnap->Get(fFix->Buffer()) && 
+	    fFix->Unpack(fGGA, fGSA, fVTG, fRMC))
 	{
-	    pSM_PositionData->GetData(fGGA->DataPointer());
-	    pSM_PositionData->ClearLAM();
 	    rv = true;
 	}
+	SET_DEBUG_STACK;
+	return rv;
+    }
+
+    /* One fix from each ring, GTOP puts them in together. */
+    if (fGGARing)
+    {
+	if (fGGARing->Get(fGGA->DataPointer()))
+	    rv = true;
+	if (fRMCRing->Get(fRMC->DataPointer()))
+	    rv = true;
+    }
+    else if (fGGA && pSM_PositionData)
+    {
+	if (pSM_PositionData->Get(fGGA->DataPointer()))
+	    rv = true;
     }
 
     SET_DEBUG_STACK;
     if(fGSA && pSM_SolutionData)
     {
-
-	/* Is the data "new" */
-	if (pSM_SolutionData->GetLAM())
-	{
-	    pSM_SolutionData->GetData(fGSA->DataPointer());
-	    pSM_SolutionData->ClearLAM();
+	if (pSM_SolutionData->Get(fGSA->DataPointer()))
 	    rv = true;
-	}
     }
 
     SET_DEBUG_STACK;
     if (fVTG && pSM_VelocityData)
     {
-	/* Is the data "new" */
-	if (pSM_VelocityData->GetLAM())
-	{
-	    pSM_VelocityData->GetData(fVTG->DataPointer());
-	    pSM_VelocityData->ClearLAM();
+	if (pSM_VelocityData->Get(fVTG->DataPointer()))
 	    rv = true;
-	}
     }
 	
-    if (fRMC && pSM_Minimum)
+    if (fRMC && pSM_Minimum && !fRMCRing)
     {
-	/* Is the data "new" */
-	if (pSM_Minimum->GetLAM())
-	{
-	    pSM_Minimum->GetData(fRMC->DataPointer());
-	    pSM_Minimum->ClearLAM();
+	if (pSM_Minimum->Get(fRMC->DataPointer()))
 	    rv = true;
-	}
     }
 
     SET_DEBUG_STACK;
     return rv;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name :  Wait
+ *
+ * Description : Sleep on GPS_Fix until GTOP puts the next epoch.
+ *     Without it sleep on the RMC segment, the ring if we have it.
+ *     GTOP puts RMC last, so when it is new the GGA, GSA and VTG of
+ *     the same update are there.
+ *
+ * Inputs : TimeoutMS - longest wait
+ *
+ * Returns : true if there is new data
+ *
+ * Error Conditions : false without any RMC segment
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool GPS_IPC::Wait(uint32_t TimeoutMS)
+{
+    SET_DEBUG_STACK;
+    if (fFixSnap)
+	return fFixSnap->Wait(TimeoutMS);
+    if (fRMCRing)
+	return fRMCRing->Wait(TimeoutMS);
+    if (pSM_Minimum)
+	return pSM_Minimum->Wait(TimeoutMS);
+    return false;
+}
+
 /**
  ******************************************************************
  *
@@ -276,8 +354,39 @@ GPS_IPC::~GPS_IPC(void)
     delete pSM_SolutionData;
     delete pSM_VelocityData;
     delete pSM_Minimum;
+    delete fGGARing;
+    delete fRMCRing;
+    delete fFixSnap;
+    delete fFix;
 
     SET_DEBUG_STACK;
 }
+/**
+ ******************************************************************
+ *
+ * Function Name :  Missed
+ *
+ * Description : Fixes lost, epochs GPS_Fix overwrote before we
+ *     read them or ring overwrites. 
+ *
+ * Inputs : NONE
+ *
+ * Returns : count, 0 without GPS_Fix or the rings
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t GPS_IPC::Missed(void) const
+{
+    if (fFixSnap)
+	return fFixSnap->Skipped();
+    return fGGARing ? fGGARing->Missed() : 0;
+}
 
 
@@ -10,6 +10,13 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  GGA and RMC from GGA_Ring/RMC_Ring, one fix per
+ *                 Update, none skipped. 
+ * 17-Oct-26  CBL  GGA/GSA/VTG/RMC from the _Snap segments, no LAM
+ *                 to clear under the other readers. 
+ * 17-Oct-26  CBL  Wait, block until the next fix. 
+ * 17-Oct-26  CBL  GPS_Fix, all four messages from the same epoch. 
+ *
  * Classification : Unclassified
  *
  * References : NONE
@@ -20,7 +27,9 @@
 #define __SMIPC_GPS_hh_
 #   include "NMEA_GPS.hh"
 #   include "CObject.hh"
-#   include "SharedMem2.hh"
+#   include "SMRing.hh"
+#   include "SMSnapshot.hh"
+#   include "GPSFix.hh"
 
 class GPS_IPC : public CObject
 {
@@ -30,9 +39,22 @@ public:
     /*! Destructor */
     ~GPS_IPC(void);
 
-    /*! Receive the data, Returns true if new data was available. */
+    /*! 
+     * Receive the data, Returns true if new data was available. 
+     * With the rings each call returns the next fix in order, call
+     * until false to take them all. 
+     */
     bool Update(void);
 
+    /*! 
+     * Block until GTOP publishes the next fix or TimeoutMS passes.
+     * true if Update has something to return. 
+     */
+    bool Wait(uint32_t TimeoutMS);
+
+    /*! Fixes lost, overwritten before we read them. */
+    uint64_t Missed(void) const;
+
     /** access RMC */
     inline RMC* GetRMC(void) {return fRMC;};
 
@@ -53,20 +75,33 @@ private:
     GSA        *fGSA;
 
     /**
-     * Shared memory for position data. GPGGA
+     * Shared memory for position data. GPGGA, GGA_Snap
      */
-    SharedMem2   *pSM_PositionData;
+    SMSnapshot   *pSM_PositionData;
     /**
-     * Shared memory for Solution Data GPGSA
+     * Shared memory for Solution Data GPGSA, GSA_Snap
      */
-    SharedMem2   *pSM_SolutionData;
+    SMSnapshot   *pSM_SolutionData;
     /**
-     * Shared memory for velocity data. GPVTG
+     * Shared memory for velocity data. GPVTG, VTG_Snap
      */
-    SharedMem2   *pSM_VelocityData;
+    SMSnapshot   *pSM_VelocityData;
+    /**
+     * SharedMemory with GPS time and delta. RMC_Snap
+     */
+    SMSnapshot   *pSM_Minimum;
+
+    /**
+     * One epoch, GGA, GSA, VTG and RMC written together by GTOP.
+     * When present it replaces everything below. 
+     */
+    SMSnapshot   *fFixSnap;
+    GPSFix       *fFix;
+
     /**
-     * SharedMemory with GPS time and delta. 
+     * Every fix, replaces the GGA and RMC snapshots when present. 
      */
-    SharedMem2   *pSM_Minimum;
+    SMRing       *fGGARing;
+    SMRing       *fRMCRing;
 };
 #endif
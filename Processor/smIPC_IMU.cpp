@@ -9,6 +9,10 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  IMU_Ring and IMUScale. 
+ * 17-Oct-26  CBL  IMU_Snap in place of the IMU LAM. 
+ * 17-Oct-26  CBL  IMU_Snap and IMU_Ring layouts checked against the
+ *                 registry. 
  *
  * Classification : Unclassified
  *
@@ -67,9 +71,12 @@ IMU_IPC::IMU_IPC(void) : CObject()
     pSM          = NULL;
     fSM_Filename = NULL;
     fIMU         = NULL;
+    fRing        = NULL;
+    fNSamples    = 0;
+    memset(&fScale, 0, sizeof(fScale));
 
-    pSM = new SharedMem2("IMU");
-    if (pSM->CheckError())
+    pSM = new SMSnapshot("IMU_Snap");
+    if (pSM->CheckError() || !pSM->Expect(IMUData::Schema()))
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',"IMU data SM failed.");
 	delete pSM;
@@ -98,6 +105,26 @@ IMU_IPC::IMU_IPC(void) : CObject()
 
     fIMU = new IMUData();
 
+    /*
+     * The scale is written once when IMU starts, read it once here. 
+     * Without it, or the ring, fall back on IMU_Snap. 
+     */
+    SharedMem2 *pScale = new SharedMem2("IMUScale");
+    if (!pScale->CheckError())
+    {
+	pScale->GetData(&fScale);
+	fRing = new SMRing("IMU_Ring");
+	if (fRing->CheckError() || (fRing->RecordSize() != sizeof(IMURaw)) ||
+	    !fRing->Expect(IMURawSchema()) || (fScale.Acc == 0.0))
+	{
+	    delete fRing;
+	    fRing = NULL;
+	}
+    }
+    delete pScale;
+    plogger->Log("# IMU %s\n", fRing ? "IMU_Ring attached." : 
+		 "ring not available, polling IMU_Snap.");
+
     SET_DEBUG_STACK;
 }
 
@@ -134,16 +161,26 @@ bool IMU_IPC::Update(void)
      * Check to see if the SM placement is new???
      */
 
-    if (fIMU && pSM)
+    fNSamples = 0;
+    if (fIMU && fRing)
     {
-	/* Is the data "new" */
-	if (pSM->GetLAM())
+	IMURaw Raw, Last;
+	while (fRing->Get(&Raw))
+	{
+	    Last = Raw;
+	    fNSamples++;
+	}
+	if (fNSamples > 0)
 	{
-	    pSM->GetData(fIMU->DataPointer());
-	    pSM->ClearLAM();
+	    fIMU->FromRaw(Last, fScale);
 	    rv = true;
 	}
     }
+    else if (fIMU && pSM)
+    {
+	if (pSM->Get(fIMU->DataPointer()))
+	    rv = true;
+    }
     SET_DEBUG_STACK;
     return rv;
 }
@@ -207,6 +244,7 @@ IMU_IPC::~IMU_IPC(void)
     SET_DEBUG_STACK;
     delete pSM;
     delete fSM_Filename;
+    delete fRing;
     SET_DEBUG_STACK;
 }
 
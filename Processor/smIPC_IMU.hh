@@ -11,6 +11,8 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  Every sample from IMU_Ring when available. 
+ * 17-Oct-26  CBL  Fall back on IMU_Snap rather than the IMU LAM. 
  *
  * Classification : Unclassified
  *
@@ -23,6 +25,8 @@
 #   include "ICM-20948.hh"
 #   include "SharedMem2.hh"
 #   include "IMUData.hh"
+#   include "SMRing.hh"
+#   include "SMSnapshot.hh"
 
 class IMU_IPC : public CObject 
 {
@@ -31,9 +35,20 @@ public:
     IMU_IPC(void);
     /*! Destructor */
     ~IMU_IPC(void);
-    /*! Get the data */
+    /*! 
+     * Get the data, true if there is something new. With IMU_Ring
+     * every sample since the last call is taken, fIMU holds the
+     * latest. 
+     */
     bool Update(void);
 
+    /*! Samples taken by the last Update. */
+    inline uint32_t NSamples(void) const {return fNSamples;};
+
+    /*! Samples the ring overwrote before we read them. */
+    inline uint64_t Missed(void) const 
+	{return fRing ? fRing->Missed() : 0;};
+
     /*! Get filename in shared memory. */
     void UpdateFilename(void);
 
@@ -42,14 +57,21 @@ public:
 
 private:
     /**
-     * Shared memory for position data. GPGGA
+     * Latest IMUData, IMU_Snap. 
      */
-    SharedMem2   *pSM;
+    SMSnapshot   *pSM;
     IMUData      *fIMU;
 
     /**
      * Shared memory segment for current data file name. 
      */
     SharedMem2   *fSM_Filename;
+
+    /**
+     * Every sample as counts and the conversions for them. 
+     */
+    SMRing       *fRing;
+    IMUScale     fScale;
+    uint32_t     fNSamples;
 };
 #endif
@@ -0,0 +1,793 @@
+/********************************************************************
+ *
+ * Module Name : SMBench.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Shared memory publish to observe latency benchmark.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <atomic>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SharedMem2.hh"
+#include "SMSnapshot.hh"
+#include "SMRing.hh"
+#include "SMBench.hh"
+
+/*! Transport names, on the command line and in the CSV. */
+static const char *kTransportName[SMBench::kNTransport] = {"sem", "snap", "ring"};
+
+/*! Segment names, apart from the DAQ ones. */
+static const char *kSegmentName[SMBench::kNTransport] =
+    {"Bench_Sem", "Bench_Snap", "Bench_Ring"};
+
+/*! Ring depth for the ring transport. */
+static const uint32_t kRingDepth = 1024;
+
+/*! A consumer gives up this long after the last Put, ns. */
+static const uint64_t kDrainNS = 200000000ULL;
+
+/*!
+ * Shared between the processes of one run, anonymous memory mapped
+ * before the forks.
+ */
+struct BenchControl {
+    uint32_t              Consumers;  // this run
+    std::atomic<uint32_t> Created;    // producer has the segment up
+    std::atomic<uint32_t> Attached;   // consumers ready
+    std::atomic<uint32_t> Done;       // last record published
+    std::atomic<uint32_t> Stop;       // consumers finished
+    std::atomic<uint32_t> Failed;
+    std::atomic<uint64_t> DoneNS;
+    BenchStats Producer;
+    BenchStats Consumer[SMBench::kMaxConsumers];
+};
+static BenchControl *Control = NULL;
+
+/*! Start of every record. */
+struct BenchRecord {
+    uint64_t Seq;       // 1 to Messages
+    uint64_t SentNS;    // CLOCK_MONOTONIC just before the Put
+};
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Now, CPUTime, Pause
+ *
+ * Description : Clock helpers, ns.
+ *
+ * Unit Tested by: CBL
+ *
+ *******************************************************************
+ */
+static inline uint64_t Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec*1000000000ULL + t.tv_nsec;
+}
+static uint64_t CPUTime(void)
+{
+    struct rusage r;
+    getrusage(RUSAGE_SELF, &r);
+    return ((uint64_t)(r.ru_utime.tv_sec + r.ru_stime.tv_sec))*1000000000ULL +
+	((uint64_t)(r.ru_utime.tv_usec + r.ru_stime.tv_usec))*1000ULL;
+}
+static void Pause(uint64_t ns)
+{
+    struct timespec t;
+    t.tv_sec  = ns / 1000000000ULL;
+    t.tv_nsec = ns % 1000000000ULL;
+    nanosleep(&t, NULL);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : BenchHist::Add
+ *
+ * Description : Bin one latency. Below 8ns one bin a ns, above
+ *     that kSub bins per power of two.
+ *
+ * Inputs : ns - latency
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void BenchHist::Add(uint64_t ns)
+{
+    uint32_t idx, e;
+
+    if (ns < kSub)
+    {
+	idx = (uint32_t) ns;
+    }
+    else
+    {
+	e   = 63 - __builtin_clzll(ns);
+	idx = kSub + (e-3)*kSub + (uint32_t)((ns >> (e-3)) & (kSub-1));
+    }
+    if (idx >= kBins)
+	idx = kBins-1;
+    Bin[idx]++;
+    Count++;
+    SumNS += ns;
+    if (ns > MaxNS)
+	MaxNS = ns;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : BenchHist::Merge
+ *
+ * Description : Add another histogram into this one.
+ *
+ * Inputs : h - histogram
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void BenchHist::Merge(const BenchHist &h)
+{
+    for (uint32_t i=0;i<kBins;i++)
+	Bin[i] += h.Bin[i];
+    Count += h.Count;
+    SumNS += h.SumNS;
+    if (h.MaxNS > MaxNS)
+	MaxNS = h.MaxNS;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : BenchHist::Percentile
+ *
+ * Description : Walk the bins to fraction q of the count.
+ *
+ * Inputs : q - 0 to 1
+ *
+ * Returns : upper edge of that bin, ns, never above MaxNS
+ *
+ * Error Conditions : 0 if empty
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t BenchHist::Percentile(double q) const
+{
+    uint64_t want, sum = 0, edge;
+    uint32_t i, e, m;
+
+    if (Count == 0)
+	return 0;
+    want = (uint64_t)(q * (double) Count);
+    if (want >= Count)
+	want = Count-1;
+    for (i = 0; i < kBins; i++)
+    {
+	sum += Bin[i];
+	if (sum > want)
+	    break;
+    }
+    if (i < kSub)
+    {
+	edge = i+1;
+    }
+    else
+    {
+	e    = (i - kSub)/kSub + 3;
+	m    = (i - kSub)%kSub;
+	edge = ((uint64_t)(kSub + m + 1)) << (e-3);
+    }
+    return (edge < MaxNS) ? edge : MaxNS;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMBench constructor
+ *
+ * Description : Check the arguments.
+ *
+ * Inputs : see SMBench.hh
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : SetError(-1) on a bad argument
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMBench::SMBench(const char *Transports, uint32_t MaxConsumers,
+		 uint32_t Messages, double Rate, uint32_t RecordSize,
+		 uint32_t PollUS, const char *CSV, const char *Label)
+    : CObject()
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    string  List(Transports);
+    string  Name;
+    size_t  at = 0, comma;
+    int     i;
+
+    SetName("SMBench");
+    SetError();
+
+    fMaxConsumers = MaxConsumers;
+    fMessages     = Messages;
+    fRate         = Rate;
+    fRecordSize   = RecordSize;
+    fPollUS       = PollUS;
+    fCSV          = CSV;
+    fLabel        = Label;
+
+    while (at <= List.size())
+    {
+	comma = List.find(',', at);
+	if (comma == string::npos)
+	    comma = List.size();
+	Name = List.substr(at, comma - at);
+	for (i = 0; i < kNTransport; i++)
+	{
+	    if (Name == kTransportName[i])
+		break;
+	}
+	if (i == kNTransport)
+	{
+	    Logger->Log("# SMBench unknown transport %s\n", Name.c_str());
+	    SetError(-1);
+	}
+	else
+	{
+	    fTransports.push_back(i);
+	}
+	at = comma + 1;
+    }
+
+    if ((fMaxConsumers < 1) || (fMaxConsumers > kMaxConsumers) ||
+	(fMessages < 1) || (fRecordSize < sizeof(BenchRecord)) ||
+	(fRate < 0.0))
+    {
+	Logger->Log("# SMBench bad arguments.\n");
+	SetError(-1);
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMBench destructor
+ *
+ * Description : NONE
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMBench::~SMBench(void)
+{
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Do
+ *
+ * Description : Each transport, 1 to MaxConsumers consumers.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : a failed run is logged and skipped
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMBench::Do(void)
+{
+    SET_DEBUG_STACK;
+    size_t   t;
+    uint32_t n;
+
+    Control = (BenchControl *) mmap(NULL, sizeof(BenchControl),
+				    PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (Control == MAP_FAILED)
+    {
+	CLogger::GetThis()->Log("# SMBench control block: %s\n",
+				strerror(errno));
+	Control = NULL;
+	return;
+    }
+
+    printf("%-5s %3s %9s %9s %9s %9s %9s %9s %9s %8s %8s\n",
+	   "tport", "N", "recv", "missed", "p50 us", "p99 us", "p999 us",
+	   "max us", "msg/s", "Pcpu us", "Ccpu us");
+    for (t = 0; t < fTransports.size(); t++)
+    {
+	for (n = 1; n <= fMaxConsumers; n++)
+	{
+	    if (Run(fTransports[t], n))
+		Report(fTransports[t], n);
+	}
+    }
+    munmap(Control, sizeof(BenchControl));
+    Control = NULL;
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Run
+ *
+ * Description : Fork the producer, let it create the segment, fork
+ *     the consumers, wait for them, then release the producer.
+ *
+ * Inputs :
+ *     Transport - kSem ...
+ *     Consumers - how many
+ *
+ * Returns : true if every process finished cleanly
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMBench::Run(int Transport, uint32_t Consumers)
+{
+    SET_DEBUG_STACK;
+    pid_t    Producer, pid;
+    pid_t    Pids[kMaxConsumers];
+    uint32_t i, n = 0;
+    int      status;
+    bool     rv = true;
+
+    memset((void *) Control, 0, sizeof(BenchControl));
+    Control->Consumers = Consumers;
+    fflush(stdout);
+
+    Producer = fork();
+    if (Producer == 0)
+    {
+	this->Producer(Transport);
+	_exit(0);
+    }
+    if (Producer < 0)
+    {
+	CLogger::GetThis()->Log("# SMBench fork: %s\n", strerror(errno));
+	return false;
+    }
+
+    while (!Control->Created.load() && !Control->Failed.load())
+	Pause(1000000);
+
+    for (i = 0; (i < Consumers) && !Control->Failed.load(); i++)
+    {
+	pid = fork();
+	if (pid == 0)
+	{
+	    Consumer(Transport, i);
+	    _exit(0);
+	}
+	if (pid < 0)
+	{
+	    CLogger::GetThis()->Log("# SMBench fork: %s\n", strerror(errno));
+	    Control->Failed.store(1);
+	}
+	else
+	{
+	    Pids[n++] = pid;
+	}
+    }
+
+    // Consumers first, the producer keeps the segment up for them.
+    for (i = 0; i < n; i++)
+    {
+	if ((waitpid(Pids[i], &status, 0) < 0) || !WIFEXITED(status) ||
+	    (WEXITSTATUS(status) != 0))
+	    rv = false;
+    }
+    Control->Stop.store(1);
+    if ((waitpid(Producer, &status, 0) < 0) || !WIFEXITED(status) ||
+	(WEXITSTATUS(status) != 0))
+	rv = false;
+    if (Control->Failed.load())
+    {
+	CLogger::GetThis()->Log("# SMBench %s with %u consumers failed.\n",
+				kTransportName[Transport], Consumers);
+	rv = false;
+    }
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Producer
+ *
+ * Description : Create the segment, wait for the consumers, publish
+ *     Messages records at Rate on absolute deadlines, stamping each
+ *     just before the Put, then hold the segment until the
+ *     consumers are done.
+ *
+ * Inputs : Transport - kSem ...
+ *
+ * Returns : NONE, in the child
+ *
+ * Error Conditions : Control->Failed
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMBench::Producer(int Transport)
+{
+    SharedMem2  *Sem  = NULL;
+    SMSnapshot  *Snap = NULL;
+    SMRing      *Ring = NULL;
+    uint8_t     *Buffer = new uint8_t[fRecordSize];
+    BenchRecord *r = (BenchRecord *) Buffer;
+    struct timespec Deadline;
+    uint64_t    Period = (fRate > 0.0) ? (uint64_t)(1.0e9/fRate) : 0;
+    uint64_t    t0, c0, i, Wait;
+    bool        Bad;
+
+    memset(Buffer, 0, fRecordSize);
+    switch (Transport)
+    {
+    case kSem:
+	Sem  = new SharedMem2(kSegmentName[Transport], fRecordSize, true);
+	Bad  = Sem->CheckError();
+	break;
+    case kSnap:
+	Snap = new SMSnapshot(kSegmentName[Transport], fRecordSize);
+	Bad  = Snap->CheckError();
+	break;
+    default:
+	Ring = new SMRing(kSegmentName[Transport], fRecordSize, kRingDepth);
+	Bad  = Ring->CheckError();
+	break;
+    }
+    if (Bad)
+    {
+	Control->Failed.store(1);
+	return;
+    }
+    Control->Created.store(1);
+
+    // Everyone attached, and a little longer for them to block.
+    for (Wait = 0; Control->Attached.load() < Control->Consumers; Wait++)
+    {
+	if (Control->Failed.load())
+	    return;
+	if (Wait == 5000)
+	{
+	    Control->Failed.store(1);
+	    return;
+	}
+	Pause(1000000);
+    }
+    Pause(20000000);
+
+    c0 = CPUTime();
+    t0 = Now();
+    clock_gettime(CLOCK_MONOTONIC, &Deadline);
+    for (i = 1; i <= fMessages; i++)
+    {
+	if (Period > 0)
+	{
+	    Deadline.tv_nsec += (long) Period;
+	    while (Deadline.tv_nsec >= 1000000000L)
+	    {
+		Deadline.tv_sec++;
+		Deadline.tv_nsec -= 1000000000L;
+	    }
+	    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL);
+	}
+	r->Seq    = i;
+	r->SentNS = Now();
+	if (Sem)
+	    Sem->PutData(Buffer);
+	else if (Snap)
+	    Snap->Put(Buffer);
+	else
+	    Ring->Put(Buffer);
+    }
+    Control->Producer.WallNS   = Now() - t0;
+    Control->Producer.CPUNS    = CPUTime() - c0;
+    Control->Producer.Received = fMessages;
+    Control->DoneNS.store(Now());
+    Control->Done.store(1);
+
+    while (Control->Stop.load() == 0 && !Control->Failed.load())
+	Pause(1000000);
+
+    delete Sem;
+    delete Snap;
+    delete Ring;
+    delete [] Buffer;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Consumer
+ *
+ * Description : Attach and take records until the last one, or
+ *     kDrainNS after the producer finished. Duplicates are not
+ *     counted, gaps in Seq are Missed.
+ *
+ * Inputs :
+ *     Transport - kSem ...
+ *     Index     - which consumer, where the stats go
+ *
+ * Returns : NONE, in the child
+ *
+ * Error Conditions : Control->Failed
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMBench::Consumer(int Transport, uint32_t Index)
+{
+    BenchStats  &s    = Control->Consumer[Index];
+    SharedMem2  *Sem  = NULL;
+    SMSnapshot  *Snap = NULL;
+    SMRing      *Ring = NULL;
+    uint8_t     *Buffer = new uint8_t[fRecordSize];
+    BenchRecord *r = (BenchRecord *) Buffer;
+    uint64_t    Last = 0, c0, t0 = 0, t1 = 0, now;
+    bool        Got, Bad;
+
+    switch (Transport)
+    {
+    case kSem:
+	Sem  = new SharedMem2(kSegmentName[Transport]);
+	Bad  = Sem->CheckError();
+	break;
+    case kSnap:
+	Snap = new SMSnapshot(kSegmentName[Transport]);
+	Bad  = Snap->CheckError();
+	break;
+    default:
+	Ring = new SMRing(kSegmentName[Transport]);
+	Bad  = Ring->CheckError();
+	break;
+    }
+    if (Bad)
+    {
+	Control->Failed.store(1);
+	return;
+    }
+    Control->Attached.fetch_add(1);
+
+    c0 = CPUTime();
+    while (Last < fMessages)
+    {
+	Got = false;
+	if (Sem)
+	{
+	    if (Sem->GetLAM())
+	    {
+		Sem->GetData(Buffer);
+		Sem->ClearLAM();
+		Got = true;
+	    }
+	    else
+	    {
+		Pause((uint64_t) fPollUS * 1000ULL);
+	    }
+	}
+	else if (Snap)
+	{
+	    Got = Snap->Wait(100) && Snap->Get(Buffer);
+	}
+	else if (Ring->Wait(100))
+	{
+	    Got = Ring->Get(Buffer);
+	}
+
+	now = Now();
+	while (Got)
+	{
+	    if (r->Seq > Last)
+	    {
+		if (Last == 0)
+		    t0 = now;
+		t1 = now;
+		s.Missed += r->Seq - Last - 1;
+		s.Received++;
+		s.Latency.Add(now - r->SentNS);
+		Last = r->Seq;
+	    }
+	    // A ring may hold more than one.
+	    Got = Ring && Ring->Get(Buffer);
+	    now = Now();
+	}
+
+	if (Control->Failed.load() || (Control->Done.load() &&
+				       (now > Control->DoneNS.load() + kDrainNS)))
+	    break;
+    }
+    s.Missed += fMessages - Last;
+    s.CPUNS   = CPUTime() - c0;
+    s.WallNS  = t1 - t0;
+
+    delete Sem;
+    delete Snap;
+    delete Ring;
+    delete [] Buffer;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Report
+ *
+ * Description : Merge the consumers, one line to stdout, one row
+ *     to the CSV file with a header if the file is new.
+ *
+ * Inputs :
+ *     Transport - kSem ...
+ *     Consumers - how many
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CSV open failure, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMBench::Report(int Transport, uint32_t Consumers)
+{
+    SET_DEBUG_STACK;
+    BenchHist   *All = new BenchHist();
+    uint64_t    Received = 0, Missed = 0, CPU = 0;
+    double      Mean, Published, PCPU, CCPU;
+    struct stat st;
+    char        Host[64], Date[32];
+    time_t      t = time(NULL);
+    struct tm   lt;
+    FILE        *fp;
+    bool        New;
+    uint32_t    i;
+
+    memset(All, 0, sizeof(BenchHist));
+    for (i = 0; i < Consumers; i++)
+    {
+	All->Merge(Control->Consumer[i].Latency);
+	Received += Control->Consumer[i].Received;
+	Missed   += Control->Consumer[i].Missed;
+	CPU      += Control->Consumer[i].CPUNS;
+    }
+    Mean      = All->Count ? 1.0e-3 * (double) All->SumNS / (double) All->Count
+	: 0.0;
+    Published = Control->Producer.WallNS ?
+	1.0e9 * (double) fMessages / (double) Control->Producer.WallNS : 0.0;
+    PCPU      = 1.0e-3 * (double) Control->Producer.CPUNS / (double) fMessages;
+    CCPU      = Received ? 1.0e-3 * (double) CPU / (double) Received : 0.0;
+
+    printf("%-5s %3u %9llu %9llu %9.1f %9.1f %9.1f %9.1f %9.0f %8.2f %8.2f\n",
+	   kTransportName[Transport], Consumers,
+	   (unsigned long long) Received, (unsigned long long) Missed,
+	   1.0e-3*All->Percentile(0.50), 1.0e-3*All->Percentile(0.99),
+	   1.0e-3*All->Percentile(0.999), 1.0e-3*All->MaxNS,
+	   Published, PCPU, CCPU);
+
+    New = (stat(fCSV.c_str(), &st) != 0) || (st.st_size == 0);
+    fp  = fopen(fCSV.c_str(), "a");
+    if (!fp)
+    {
+	CLogger::GetThis()->Log("# SMBench %s: %s\n", fCSV.c_str(),
+				strerror(errno));
+	delete All;
+	return;
+    }
+    if (New)
+    {
+	fprintf(fp, "label,date,host,transport,consumers,messages,rate_hz,"
+		"record_bytes,poll_us,published_per_s,received,missed,"
+		"mean_us,p50_us,p90_us,p99_us,p999_us,max_us,"
+		"producer_cpu_us_per_msg,consumer_cpu_us_per_msg\n");
+    }
+    gethostname(Host, sizeof(Host));
+    Host[sizeof(Host)-1] = 0;
+    localtime_r(&t, &lt);
+    strftime(Date, sizeof(Date), "%Y-%m-%dT%H:%M:%S", &lt);
+    fprintf(fp, "%s,%s,%s,%s,%u,%u,%g,%u,%u,%.1f,%llu,%llu,"
+	    "%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f\n",
+	    fLabel.c_str(), Date, Host, kTransportName[Transport], Consumers,
+	    fMessages, fRate, fRecordSize,
+	    (Transport == kSem) ? fPollUS : 0, Published,
+	    (unsigned long long) Received, (unsigned long long) Missed,
+	    Mean, 1.0e-3*All->Percentile(0.50), 1.0e-3*All->Percentile(0.90),
+	    1.0e-3*All->Percentile(0.99), 1.0e-3*All->Percentile(0.999),
+	    1.0e-3*All->MaxNS, PCPU, CCPU);
+    fclose(fp);
+    delete All;
+    SET_DEBUG_STACK;
+}
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMBench.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Inter-process latency benchmark for the shared
+ *     memory layer. For each transport and each consumer count a
+ *     producer process and N consumer processes are forked. The
+ *     producer stamps every record with CLOCK_MONOTONIC as it
+ *     publishes, each consumer histograms the time until it has the
+ *     record in hand. Transports,
+ *
+ *         sem   SharedMem2, PutData then GetLAM/GetData/ClearLAM
+ *               polled every PollUS, as the DAQ programs did
+ *         snap  SMSnapshot, Put then Wait/Get
+ *         ring  SMRing, Put then Wait/Get
+ *
+ *     One CSV row per run, appended so releases can be compared,
+ *     latency percentiles, messages seen and missed, throughput and
+ *     CPU per message on each side.
+ *
+ * Restrictions/Limitations :
+ *     Run it on an otherwise quiet machine, and with the DAQ
+ *     programs stopped, the segment names do not collide with
+ *     theirs but the CPUs are shared.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SMBENCH_hh_
+#define __SMBENCH_hh_
+#  include <stdint.h>
+#  include <string>
+#  include <vector>
+#  include "CObject.hh"
+
+/*!
+ * Latency histogram, log spaced, 8 bins per power of two of ns so
+ * percentiles are good to about 12%. Plain data, it lives in the
+ * shared control block.
+ */
+struct BenchHist {
+    static const uint32_t kSub  = 8;
+    static const uint32_t kBins = 8 + 61*kSub;
+
+    uint64_t Count;
+    uint64_t SumNS;
+    uint64_t MaxNS;
+    uint64_t Bin[kBins];
+
+    void Add(uint64_t ns);
+    void Merge(const BenchHist &h);
+    /*! Upper edge of the bin holding fraction q, ns. */
+    uint64_t Percentile(double q) const;
+};
+
+/*! What each process reports back. */
+struct BenchStats {
+    uint64_t  Received;   // distinct records seen
+    uint64_t  Missed;     // overwritten before this reader saw them
+    uint64_t  CPUNS;      // user + system
+    uint64_t  WallNS;     // first to last record
+    BenchHist Latency;
+};
+
+class SMBench : public CObject
+{
+public:
+    /*! Transports */
+    enum {kSem=0, kSnap, kRing, kNTransport};
+
+    /*!
+     * Description:
+     *   Set up a benchmark.
+     *
+     * Arguments:
+     *   Transports   - comma separated, sem,snap,ring
+     *   MaxConsumers - runs for 1 to MaxConsumers consumers
+     *   Messages     - records published per run
+     *   Rate         - records a second, 0 as fast as possible
+     *   RecordSize   - bytes a record, at least 16
+     *   PollUS       - sleep between polls for sem
+     *   CSV          - results file, appended
+     *   Label        - first CSV column, e.g. a release tag
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   Error() non zero on bad arguments.
+     */
+    SMBench(const char *Transports, uint32_t MaxConsumers,
+	    uint32_t Messages, double Rate, uint32_t RecordSize,
+	    uint32_t PollUS, const char *CSV, const char *Label);
+    ~SMBench(void);
+
+    /*! Every run, rows to the CSV file and a summary to stdout. */
+    void Do(void);
+
+    static const uint32_t kMaxConsumers = 16;
+
+private:
+    std::vector<int> fTransports;
+    uint32_t    fMaxConsumers;
+    uint32_t    fMessages;
+    double      fRate;
+    uint32_t    fRecordSize;
+    uint32_t    fPollUS;
+    std::string fCSV;
+    std::string fLabel;
+
+    bool Run(int Transport, uint32_t Consumers);
+    void Producer(int Transport);
+    void Consumer(int Transport, uint32_t Index);
+    void Report(int Transport, uint32_t Consumers);
+};
+#endif
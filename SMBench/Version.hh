@@ -0,0 +1,29 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Version.hh 
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Software versioning information
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *
+ *******************************************************************
+ */
+#ifndef __Version_hh_
+#define __Version_hh_
+
+
+#define XXXX_RELEASE "0.01/01"
+#define XXXX_VERSION(a,b,c) (((a) << 16) + ((b) << 8) + (c))
+#define MAJOR_VERSION 0
+#define MINOR_VERSION 1
+#endif
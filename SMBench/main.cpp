@@ -0,0 +1,229 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : main.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Shared memory latency benchmark, see SMBench.hh
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+// System includes.
+#include <iostream>
+using namespace std;
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+/// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "Version.hh"
+#include "SMBench.hh"
+
+/** Control the verbosity of the program output via the bits shown. */
+static unsigned int VerboseLevel = 0;
+
+/** Pointer to the logger structure. */
+static CLogger   *logger;
+
+/** Command line settings. */
+static const char  *Transports   = "sem,snap,ring";
+static unsigned int MaxConsumers = 5;
+static unsigned int Messages     = 2000;
+static double       Rate         = 1000.0;
+static unsigned int RecordSize   = 64;
+static unsigned int PollUS       = 100;
+static const char  *CSV          = "SMBench.csv";
+static const char  *Label        = "";
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Help
+ *
+ * Description : provides user with help if needed.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+static void Help(void)
+{
+    SET_DEBUG_STACK;
+    cout << "********************************************" << endl;
+    cout << "* Shared memory latency benchmark.         *" << endl;
+    cout << "* Built on "<< __DATE__ << " " << __TIME__ << "*" << endl;
+    cout << "* Available options are :                  *" << endl;
+    cout << "*  -t sem,snap,ring transports             *" << endl;
+    cout << "*  -n max consumers, 1 to n are run (5)    *" << endl;
+    cout << "*  -m messages per run (2000)              *" << endl;
+    cout << "*  -r rate Hz, 0 flat out (1000)           *" << endl;
+    cout << "*  -s record size bytes (64)               *" << endl;
+    cout << "*  -p sem poll interval us (100)           *" << endl;
+    cout << "*  -o CSV file, appended (SMBench.csv)     *" << endl;
+    cout << "*  -l label for the CSV rows               *" << endl;
+    cout << "*  -v verbose level                        *" << endl;
+    cout << "*                                          *" << endl;
+    cout << "********************************************" << endl;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name :  ProcessCommandLineArgs
+ *
+ * Description : Loop over all command line arguments
+ *               and parse them into useful data.
+ *
+ * Inputs : command line arguments.
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+static void
+ProcessCommandLineArgs(int argc, char **argv)
+{
+    int option;
+    SET_DEBUG_STACK;
+    do
+    {
+        option = getopt( argc, argv, "hHt:n:m:r:s:p:o:l:v:");
+        switch(option)
+        {
+        case 'h':
+        case 'H':
+            Help();
+	    exit(0);
+	    break;
+	case 't':
+	    Transports = optarg;
+	    break;
+	case 'n':
+	    MaxConsumers = atoi(optarg);
+	    break;
+	case 'm':
+	    Messages = atoi(optarg);
+	    break;
+	case 'r':
+	    Rate = atof(optarg);
+	    break;
+	case 's':
+	    RecordSize = atoi(optarg);
+	    break;
+	case 'p':
+	    PollUS = atoi(optarg);
+	    break;
+	case 'o':
+	    CSV = optarg;
+	    break;
+	case 'l':
+	    Label = optarg;
+	    break;
+	case 'v':
+	    VerboseLevel = atoi(optarg);
+            break;
+        }
+    } while(option != -1);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Initialize
+ *
+ * Description : Initialze the process
+ *               - Setup traceback utility
+ *               - Perform any user initialization
+ *
+ * Inputs : none
+ *
+ * Returns : true on success.
+ *
+ * Error Conditions : depends mostly on user code
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+static bool Initialize(void)
+{
+    SET_DEBUG_STACK;
+    char   msg[32];
+    double version;
+
+    // User initialization goes here.
+    sprintf(msg, "%d.%d",MAJOR_VERSION, MINOR_VERSION);
+    version = atof( msg);
+    logger = new CLogger("SMBench.log", "SMBench", version);
+    logger->SetVerbose(VerboseLevel);
+
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : main
+ *
+ * Description : It all starts here:
+ *               - Process any command line arguments
+ *               - Do any necessary initialization as a result of that
+ *               - Do the operations
+ *
+ * Inputs : command line arguments
+ *
+ * Returns : exit code
+ *
+ * Error Conditions :
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int main(int argc, char **argv)
+{
+    int rc = 1;
+
+    ProcessCommandLineArgs(argc, argv);
+    if (Initialize())
+    {
+	SMBench *pBench = new SMBench(Transports, MaxConsumers, Messages,
+				      Rate, RecordSize, PollUS, CSV, Label);
+
+	if (pBench->Error() == 0)
+	{
+	    pBench->Do();
+	    rc = 0;
+	}
+	delete pBench;
+    }
+    delete logger;
+    return rc;
+}
@@ -12,6 +12,7 @@
  * Change Descriptions : 
  * 24-Mar-24  Added in sm to log the difference in GPS time with the 
  *            NTP difference. 
+ * 17-Oct-26  CBL RealTime profile applied at the start of Do.
  *
  * Classification : Unclassified
  *
@@ -45,6 +46,7 @@ using namespace libconfig;
 /// Local Includes.
 #include "Timing.hh"
 #include "queryTimeServer.hh"
+#include "RealTime.hh"
 #include "CLogger.hh"
 #include "tools.h"
 #include "debug.h"
@@ -86,6 +88,7 @@ Timing::Timing(const char* ConfigFile) : CObject()
     fQS  = NULL;
     fNSamples = 1;
     fSampleRate = 1;
+    fRT         = new RealTime();
 
     /* 
      * Set defaults for configuration file. 
@@ -165,6 +168,7 @@ Timing::~Timing(void)
     }
     free(fConfigFileName);
     delete fIPC;
+    delete fRT;
 
     /* Clean up */
     delete f5Logger;
@@ -219,6 +223,8 @@ void Timing::Do(void)
     uint32_t         idt;
     double           gpsDelta = 0.0;
 
+    fRT->Apply();
+
     fRun = true;
 
     // Run until user requests a stop OR time is exceeded. 
@@ -450,6 +456,7 @@ bool Timing::ReadConfiguration(void)
 	MM.lookupValue("Server",    ServerAddress);
 	MM.lookupValue("Samples",   fNSamples);
 	MM.lookupValue("SampleRate",fSampleRate);
+	fRT->ReadConfiguration(MM);
 	SetDebug(Debug);
     }
     catch(const SettingNotFoundException &nfex)
@@ -521,6 +528,7 @@ bool Timing::WriteConfiguration(void)
     }
     MM.add("Samples",     Setting::TypeInt)     = fNSamples;
     MM.add("SampleRate",  Setting::TypeInt)     = fSampleRate;
+    fRT->WriteConfiguration(MM);
 
     // Write out the new configuration.
     try
@@ -11,6 +11,7 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions :
+ * 17-Oct-26  CBL  RealTime profile from the configuration.
  *
  * Classification : Unclassified
  *
@@ -27,6 +28,7 @@
 #  include "smIPC.hh"
 
 class QueryTS;
+class RealTime;
 
 class Timing : public CObject
 {
@@ -91,6 +93,9 @@ private:
      */
     char        *fConfigFileName;
 
+    /*! Scheduling, affinity and memory locking for the Do loop. */
+    RealTime    *fRT;
+
     /* Collection of configuration parameters. */
     bool        fLogging;       /*! Turn logging on. */
 
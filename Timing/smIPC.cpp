@@ -9,6 +9,9 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  Position from GGA_Snap, no LAM. 
+ * 17-Oct-26  CBL  Position from GPS_Fix. 
+ * 17-Oct-26  CBL  GPS_Fix layout checked against the registry. 
  *
  * Classification : Unclassified
  *
@@ -64,14 +67,17 @@ TIMING_IPC::TIMING_IPC(void) : CObject()
     plogger->LogCommentTimestamp("IPC Initialize, shared memory.");
 
     pSM_Position = NULL;
+    fFix         = NULL;
     fGGA         = NULL;
 
-    // Connect to GGA message if available. 
-    pSM_Position = new SharedMem2("GGA"); 
-    if (pSM_Position->CheckError())
+    // Connect to the GPS fix, GGA, if available. 
+    pSM_Position = new SMSnapshot("GPS_Fix"); 
+    if (pSM_Position->CheckError() ||
+	(pSM_Position->RecordSize() != GPSFix::Size()) ||
+	!pSM_Position->Expect(GPSFix::Schema()))
     {
 	plogger->LogError(__FILE__, __LINE__, 'W',
-			 "GGA data SM failed.");
+			 "GPS_Fix SM failed.");
 	delete pSM_Position;
 	pSM_Position = 0;
 	SET_DEBUG_STACK;
@@ -79,7 +85,8 @@ TIMING_IPC::TIMING_IPC(void) : CObject()
     }
     else
     {
-	plogger->Log("# GGA SM successfully attached.\n");
+	plogger->Log("# GPS_Fix SM successfully attached.\n");
+	fFix = new GPSFix();
     }
     fGGA = new GGA();
 
@@ -138,12 +145,12 @@ GGA* TIMING_IPC::GetPosition(void) const
     SET_DEBUG_STACK;
     if (fGGA && pSM_Position)
     {
-	/* Is the data "new" */
-	if (pSM_Position->GetLAM())
-	{
-	    pSM_Position->GetData(fGGA->DataPointer());
-	    pSM_Position->ClearLAM();
-	}
+	/*
+	 * Only copies if the generation moved since our last look,
+	 * other readers of GPS_Fix are not affected.
+	 */
+	if (pSM_Position->Get(fFix->Buffer()))
+	    fFix->Unpack(fGGA, NULL, NULL, NULL);
     }
     SET_DEBUG_STACK;
     return fGGA;
@@ -173,6 +180,7 @@ TIMING_IPC::~TIMING_IPC(void)
 {
     SET_DEBUG_STACK;
     delete pSM_Position;
+    delete fFix;
     delete fGGA;
     SET_DEBUG_STACK;
 }
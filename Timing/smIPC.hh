@@ -10,6 +10,8 @@
  * Restrictions/Limitations : NONE
  *
  * Change Descriptions : 
+ * 17-Oct-26  CBL  Position from GGA_Snap, no LAM. 
+ * 17-Oct-26  CBL  Position from GPS_Fix, one epoch per read. 
  *
  * Classification : Unclassified
  *
@@ -21,6 +23,8 @@
 #define __SMIPC_hh_
 #   include "SharedMem2.hh"
 #   include "NMEA_GPS.hh"   // to get position data. 
+#   include "SMSnapshot.hh"
+#   include "GPSFix.hh"
 
 class TIMING_IPC : public CObject 
 {
@@ -38,9 +42,12 @@ private:
      */
     SharedMem2   *pSM;
     /**
-     * Position shared memory, read. 
+     * Position shared memory, read. GPS_Fix, this reader keeps its
+     * own generation so it does not take updates from the others.
+     * The GGA is unpacked from the epoch in fFix. 
      */
-    SharedMem2   *pSM_Position;
+    SMSnapshot   *pSM_Position;
+    GPSFix       *fFix;
     GGA          *fGGA;
 };
 #endif
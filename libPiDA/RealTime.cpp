@@ -0,0 +1,334 @@
+/********************************************************************
+ *
+ * Module Name : RealTime.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Real time execution profile, SCHED_FIFO, affinity
+ *     and memory locking for the acquisition thread.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <libconfig.h++>
+using namespace libconfig;
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "RealTime.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : RealTime constructor
+ *
+ * Description : Defaults request nothing.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+RealTime::RealTime(void)
+{
+    fPriority   = 0;
+    fCPU        = -1;
+    fLockMemory = false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : RealTime destructor
+ *
+ * Description : NONE
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+RealTime::~RealTime(void)
+{
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadConfiguration
+ *
+ * Description : Look for Parent.RealTime and read it.
+ *
+ * Inputs : Parent - program configuration group
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void RealTime::ReadConfiguration(const Setting &Parent)
+{
+    SET_DEBUG_STACK;
+    if (Parent.exists("RealTime"))
+    {
+	const Setting &RT = Parent["RealTime"];
+	RT.lookupValue("Priority",   fPriority);
+	RT.lookupValue("CPU",        fCPU);
+	RT.lookupValue("LockMemory", fLockMemory);
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteConfiguration
+ *
+ * Description : Add Parent.RealTime.
+ *
+ * Inputs : Parent - program configuration group
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void RealTime::WriteConfiguration(Setting &Parent) const
+{
+    SET_DEBUG_STACK;
+    Setting &RT = Parent.add("RealTime", Setting::TypeGroup);
+    RT.add("Priority",   Setting::TypeInt)     = (int) fPriority;
+    RT.add("CPU",        Setting::TypeInt)     = (int) fCPU;
+    RT.add("LockMemory", Setting::TypeBoolean) = fLockMemory;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PrefaultStack
+ *
+ * Description : Touch kPrefaultStack of stack, one write per page,
+ *     so the pages are resident before sampling starts. With
+ *     MCL_FUTURE they then stay resident.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void RealTime::PrefaultStack(void)
+{
+    volatile unsigned char Stack[kPrefaultStack];
+    size_t i;
+
+    for (i=0; i<kPrefaultStack; i+=4096)
+    {
+	Stack[i] = 0;
+    }
+    // volatile, the writes above can not be optimized away.
+    (void) Stack[0];
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Apply
+ *
+ * Description : Memory first, so the page faults happen before
+ *     the thread can no longer be preempted, then affinity, then
+ *     the scheduling class.
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if everything asked for was granted.
+ *
+ * Error Conditions : each failing call is logged.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool RealTime::Apply(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    struct sched_param sp;
+    cpu_set_t cpus;
+    bool rv = true;
+    int  rc, pmin, pmax;
+
+    if (fLockMemory)
+    {
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+	{
+	    Logger->Log("# RealTime mlockall: %s\n", strerror(errno));
+	    rv = false;
+	}
+	PrefaultStack();
+    }
+
+    if (fCPU >= 0)
+    {
+	CPU_ZERO(&cpus);
+	CPU_SET(fCPU, &cpus);
+	rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	if (rc != 0)
+	{
+	    Logger->Log("# RealTime CPU %d: %s\n", fCPU, strerror(rc));
+	    rv = false;
+	}
+    }
+
+    if (fPriority > 0)
+    {
+	pmin = sched_get_priority_min(SCHED_FIFO);
+	pmax = sched_get_priority_max(SCHED_FIFO);
+	memset(&sp, 0, sizeof(sp));
+	sp.sched_priority = fPriority;
+	if (sp.sched_priority < pmin) sp.sched_priority = pmin;
+	if (sp.sched_priority > pmax) sp.sched_priority = pmax;
+	rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+	if (rc != 0)
+	{
+	    Logger->Log("# RealTime SCHED_FIFO %d: %s\n",
+			sp.sched_priority, strerror(rc));
+	    rv = false;
+	}
+    }
+
+    Report();
+    if (!rv)
+    {
+	Logger->LogError(__FILE__,__LINE__,'W',
+			 "Real time profile only partly granted.\n");
+    }
+    SET_DEBUG_STACK;
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Report
+ *
+ * Description : Read back the policy, priority, allowed CPUs and
+ *     locked memory (VmLck) and log them next to the request.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void RealTime::Report(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    struct sched_param sp;
+    cpu_set_t cpus;
+    int    policy = SCHED_OTHER;
+    char   CPUList[128];
+    char   line[128];
+    long   Locked = 0;
+    size_t n = 0;
+    int    i;
+    FILE   *fp;
+
+    memset(&sp, 0, sizeof(sp));
+    pthread_getschedparam(pthread_self(), &policy, &sp);
+
+    CPUList[0] = '\0';
+    CPU_ZERO(&cpus);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0)
+    {
+	for (i=0; (i<CPU_SETSIZE) && (n<sizeof(CPUList)-8); i++)
+	{
+	    if (CPU_ISSET(i, &cpus))
+	    {
+		n += snprintf(&CPUList[n], sizeof(CPUList)-n,
+			      "%s%d", (n>0) ? "," : "", i);
+	    }
+	}
+    }
+
+    fp = fopen("/proc/self/status", "r");
+    if (fp)
+    {
+	while (fgets(line, sizeof(line), fp))
+	{
+	    if (sscanf(line, "VmLck: %ld", &Locked) == 1)
+		break;
+	}
+	fclose(fp);
+    }
+
+    Logger->Log("# RealTime requested priority %d CPU %d lock %s\n",
+		fPriority, fCPU, fLockMemory ? "yes" : "no");
+    Logger->Log("# RealTime granted %s priority %d CPUs %s locked %ld kB\n",
+		(policy == SCHED_FIFO) ? "SCHED_FIFO" :
+		(policy == SCHED_RR)   ? "SCHED_RR"   : "SCHED_OTHER",
+		sp.sched_priority, CPUList, Locked);
+}
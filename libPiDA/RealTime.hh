@@ -0,0 +1,117 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : RealTime.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Real time execution profile for an acquisition
+ *     thread. Read from a RealTime subgroup of the program's own
+ *     configuration group, e.g.
+ *
+ *     IMU :
+ *     {
+ *       ...
+ *       RealTime :
+ *       {
+ *         Priority   = 50;     // SCHED_FIFO 1-99, 0 leaves SCHED_OTHER
+ *         CPU        = 3;      // pin to this CPU, -1 any
+ *         LockMemory = true;   // mlockall and prefault the stack
+ *       };
+ *     };
+ *
+ *     Apply is called from the thread doing the sampling, normally
+ *     at the top of Do. Threads created after that inherit the
+ *     policy and affinity, so start helper threads (display,
+ *     logger) first. The report in the log says what the kernel
+ *     actually granted, without CAP_SYS_NICE or a sufficient
+ *     RLIMIT_RTPRIO/RLIMIT_MEMLOCK the requests fail and the
+ *     program carries on as before.
+ *
+ * Restrictions/Limitations :
+ *     Linux only.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     man sched(7), mlockall(2), pthread_setaffinity_np(3)
+ *
+ *******************************************************************
+ */
+#ifndef __REALTIME_hh_
+#define __REALTIME_hh_
+#    include <stdint.h>
+#    include <libconfig.h++>
+
+/// RealTime - SCHED_FIFO, CPU affinity and memory locking.
+class RealTime {
+public:
+    /// Default Constructor, nothing requested.
+    RealTime(void);
+    /// Default destructor
+    ~RealTime(void);
+
+    /*!
+     * Description:
+     *   Pick up the RealTime subgroup of Parent if present.
+     *
+     * Arguments:
+     *   Parent - the program's configuration group
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE, missing keys keep their defaults.
+     */
+    void ReadConfiguration(const libconfig::Setting &Parent);
+
+    /*!
+     * Description:
+     *   Add the RealTime subgroup to Parent.
+     *
+     * Arguments:
+     *   Parent - the program's configuration group
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE
+     */
+    void WriteConfiguration(libconfig::Setting &Parent) const;
+
+    /*!
+     * Description:
+     *   Apply the profile to the calling thread and log what was
+     *   granted.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   true if everything requested was granted.
+     *
+     * Errors:
+     *   Each failure is logged, the rest is still attempted.
+     */
+    bool Apply(void);
+
+    inline int32_t Priority(void)   const {return fPriority;};
+    inline int32_t CPU(void)        const {return fCPU;};
+    inline bool    LockMemory(void) const {return fLockMemory;};
+
+private:
+    /*! Stack touched after mlockall so it is resident. */
+    static const size_t kPrefaultStack = 256*1024;
+
+    int32_t   fPriority;
+    int32_t   fCPU;
+    bool      fLockMemory;
+
+    void      PrefaultStack(void);
+    void      Report(void);
+};
+#endif
@@ -0,0 +1,537 @@
+/********************************************************************
+ *
+ * Module Name : SMCommandQueue.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Many client, one server shared memory command queue.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Server registers the Command layout. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <unistd.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SMCommandQueue.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMCommandQueue server constructor
+ *
+ * Description : Create, mark every request slot free for its first
+ *     request, publish and list the Command layout in the registry.
+ *
+ * Inputs :
+ *     Name     - segment name
+ *     Capacity - request slots
+ *     Replies  - reply slots
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true on failure.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMCommandQueue::SMCommandQueue(const char *Name, uint32_t Capacity,
+			       uint32_t Replies) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    uint32_t i;
+
+    fQueue    = NULL;
+    fRequests = NULL;
+    fReplies  = NULL;
+    fCapacity = 1;
+    fNReplies = 1;
+    fRefused  = 0;
+    fWaitID   = 0;
+
+    while (fCapacity < Capacity)
+	fCapacity <<= 1;
+    while (fNReplies < Replies)
+	fNReplies <<= 1;
+
+    if (!Create(Name, kTypeCommand, kVersion,
+		kQueueHeaderSize + fCapacity*sizeof(RequestSlot) +
+		fNReplies*sizeof(ReplySlot)))
+    {
+	return;
+    }
+    fQueue = (QueueHeader *) Body();
+    fQueue->Capacity = fCapacity;
+    fQueue->Replies  = fNReplies;
+    Layout();
+    for (i = 0; i < fCapacity; i++)
+    {
+	fRequests[i].Seq.store(i, std::memory_order_relaxed);
+    }
+    Publish();
+    Register(CommandSchema(), 0.0);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : CommandSchema
+ *
+ * Description : Layout of a Command, for the registry.
+ *
+ * Inputs : NONE
+ *
+ * Returns : the schema
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const SMSchema& SMCommandQueue::CommandSchema(void)
+{
+    static const SMField kFields[] = {
+	SM_MEMBER(Command, ID,     "ID"),
+	SM_MEMBER(Command, Client, "Client"),
+	SM_MEMBER(Command, Length, "Length"),
+	SM_MEMBER(Command, Text,   "Text"),
+    };
+    static const SMSchema kSchema("Command", kFields, SM_NFIELDS(kFields));
+    return kSchema;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMCommandQueue client constructor
+ *
+ * Description : Attach, geometry from the body header.
+ *
+ * Inputs : Name - segment name
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true on failure.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMCommandQueue::SMCommandQueue(const char *Name) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    fQueue    = NULL;
+    fRequests = NULL;
+    fReplies  = NULL;
+    fCapacity = 0;
+    fNReplies = 0;
+    fRefused  = 0;
+    fWaitID   = 0;
+
+    if (!Attach(Name, kTypeCommand, kVersion))
+    {
+	return;
+    }
+    fQueue    = (QueueHeader *) Body();
+    fCapacity = fQueue->Capacity;
+    fNReplies = fQueue->Replies;
+    if (!Layout())
+    {
+	CLogger::GetThis()->Log("# SMCommandQueue %s bad geometry.\n", Name);
+	fQueue = NULL;
+	fError = true;
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Layout
+ *
+ * Description : Place the slot arrays, check they fit.
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if the geometry is sane
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::Layout(void)
+{
+    if ((fCapacity == 0) || ((fCapacity & (fCapacity-1)) != 0) ||
+	(fNReplies == 0) || ((fNReplies & (fNReplies-1)) != 0) ||
+	(kQueueHeaderSize + fCapacity*sizeof(RequestSlot) +
+	 fNReplies*sizeof(ReplySlot) > BodySize()))
+    {
+	return false;
+    }
+    fRequests = (RequestSlot *)(Body() + kQueueHeaderSize);
+    fReplies  = (ReplySlot *)(fRequests + fCapacity);
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Send
+ *
+ * Description : Claim the next request number by compare and swap
+ *     on Tail, fill the slot, mark it ready and wake the server.
+ *     A slot whose Seq is behind the number still holds a request
+ *     Capacity back, the queue is full.
+ *
+ * Inputs : Text - command
+ *
+ * Returns : request ID, 0 if full
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t SMCommandQueue::Send(const char *Text)
+{
+    RequestSlot *s;
+    uint64_t    pos, seq;
+    size_t      n;
+
+    if (!fQueue || !Text)
+	return 0;
+
+    pos = fQueue->Tail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+	s   = &fRequests[pos & (fCapacity-1)];
+	seq = s->Seq.load(std::memory_order_acquire);
+	if (seq == pos)
+	{
+	    if (fQueue->Tail.compare_exchange_weak(pos, pos+1,
+						   std::memory_order_relaxed))
+		break;
+	    // pos now holds the current Tail.
+	}
+	else if ((int64_t)(seq - pos) < 0)
+	{
+	    fRefused++;
+	    return 0;
+	}
+	else
+	{
+	    pos = fQueue->Tail.load(std::memory_order_relaxed);
+	}
+    }
+
+    n = strnlen(Text, kCommandText-1);
+    memset(&s->Data, 0, sizeof(s->Data));
+    memcpy(s->Data.Text, Text, n);
+    s->Data.ID     = pos+1;
+    s->Data.Client = (int32_t) getpid();
+    s->Data.Length = (uint32_t) n;
+    s->Seq.store(pos+1, std::memory_order_release);
+    Notify();
+    return pos+1;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : Take request Head if it is ready, free its slot
+ *     for request Head+Capacity.
+ *
+ * Inputs : c - filled in
+ *
+ * Returns : true if there was a command
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::Next(Command &c)
+{
+    RequestSlot *s;
+    uint64_t    pos;
+
+    if (!fQueue)
+	return false;
+
+    pos = fQueue->Head.load(std::memory_order_relaxed);
+    s   = &fRequests[pos & (fCapacity-1)];
+    if (s->Seq.load(std::memory_order_acquire) != pos+1)
+	return false;
+
+    c = s->Data;
+    c.Text[kCommandText-1] = 0;
+    s->Seq.store(pos + fCapacity, std::memory_order_release);
+    fQueue->Head.store(pos+1, std::memory_order_release);
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Respond
+ *
+ * Description : Seqlock write of the reply slot for ID, then wake
+ *     the clients.
+ *
+ * Inputs :
+ *     ID     - request answered
+ *     Status - 0 OK
+ *     Text   - reply, may be NULL
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMCommandQueue::Respond(uint64_t ID, int32_t Status, const char *Text)
+{
+    ReplySlot *s;
+    uint64_t  seq;
+    size_t    n = Text ? strnlen(Text, kReplyText-1) : 0;
+
+    if (!fQueue)
+	return;
+
+    s   = &fReplies[ID & (fNReplies-1)];
+    seq = s->Seq.load(std::memory_order_relaxed);
+    s->Seq.store(seq+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(&s->Data, 0, sizeof(s->Data));
+    if (n > 0)
+	memcpy(s->Data.Text, Text, n);
+    s->Data.ID     = ID;
+    s->Data.Status = Status;
+    s->Data.Length = (uint32_t) n;
+    s->Seq.store(seq+2, std::memory_order_release);
+    Notify();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : PeekReply
+ *
+ * Description : Seqlock read of the reply slot for ID.
+ *
+ * Inputs :
+ *     ID - request
+ *     r  - copy, may be NULL to only test
+ *
+ * Returns : true if the slot holds a complete reply to ID
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::PeekReply(uint64_t ID, Reply *r) const
+{
+    ReplySlot *s;
+    Reply     tmp;
+    uint64_t  s1, s2;
+    int       i;
+
+    if (!fQueue || (ID == 0))
+	return false;
+
+    s = &fReplies[ID & (fNReplies-1)];
+    for (i = 0; i < 100; i++)
+    {
+	s1 = s->Seq.load(std::memory_order_acquire);
+	if (s1 & 1)
+	    continue;
+	memcpy(&tmp, &s->Data, sizeof(tmp));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	s2 = s->Seq.load(std::memory_order_relaxed);
+	if (s1 != s2)
+	    continue;
+	if (tmp.ID != ID)
+	    return false;
+	if (r)
+	{
+	    *r = tmp;
+	    r->Text[kReplyText-1] = 0;
+	}
+	return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : GetReply
+ *
+ * Description : Client, non blocking.
+ *
+ * Inputs :
+ *     ID - from Send
+ *     r  - filled in
+ *
+ * Returns : true if answered
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::GetReply(uint64_t ID, Reply &r)
+{
+    return PeekReply(ID, &r);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : WaitReply
+ *
+ * Description : Client, sleep until the reply to ID arrives.
+ *
+ * Inputs :
+ *     ID        - from Send
+ *     r         - filled in
+ *     TimeoutMS - longest wait
+ *
+ * Returns : true if answered
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::WaitReply(uint64_t ID, Reply &r, uint32_t TimeoutMS)
+{
+    fWaitID = ID;
+    Wait(TimeoutMS);
+    fWaitID = 0;
+    return PeekReply(ID, &r);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Pending
+ *
+ * Description : Tail - Head.
+ *
+ * Inputs : NONE
+ *
+ * Returns : commands not yet taken
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t SMCommandQueue::Pending(void) const
+{
+    uint64_t h, t;
+    if (!fQueue)
+	return 0;
+    h = fQueue->Head.load(std::memory_order_acquire);
+    t = fQueue->Tail.load(std::memory_order_acquire);
+    return (t > h) ? t - h : 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Ready
+ *
+ * Description : What Wait waits for, depends on the side.
+ *
+ * Inputs : NONE
+ *
+ * Returns : server, a command is ready. Client, the reply to the
+ *     ID in WaitReply is in.
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMCommandQueue::Ready(void) const
+{
+    uint64_t pos;
+    if (!fQueue)
+	return false;
+    if (Owner())
+    {
+	pos = fQueue->Head.load(std::memory_order_relaxed);
+	return fRequests[pos & (fCapacity-1)].Seq.load(
+	    std::memory_order_acquire) == pos+1;
+    }
+    return PeekReply(fWaitID, NULL);
+}
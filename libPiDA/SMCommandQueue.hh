@@ -0,0 +1,209 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMCommandQueue.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Shared memory command queue. One server, the DAQ
+ *     process that owns the segment, takes commands in order. Any
+ *     number of clients, C++ or python, Send text commands without
+ *     a lock and without overwriting each other. Each command gets
+ *     a request ID, its sequence number in the queue, and the
+ *     server's answer goes to a separate reply area where the
+ *     client finds it by that ID.
+ *
+ *     Body layout, after the SMSegment header,
+ *
+ *         offset  0  uint64 Tail      requests ever queued
+ *                 8  uint64 Head      requests the server took
+ *                16  uint32 Capacity  request slots, power of 2
+ *                20  uint32 Replies   reply slots, power of 2
+ *                64  Capacity request slots, kRequestSlot bytes
+ *                        uint64 Seq   n   slot free for request n
+ *                                     n+1 request n is ready
+ *                        uint64 ID    n+1
+ *                        int32  Client  sender's pid
+ *                        uint32 Length
+ *                        char   Text[kCommandText]
+ *                    Replies reply slots, kReplySlot bytes
+ *                        uint64 Seq   seqlock, odd while written
+ *                        uint64 ID    request answered
+ *                        int32  Status  0 OK, < 0 error
+ *                        uint32 Length
+ *                        char   Text[kReplyText]
+ *
+ *     A client claims request n by a compare and swap of Tail from
+ *     n to n+1, fills slot n & (Capacity-1) and sets its Seq to
+ *     n+1. The server takes the slot when Seq is Head+1 and frees
+ *     it for request n+Capacity. The reply to ID goes in reply slot
+ *     ID & (Replies-1), valid until Replies newer requests are
+ *     answered.
+ *
+ *     Flask/PySM/Commands.py speaks the same layout.
+ *
+ * Restrictions/Limitations :
+ *     One server per queue.
+ *     A client killed between claiming a slot and marking it ready
+ *     stalls the queue until the server restarts.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  CommandSchema. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     D. Vyukov, bounded MPMC queue, 1024cores.net
+ *
+ *******************************************************************
+ */
+#ifndef __SMCOMMANDQUEUE_hh_
+#define __SMCOMMANDQUEUE_hh_
+#    include <atomic>
+#    include "SMSegment.hh"
+
+/// SMCommandQueue - many clients, one server, with replies.
+class SMCommandQueue : public SMSegment {
+public:
+    /*! Queue layout version, Header.Version */
+    static const uint32_t kVersion = 1;
+
+    /*! Longest command and reply text, bytes including the null. */
+    static const size_t kCommandText = 232;
+    static const size_t kReplyText   = 512;
+
+    /*! One command as the server sees it. */
+    struct Command {
+	uint64_t ID;
+	int32_t  Client;
+	uint32_t Length;
+	char     Text[kCommandText];
+    };
+
+    /*! One reply as the client sees it. */
+    struct Reply {
+	uint64_t ID;
+	int32_t  Status;
+	uint32_t Length;
+	char     Text[kReplyText];
+    };
+
+    /// Server, Capacity and Replies are rounded up to a power of 2.
+    SMCommandQueue(const char *Name, uint32_t Capacity, uint32_t Replies);
+
+    /// Client.
+    SMCommandQueue(const char *Name);
+
+    /*!
+     * Description:
+     *   Client. Queue a command.
+     *
+     * Arguments:
+     *   Text - null terminated, truncated to kCommandText-1
+     *
+     * Returns:
+     *   request ID, 0 if the queue is full.
+     *
+     * Errors:
+     *   NONE
+     */
+    uint64_t Send(const char *Text);
+
+    /*!
+     * Description:
+     *   Client. Look for the reply to a request.
+     *
+     * Arguments:
+     *   ID - from Send
+     *   r  - filled in on success
+     *
+     * Returns:
+     *   true if the server has answered ID
+     *
+     * Errors:
+     *   NONE
+     */
+    bool GetReply(uint64_t ID, Reply &r);
+
+    /*! Client, GetReply blocking up to TimeoutMS. */
+    bool WaitReply(uint64_t ID, Reply &r, uint32_t TimeoutMS);
+
+    /*!
+     * Description:
+     *   Server. Take the next command in order.
+     *
+     * Arguments:
+     *   c - filled in on success
+     *
+     * Returns:
+     *   true if there was one
+     *
+     * Errors:
+     *   NONE
+     */
+    bool Next(Command &c);
+
+    /*!
+     * Description:
+     *   Server. Answer a command.
+     *
+     * Arguments:
+     *   ID     - Command.ID
+     *   Status - 0 OK, < 0 error
+     *   Text   - may be NULL
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE
+     */
+    void Respond(uint64_t ID, int32_t Status, const char *Text);
+
+    /*! Commands queued but not yet taken. */
+    uint64_t Pending(void) const;
+
+    /*! Layout of a Command, what the server registers. */
+    static const SMSchema& CommandSchema(void);
+
+    /*! Client, Sends refused because the queue was full. */
+    inline uint64_t Refused(void) const {return fRefused;};
+
+protected:
+    /*! Server, a command is waiting. Client, the awaited reply is in. */
+    bool Ready(void) const;
+
+private:
+    /*! Body header, see the layout above. */
+    struct QueueHeader {
+	std::atomic<uint64_t> Tail;
+	std::atomic<uint64_t> Head;
+	uint32_t Capacity;
+	uint32_t Replies;
+    };
+    static const size_t kQueueHeaderSize = 64;
+
+    struct RequestSlot {
+	std::atomic<uint64_t> Seq;
+	Command               Data;
+    };
+    struct ReplySlot {
+	std::atomic<uint64_t> Seq;
+	Reply                 Data;
+    };
+
+    QueueHeader *fQueue;
+    RequestSlot *fRequests;
+    ReplySlot   *fReplies;
+    uint32_t    fCapacity;
+    uint32_t    fNReplies;
+    uint64_t    fRefused;
+    uint64_t    fWaitID;    // client, reply WaitReply is after
+
+    bool Layout(void);
+    bool PeekReply(uint64_t ID, Reply *r) const;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		  "SMCommandQueue needs lock free 64 bit atomics");
+};
+#endif
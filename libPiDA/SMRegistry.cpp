@@ -0,0 +1,571 @@
+/********************************************************************
+ *
+ * Module Name : SMRegistry.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Directory of the live shared memory segments.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Add claims with kClaiming, Write publishes the PID
+ *                 inside the seqlock. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <signal.h>
+#include <unistd.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SMRegistry.hh"
+
+/*! Name of the registry segment. */
+static const char *kRegistryName = "PiDA_Registry";
+
+SMRegistry* SMRegistry::fSMRegistry = NULL;
+bool        SMRegistry::fTried      = false;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMRegistry constructor
+ *
+ * Description : Open the registry, the first process lays out the
+ *     body and publishes it.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true on failure.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMRegistry::SMRegistry(void) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    bool Created;
+
+    fRegistry = NULL;
+    fEntries  = NULL;
+    fSeen     = 0;
+
+    if (!Open(kRegistryName, kTypeRegistry, kVersion,
+	      kRegistryHeaderSize + kCapacity*sizeof(EntrySlot), Created))
+    {
+	return;
+    }
+    fRegistry = (RegistryHeader *) Body();
+    fEntries  = (EntrySlot *)(Body() + kRegistryHeaderSize);
+    if (Created)
+    {
+	fRegistry->Capacity  = kCapacity;
+	fRegistry->EntrySize = sizeof(EntrySlot);
+	Publish();
+    }
+    else if ((fRegistry->Capacity != kCapacity) ||
+	     (fRegistry->EntrySize != sizeof(EntrySlot)))
+    {
+	CLogger::GetThis()->Log("# SMRegistry bad geometry.\n");
+	fRegistry = NULL;
+	fError    = true;
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : GetThis
+ *
+ * Description : Open on the first call, keep it for the life of
+ *     the process. Never deleted, segments may be destroyed from
+ *     static destructors after it would have been.
+ *
+ * Inputs : NONE
+ *
+ * Returns : the registry or NULL
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMRegistry* SMRegistry::GetThis(void)
+{
+    SMRegistry *p;
+
+    if (!fTried)
+    {
+	fTried = true;
+	p = new SMRegistry();
+	if (p->CheckError())
+	{
+	    CLogger::GetThis()->LogError(__FILE__, __LINE__, 'W',
+					 "SM registry failed.");
+	    delete p;
+	}
+	else
+	{
+	    fSMRegistry = p;
+	}
+    }
+    return fSMRegistry;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Alive
+ *
+ * Description : Is there still a process PID.
+ *
+ * Inputs : PID
+ *
+ * Returns : true if so, EPERM counts, it exists
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMRegistry::Alive(int32_t PID)
+{
+    return (PID > 0) && ((kill(PID, 0) == 0) || (errno == EPERM));
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Claim an entry by compare and swap on its PID, an
+ *     old entry of the same name first, then any free or dead one,
+ *     and write it. The swap puts in kClaiming, not our PID, so a
+ *     reader between the claim and the write never sees our PID
+ *     with the last owner's segment and layout. It sees an entry
+ *     with no live producer until Write, with Seq odd, puts ours in.
+ *
+ * Inputs :
+ *     Segment - segment name
+ *     Type    - kType...
+ *     Schema  - record layout
+ *     Rate    - Hz
+ *
+ * Returns : entry index, -1 if full
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int SMRegistry::Add(const char *Segment, uint32_t Type,
+		    const SMSchema &Schema, double Rate)
+{
+    SET_DEBUG_STACK;
+    int32_t  Me = (int32_t) getpid();
+    int32_t  pid;
+    uint32_t i, n, pass;
+    int      rv = -1;
+    Info     Data;
+
+    if (!fRegistry)
+	return -1;
+
+    for (pass = 0; (pass < 2) && (rv < 0); pass++)
+    {
+	for (i = 0; (i < kCapacity) && (rv < 0); i++)
+	{
+	    Info &e = fEntries[i].Data;
+	    pid = __atomic_load_n(&e.PID, __ATOMIC_ACQUIRE);
+	    if (pid == kClaiming)
+		continue;
+	    if ((pass == 0) &&
+		(strncmp(e.Segment, Segment, kSegmentName) != 0))
+		continue;
+	    if ((pid != 0) && (pid != Me) && Alive(pid))
+		continue;
+	    if ((pid == Me) && (pass == 1))
+		continue;
+	    if (__atomic_compare_exchange_n(&e.PID, &pid, kClaiming, false,
+					    __ATOMIC_ACQ_REL,
+					    __ATOMIC_RELAXED))
+		rv = (int) i;
+	}
+    }
+    if (rv < 0)
+    {
+	CLogger::GetThis()->Log("# SMRegistry full, %s\n", Segment);
+	return -1;
+    }
+
+    memset(&Data, 0, sizeof(Data));
+    Data.PID        = Me;
+    Data.Type       = Type;
+    strncpy(Data.Segment, Segment, kSegmentName-1);
+    strncpy(Data.Record, Schema.Record(), SMSchema::kFieldName-1);
+    Data.RecordSize = (uint32_t) Schema.Size();
+    Data.SchemaHash = Schema.Hash();
+    Data.Rate       = Rate;
+    n = Schema.NFields();
+    if (n > SMSchema::kMaxFields)
+    {
+	CLogger::GetThis()->Log("# SMRegistry %s, %u fields, %u kept.\n",
+				Segment, n, SMSchema::kMaxFields);
+	n = SMSchema::kMaxFields;
+    }
+    Data.NFields = n;
+    for (i = 0; i < n; i++)
+    {
+	const SMField &f = Schema.Field(i);
+	strncpy(Data.Fields[i].Name, f.Name, SMSchema::kFieldName-1);
+	Data.Fields[i].Offset = f.Offset;
+	Data.Fields[i].Type   = f.Type;
+	Data.Fields[i].Size   = f.Size;
+	Data.Fields[i].Count  = f.Count;
+    }
+    Write(rv, Data);
+    SET_DEBUG_STACK;
+    return rv;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : Seqlock write of entry Index, PID last. The caller
+ *     holds the entry, its PID is ours or kClaiming.
+ *
+ * Inputs :
+ *     Index - entry
+ *     Data  - new contents, PID 0 frees it
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRegistry::Write(int Index, const Info &Data)
+{
+    EntrySlot *s = &fEntries[Index];
+    uint64_t  seq;
+
+    seq = s->Seq.load(std::memory_order_relaxed);
+    s->Seq.store(seq+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // Everything after the PID, then the PID.
+    memcpy((uint8_t *) &s->Data + sizeof(Data.PID),
+	   (const uint8_t *) &Data + sizeof(Data.PID),
+	   sizeof(Data) - sizeof(Data.PID));
+    __atomic_store_n(&s->Data.PID, Data.PID, __ATOMIC_RELEASE);
+    s->Seq.store(seq+2, std::memory_order_release);
+    Bump();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Bump
+ *
+ * Description : Count a change and wake anyone waiting on one.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRegistry::Bump(void)
+{
+    fRegistry->Changes.fetch_add(1, std::memory_order_release);
+    Notify();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Remove
+ *
+ * Description : Clear entry Index and free it.
+ *
+ * Inputs : Index - from Add
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRegistry::Remove(int Index)
+{
+    Info Data;
+
+    if (!fRegistry || (Index < 0) || (Index >= (int) kCapacity))
+	return;
+    memset(&Data, 0, sizeof(Data));
+    Write(Index, Data);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Touch
+ *
+ * Description : Count a Put and stamp it. Only the producer
+ *     writes these, relaxed is enough.
+ *
+ * Inputs : Index - from Add
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRegistry::Touch(int Index)
+{
+    struct timespec now;
+    Info *e;
+
+    if (!fRegistry)
+	return;
+    e = &fEntries[Index].Data;
+    clock_gettime(CLOCK_REALTIME, &now);
+    __atomic_store_n(&e->Updates,
+		     __atomic_load_n(&e->Updates, __ATOMIC_RELAXED) + 1,
+		     __ATOMIC_RELAXED);
+    __atomic_store_n(&e->UpdateTime,
+		     (uint64_t) now.tv_sec*1000000000ULL + now.tv_nsec,
+		     __ATOMIC_RELAXED);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SetRate
+ *
+ * Description : Rewrite entry Index with a new rate.
+ *
+ * Inputs :
+ *     Index - from Add
+ *     Rate  - Hz
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRegistry::SetRate(int Index, double Rate)
+{
+    Info Data;
+
+    if (!fRegistry || (Index < 0) || (Index >= (int) kCapacity))
+	return;
+    // Only the producer writes its entry, no seqlock needed to read it.
+    memcpy(&Data, &fEntries[Index].Data, sizeof(Data));
+    Data.Rate = Rate;
+    Write(Index, Data);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Get
+ *
+ * Description : Seqlock read of entry Index, then the live counts.
+ *
+ * Inputs :
+ *     Index - entry
+ *     rv    - filled in
+ *
+ * Returns : true if in use by a live process
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMRegistry::Get(uint32_t Index, Info &rv) const
+{
+    const EntrySlot *s;
+    uint64_t        s1, s2;
+    int             i;
+
+    if (!fRegistry || (Index >= kCapacity))
+	return false;
+
+    s = &fEntries[Index];
+    for (i = 0; i < 1000; i++)
+    {
+	s1 = s->Seq.load(std::memory_order_acquire);
+	if (s1 & 1)
+	    continue;
+	memcpy(&rv, &s->Data, sizeof(rv));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	s2 = s->Seq.load(std::memory_order_relaxed);
+	if (s1 == s2)
+	    break;
+    }
+    if (i == 1000)
+	return false;
+
+    rv.Updates    = __atomic_load_n(&s->Data.Updates, __ATOMIC_RELAXED);
+    rv.UpdateTime = __atomic_load_n(&s->Data.UpdateTime, __ATOMIC_RELAXED);
+    rv.Segment[kSegmentName-1]         = 0;
+    rv.Record[SMSchema::kFieldName-1]  = 0;
+    if (rv.NFields > SMSchema::kMaxFields)
+	rv.NFields = SMSchema::kMaxFields;
+    return Alive(rv.PID);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Find
+ *
+ * Description : Look up the live entry of a segment.
+ *
+ * Inputs :
+ *     Segment - name
+ *     rv      - filled in
+ *
+ * Returns : true if found
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMRegistry::Find(const char *Segment, Info &rv) const
+{
+    uint32_t i;
+    for (i = 0; i < kCapacity; i++)
+    {
+	if (Get(i, rv) && (strncmp(rv.Segment, Segment, kSegmentName) == 0))
+	    return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Changes
+ *
+ * Description : Adds and Removes so far, remembered for Wait.
+ *
+ * Inputs : NONE
+ *
+ * Returns : count
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t SMRegistry::Changes(void)
+{
+    if (!fRegistry)
+	return 0;
+    fSeen = fRegistry->Changes.load(std::memory_order_acquire);
+    return fSeen;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Ready
+ *
+ * Description : Something changed since Changes was last asked.
+ *
+ * Inputs : NONE
+ *
+ * Returns : true if so
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMRegistry::Ready(void) const
+{
+    return fRegistry &&
+	(fRegistry->Changes.load(std::memory_order_acquire) != fSeen);
+}
@@ -0,0 +1,210 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMRegistry.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : The shared memory registry, PiDA_Registry. Every
+ *     producer lists its segments here, who made it, the record
+ *     layout from SMSchema, the publish rate, and a count and time
+ *     of the last update. Consumers look a segment up to check the
+ *     layout they were built with, python builds its readers from
+ *     it instead of hard coding offsets.
+ *
+ *     Unlike the other segments it has no single owner. The first
+ *     process to want it creates it, it is never unlinked, and
+ *     entries left by processes that died are taken over.
+ *
+ *     Body layout, after the SMSegment header,
+ *
+ *         offset  0  uint32 Capacity   entries
+ *                 4  uint32 EntrySize  1152
+ *                 8  uint64 Changes    bumped on every Add/Remove
+ *                64  Capacity entries, EntrySize bytes
+ *                   0  uint64 Seq        seqlock, odd while written
+ *                   8  int32  PID        producer, 0 free, -1 being
+ *                                          claimed
+ *                  12  uint32 Type       segment kType...
+ *                  16  char   Segment[32]
+ *                  48  char   Record[24] record type name
+ *                  72  uint32 RecordSize
+ *                  76  uint32 SchemaHash SMSchema::Hash
+ *                  80  uint32 NFields
+ *                  88  double Rate       Hz, 0 if irregular
+ *                  96  uint64 Updates    Puts so far
+ *                 104  uint64 UpdateTime ns, CLOCK_REALTIME
+ *                 128  kMaxFields fields, 32 bytes each
+ *                        char   Name[24]
+ *                        uint32 Offset
+ *                        uint8  Type     SMField::k...
+ *                        uint8  Size     bytes per element
+ *                        uint16 Count
+ *
+ *     Updates and UpdateTime are stored outside the seqlock by the
+ *     producer on every Put, the rest only changes on Add/Remove.
+ *
+ * Restrictions/Limitations :
+ *     kCapacity live segments on the machine.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  kClaiming, the PID goes in with the seqlock write.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SMREGISTRY_hh_
+#define __SMREGISTRY_hh_
+#    include <atomic>
+#    include "SMSegment.hh"
+#    include "SMSchema.hh"
+
+/// SMRegistry - directory of the live segments and their layouts.
+class SMRegistry : public SMSegment {
+public:
+    /*! Registry layout version, Header.Version */
+    static const uint32_t kVersion = 1;
+
+    /*! Entries. */
+    static const uint32_t kCapacity = 64;
+
+    /*! Longest segment name, with the null. */
+    static const size_t kSegmentName = 32;
+
+    /*! PID while Add fills an entry in, never a live process. */
+    static const int32_t kClaiming = -1;
+
+    /*! One field as stored. */
+    struct FieldSlot {
+	char     Name[SMSchema::kFieldName];
+	uint32_t Offset;
+	uint8_t  Type;
+	uint8_t  Size;
+	uint16_t Count;
+    };
+
+    /*! One entry as stored after Seq, and as Get hands it back. */
+    struct Info {
+	int32_t   PID;
+	uint32_t  Type;
+	char      Segment[kSegmentName];
+	char      Record[SMSchema::kFieldName];
+	uint32_t  RecordSize;
+	uint32_t  SchemaHash;
+	uint32_t  NFields;
+	uint32_t  Reserved;
+	double    Rate;
+	uint64_t  Updates;
+	uint64_t  UpdateTime;
+	uint64_t  Spare[2];
+	FieldSlot Fields[SMSchema::kMaxFields];
+    };
+
+    /*!
+     * Description:
+     *   The registry of this machine, created or attached on the
+     *   first call.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   the registry, NULL if it could not be had. Not tried again.
+     *
+     * Errors:
+     *   logged
+     */
+    static SMRegistry* GetThis(void);
+
+    /*!
+     * Description:
+     *   Producer. List a segment, replacing any entry of the same
+     *   name left by a process that is gone.
+     *
+     * Arguments:
+     *   Segment - segment name
+     *   Type    - segment kType...
+     *   Schema  - record layout
+     *   Rate    - Hz, 0 if irregular
+     *
+     * Returns:
+     *   entry index, -1 if the registry is full
+     *
+     * Errors:
+     *   NONE
+     */
+    int Add(const char *Segment, uint32_t Type, const SMSchema &Schema,
+	    double Rate);
+
+    /*! Producer, the segment is going away. */
+    void Remove(int Index);
+
+    /*! Producer, after each Put. */
+    void Touch(int Index);
+
+    /*! Producer, the publish rate changed. */
+    void SetRate(int Index, double Rate);
+
+    /*!
+     * Description:
+     *   Consumer. Copy entry Index out if it is in use by a live
+     *   process.
+     *
+     * Arguments:
+     *   Index - 0 to kCapacity-1
+     *   rv    - filled in
+     *
+     * Returns:
+     *   true if the entry is live
+     *
+     * Errors:
+     *   NONE
+     */
+    bool Get(uint32_t Index, Info &rv) const;
+
+    /*! Consumer, the live entry for Segment. */
+    bool Find(const char *Segment, Info &rv) const;
+
+    /*! Adds and Removes so far, Wait returns when it moves. */
+    uint64_t Changes(void);
+
+protected:
+    bool Ready(void) const;
+
+private:
+    /*! Body header, see the layout above. */
+    struct RegistryHeader {
+	uint32_t Capacity;
+	uint32_t EntrySize;
+	std::atomic<uint64_t> Changes;
+    };
+    static const size_t kRegistryHeaderSize = 64;
+
+    struct EntrySlot {
+	std::atomic<uint64_t> Seq;
+	Info                  Data;
+    };
+
+    /// Create or attach, through GetThis.
+    SMRegistry(void);
+
+    RegistryHeader  *fRegistry;
+    EntrySlot       *fEntries;
+    uint64_t        fSeen;        // Changes when last asked
+
+    static SMRegistry *fSMRegistry;
+    static bool        fTried;
+
+    static bool Alive(int32_t PID);
+    void Write(int Index, const Info &Data);
+    void Bump(void);
+
+    static_assert(sizeof(FieldSlot) == 32, "SMRegistry field slot");
+    static_assert(offsetof(Info, Rate) == 80, "SMRegistry entry layout");
+    static_assert(offsetof(Info, Fields) == 120, "SMRegistry entry layout");
+    static_assert(sizeof(EntrySlot) == 1152, "SMRegistry entry layout");
+};
+#endif
@@ -0,0 +1,329 @@
+/********************************************************************
+ *
+ * Module Name : SMRing.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Single producer, many consumer shared memory ring.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Notify after each Put. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     H. Boehm, "Can Seqlocks Get Along With Programming Language
+ *     Memory Models?", MSPC 2012, for the fence placement.
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SMRing.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMRing producer constructor
+ *
+ * Description : Size the slots, create, fill in the body header
+ *     and publish.
+ *
+ * Inputs :
+ *     Name       - segment name
+ *     RecordSize - bytes per record
+ *     Capacity   - records kept, rounded up to a power of 2
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true if the segment failed.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMRing::SMRing(const char *Name, size_t RecordSize, uint32_t Capacity)
+    : SMSegment()
+{
+    SET_DEBUG_STACK;
+    fRing       = NULL;
+    fSlots      = NULL;
+    fRecordSize = RecordSize;
+    fCapacity   = 1;
+    fCursor     = 0;
+    fMissed     = 0;
+
+    while (fCapacity < Capacity)
+	fCapacity <<= 1;
+    fSlotSize = (uint32_t)(sizeof(Slot) + ((RecordSize + 7) & ~(size_t)7));
+
+    if (!Create(Name, kTypeRing, kVersion,
+		kRingHeaderSize + (size_t) fCapacity*fSlotSize))
+    {
+	return;
+    }
+    fRing  = (RingHeader *) Body();
+    fSlots = Body() + kRingHeaderSize;
+    fRing->RecordSize = (uint32_t) fRecordSize;
+    fRing->Capacity   = fCapacity;
+    fRing->SlotSize   = fSlotSize;
+    fRing->WriteSeq.store(0, std::memory_order_relaxed);
+    Publish();
+
+    CLogger::GetThis()->Log("# SMRing %s %u x %u bytes\n", Name,
+			    fCapacity, (uint32_t) fRecordSize);
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMRing consumer constructor
+ *
+ * Description : Attach and take the geometry from the body header.
+ *
+ * Inputs : Name - segment name
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true if the ring is not there.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMRing::SMRing(const char *Name) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    fRing       = NULL;
+    fSlots      = NULL;
+    fRecordSize = 0;
+    fCapacity   = 0;
+    fSlotSize   = 0;
+    fCursor     = 0;
+    fMissed     = 0;
+
+    if (!Attach(Name, kTypeRing, kVersion))
+    {
+	return;
+    }
+    fRing       = (RingHeader *) Body();
+    fSlots      = Body() + kRingHeaderSize;
+    fRecordSize = fRing->RecordSize;
+    fCapacity   = fRing->Capacity;
+    fSlotSize   = fRing->SlotSize;
+    if ((fCapacity == 0) || ((fCapacity & (fCapacity-1)) != 0) ||
+	(kRingHeaderSize + (size_t) fCapacity*fSlotSize > BodySize()))
+    {
+	CLogger::GetThis()->Log("# SMRing %s bad geometry.\n", Name);
+	fRing  = NULL;
+	fError = true;
+	return;
+    }
+    SeekLatest();
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Put
+ *
+ * Description : Mark the slot odd, copy, mark it even, then bump
+ *     WriteSeq so consumers only ever see complete records behind
+ *     it. No waiting, no system calls unless a consumer is blocked
+ *     in Wait.
+ *
+ * Inputs : Record - RecordSize bytes
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRing::Put(const void *Record)
+{
+    uint64_t n;
+    Slot     *s;
+
+    if (!fRing)
+	return;
+
+    n = fRing->WriteSeq.load(std::memory_order_relaxed);
+    s = SlotOf(n);
+    s->Seq.store(2*n+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(DataOf(s), Record, fRecordSize);
+    s->Seq.store(2*n+2, std::memory_order_release);
+    fRing->WriteSeq.store(n+1, std::memory_order_release);
+    Notify();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Get
+ *
+ * Description : Next record after the cursor. If the cursor is more
+ *     than Capacity behind, jump to the oldest record still there
+ *     and count the rest as missed. A slot that was rewritten
+ *     before or during the copy is also counted and skipped.
+ *
+ * Inputs : Record - RecordSize bytes, user supplied
+ *
+ * Returns : true if a record was copied
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMRing::Get(void *Record)
+{
+    uint64_t w, s1, s2;
+    Slot     *s;
+
+    if (!fRing)
+	return false;
+
+    for (;;)
+    {
+	w = fRing->WriteSeq.load(std::memory_order_acquire);
+	if (fCursor >= w)
+	{
+	    // Producer restarted the count, start over with it.
+	    fCursor = w;
+	    return false;
+	}
+	if (w - fCursor > fCapacity)
+	{
+	    fMissed += w - fCursor - fCapacity;
+	    fCursor  = w - fCapacity;
+	}
+
+	s  = SlotOf(fCursor);
+	s1 = s->Seq.load(std::memory_order_acquire);
+	if (s1 != 2*fCursor+2)
+	{
+	    // Already being reused for a newer record.
+	    fMissed++;
+	    fCursor++;
+	    continue;
+	}
+	memcpy(Record, DataOf(s), fRecordSize);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	s2 = s->Seq.load(std::memory_order_relaxed);
+	fCursor++;
+	if (s2 == s1)
+	{
+	    return true;
+	}
+	fMissed++;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SeekLatest
+ *
+ * Description : Cursor to the write position.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRing::SeekLatest(void)
+{
+    if (fRing)
+	fCursor = fRing->WriteSeq.load(std::memory_order_acquire);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SeekOldest
+ *
+ * Description : Cursor to the oldest record not yet overwritten.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMRing::SeekOldest(void)
+{
+    uint64_t w;
+    if (fRing)
+    {
+	w = fRing->WriteSeq.load(std::memory_order_acquire);
+	fCursor = (w > fCapacity) ? w - fCapacity : 0;
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Written
+ *
+ * Description : Producer's record count.
+ *
+ * Inputs : NONE
+ *
+ * Returns : records written since the ring was created
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t SMRing::Written(void) const
+{
+    return fRing ? fRing->WriteSeq.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,149 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMRing.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Shared memory ring of fixed size records. One
+ *     producer appends every record with Put and never waits on
+ *     anybody. Each consumer attaches with its own private cursor
+ *     and takes every record since its last Get, or, if it fell
+ *     more than Capacity behind, learns exactly how many it lost
+ *     (Missed). Consumers do not write to the segment so any
+ *     number of them can read the same ring.
+ *
+ *     Body layout, after the SMSegment header,
+ *
+ *         offset  0  uint64 WriteSeq   records ever written
+ *                 8  uint32 RecordSize
+ *                12  uint32 Capacity   power of 2
+ *                16  uint32 SlotSize
+ *                64  Capacity slots of SlotSize bytes,
+ *                        uint64 Seq    2n+1 while record n is
+ *                                      written, 2n+2 when complete
+ *                        RecordSize bytes of record, padded to 8
+ *
+ *     Record n lives in slot n & (Capacity-1). A consumer checks
+ *     the slot Seq before and after copying, a mismatch means the
+ *     producer lapped it during the copy and the record is counted
+ *     as missed.
+ *
+ *     Flask/PySM/SMRing.py reads the same layout.
+ *
+ * Restrictions/Limitations :
+ *     One producer per ring.
+ *     Records are raw bytes, same ABI on both sides.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Put wakes consumers blocked in Wait. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SMRING_hh_
+#define __SMRING_hh_
+#    include <atomic>
+#    include "SMSegment.hh"
+
+/// SMRing - single producer, many consumer shared memory ring.
+class SMRing : public SMSegment {
+public:
+    /*! Ring layout version, Header.Version */
+    static const uint32_t kVersion = 1;
+
+    /// Producer, Capacity is rounded up to a power of 2.
+    SMRing(const char *Name, size_t RecordSize, uint32_t Capacity);
+
+    /// Consumer, attach to an existing ring. The cursor starts at
+    /// the next record written.
+    SMRing(const char *Name);
+
+    /*!
+     * Description:
+     *   Producer. Append one record, overwriting the oldest.
+     *
+     * Arguments:
+     *   Record - RecordSize bytes
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE, ignored if the segment is not valid.
+     */
+    void Put(const void *Record);
+
+    /*!
+     * Description:
+     *   Consumer. Copy out the next record after the cursor.
+     *
+     * Arguments:
+     *   Record - RecordSize bytes, user supplied
+     *
+     * Returns:
+     *   true if a record was copied, false if there is nothing new.
+     *
+     * Errors:
+     *   NONE, records overwritten before they were read are added
+     *   to Missed.
+     */
+    bool Get(void *Record);
+
+    /*! Consumer, skip the backlog, the next Get returns new data. */
+    void SeekLatest(void);
+
+    /*! Consumer, back up to the oldest record still in the ring. */
+    void SeekOldest(void);
+
+    /*! Records the producer has written in total. */
+    uint64_t Written(void) const;
+
+    /*! Records written but not yet read by this consumer. */
+    inline uint64_t Pending(void) const 
+	{uint64_t w = Written(); return (w > fCursor) ? w - fCursor : 0;};
+
+    /*! Records this consumer lost to overwrites. */
+    inline uint64_t Missed(void) const {return fMissed;};
+
+    inline size_t   RecordSize(void) const {return fRecordSize;};
+    inline uint32_t Capacity(void)   const {return fCapacity;};
+
+protected:
+    /*! Wait returns when this consumer has records pending. */
+    inline bool Ready(void) const {return Pending() > 0;};
+
+private:
+    /*! Body header, see the layout above. */
+    struct RingHeader {
+	std::atomic<uint64_t> WriteSeq;
+	uint32_t RecordSize;
+	uint32_t Capacity;
+	uint32_t SlotSize;
+    };
+    static const size_t kRingHeaderSize = 64;
+
+    /*! Slot header, the record follows. */
+    struct Slot {
+	std::atomic<uint64_t> Seq;
+    };
+
+    RingHeader *fRing;
+    uint8_t    *fSlots;
+    size_t     fRecordSize;
+    uint32_t   fCapacity;
+    uint32_t   fSlotSize;
+    uint64_t   fCursor;     // next record this consumer reads
+    uint64_t   fMissed;
+
+    inline Slot* SlotOf(uint64_t n) const
+	{return (Slot *)(fSlots + (size_t)(n & (fCapacity-1))*fSlotSize);};
+    inline uint8_t* DataOf(Slot *s) const {return (uint8_t *)s + sizeof(Slot);};
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		  "SMRing needs lock free 64 bit atomics");
+};
+#endif
@@ -0,0 +1,159 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMSchema.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Field descriptors for the records published in
+ *     shared memory. Each record type lists its members once with
+ *     SM_MEMBER, the compiler fills in the type, width, count and
+ *     offset, so nobody adds up sizeof by hand. The producer puts
+ *     the list in the registry, SMRegistry, where C++ consumers
+ *     check it against their own copy and python builds its
+ *     struct formats from it.
+ *
+ *     e.g. inside a member function of the record class,
+ *
+ *         static const SMField kFields[] = {
+ *             SM_MEMBER(IMUData, fTemp, "Temp"),
+ *             ...
+ *         };
+ *         static const SMSchema kSchema(
+ *             "IMUData", kFields, SM_NFIELDS(kFields));
+ *
+ *     Members that are not plain data, e.g. a record from another
+ *     library we only know the size of, go in as SM_BYTES.
+ *
+ * Restrictions/Limitations :
+ *     Standard layout records, offsetof. Names up to
+ *     kFieldName-1 characters, at most kMaxFields fields.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SMSCHEMA_hh_
+#define __SMSCHEMA_hh_
+#    include <stdint.h>
+#    include <stddef.h>
+#    include <type_traits>
+
+/*! One member of a record. */
+struct SMField {
+    /*! Element types, with Size they give the python struct code. */
+    enum {kBytes=0, kInt, kUInt, kFloat, kBool, kChar};
+
+    const char *Name;
+    uint8_t    Type;
+    uint8_t    Size;     // bytes per element
+    uint16_t   Count;    // elements, > 1 for arrays
+    uint32_t   Offset;   // from the start of the record
+};
+
+/*! Type code of a member, by its element type. */
+template <typename T> struct SMTypeOf {
+    static const uint8_t kType =
+	std::is_same<T, bool>::value ? SMField::kBool :
+	std::is_same<T, char>::value ? SMField::kChar :
+	std::is_floating_point<T>::value ? SMField::kFloat :
+	std::is_signed<T>::value ? SMField::kInt :
+	std::is_unsigned<T>::value ? SMField::kUInt : SMField::kBytes;
+};
+
+/*! Element type of a member, arrays of any rank taken apart. */
+#define SM_ELEMENT(Class, Member) \
+    std::remove_all_extents<decltype(((Class *)0)->Member)>::type
+
+/*! Descriptor of Class::Member, Member may be a.b for nested ones. */
+#define SM_MEMBER(Class, Member, Name)					\
+    {Name, SMTypeOf<SM_ELEMENT(Class, Member)>::kType,			\
+     (uint8_t) sizeof(SM_ELEMENT(Class, Member)),			\
+     (uint16_t)(sizeof(((Class *)0)->Member) /				\
+		sizeof(SM_ELEMENT(Class, Member))),			\
+     (uint32_t) offsetof(Class, Member)}
+
+/*! Descriptor of an opaque run of Bytes bytes at Offset. */
+#define SM_BYTES(Name, Offset, Bytes)					\
+    {Name, SMField::kBytes, 1, (uint16_t)(Bytes), (uint32_t)(Offset)}
+
+/*! Fields in a descriptor array. */
+#define SM_NFIELDS(a) ((uint32_t)(sizeof(a)/sizeof((a)[0])))
+
+/// SMSchema - the field list of one record type.
+class SMSchema {
+public:
+    /*! Longest field and record name kept in the registry, with the null. */
+    static const size_t kFieldName = 24;
+
+    /*! Most fields a record may have. */
+    static const uint32_t kMaxFields = 32;
+
+    SMSchema(const char *Record, const SMField *Fields, uint32_t NFields) :
+	fRecord(Record), fFields(Fields), fNFields(NFields) {};
+
+    /*! Record type name, e.g. "IMUData". */
+    inline const char* Record(void) const {return fRecord;};
+
+    inline uint32_t NFields(void) const {return fNFields;};
+    inline const SMField& Field(uint32_t i) const {return fFields[i];};
+
+    /*! Bytes from the start of the record to the end of the last field. */
+    inline size_t Size(void) const
+	{
+	    size_t rv = 0, e;
+	    for (uint32_t i=0;i<fNFields;i++)
+	    {
+		e = fFields[i].Offset +
+		    (size_t) fFields[i].Size * fFields[i].Count;
+		if (e > rv) rv = e;
+	    }
+	    return rv;
+	};
+
+    /*!
+     * Description:
+     *   FNV-1a over every name, type, width, count and offset.
+     *   Two sides with the same hash agree on the layout.
+     *
+     * Arguments:
+     *   NONE
+     *
+     * Returns:
+     *   32 bit hash
+     *
+     * Errors:
+     *   NONE
+     */
+    inline uint32_t Hash(void) const
+	{
+	    uint32_t h = 2166136261U;
+	    for (uint32_t i=0;i<fNFields;i++)
+	    {
+		const SMField &f = fFields[i];
+		for (const char *p = f.Name; *p; p++)
+		    h = Mix(h, (uint8_t) *p);
+		h = Mix(h, 0);
+		h = Mix(h, f.Type);
+		h = Mix(h, f.Size);
+		h = Mix(h, f.Count & 0xFF);
+		h = Mix(h, f.Count >> 8);
+		for (int k=0;k<32;k+=8)
+		    h = Mix(h, (uint8_t)(f.Offset >> k));
+	    }
+	    return h;
+	};
+
+private:
+    const char    *fRecord;
+    const SMField *fFields;
+    uint32_t      fNFields;
+
+    static inline uint32_t Mix(uint32_t h, uint8_t b)
+	{return (h ^ b) * 16777619U;};
+};
+#endif
@@ -0,0 +1,615 @@
+/********************************************************************
+ *
+ * Module Name : SMSegment.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : POSIX shared memory segment with a typed header.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Wait and Notify on a futex in the header. 
+ * 17-Oct-26  CBL  Open, Register and Expect for the registry. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SMSegment.hh"
+#include "SMRegistry.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMSegment constructor
+ *
+ * Description : Nothing mapped, Create or Attach does the work.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMSegment::SMSegment(void)
+{
+    fError = true;
+    fOwner = false;
+    fBase  = NULL;
+    fSize  = 0;
+    fEntry = -1;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMSegment destructor
+ *
+ * Description : Unmap. The producer unlinks the name, consumers
+ *     still attached keep their mapping until they let go.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMSegment::~SMSegment(void)
+{
+    SET_DEBUG_STACK;
+    if (fEntry >= 0)
+    {
+	SMRegistry::GetThis()->Remove(fEntry);
+	fEntry = -1;
+    }
+    if (fBase)
+    {
+	munmap(fBase, fSize);
+	fBase = NULL;
+    }
+    if (fOwner)
+    {
+	shm_unlink(("/" + fName).c_str());
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Create
+ *
+ * Description : Producer side, unlink any leftover from a previous
+ *     run so consumers never see a half initialized body, then Make.
+ *
+ * Inputs :
+ *     Name     - no leading /
+ *     Type     - kType...
+ *     Version  - layout version
+ *     BodySize - bytes after the header
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : system call failure, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Create(const char *Name, uint32_t Type, uint32_t Version,
+		       size_t BodySize)
+{
+    SET_DEBUG_STACK;
+    shm_unlink((string("/") + Name).c_str());
+    if (!Make(Name, Type, Version, BodySize))
+    {
+	return false;
+    }
+    fOwner = true;
+    SET_DEBUG_STACK;
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Make
+ *
+ * Description : Create, size and map a segment that must not
+ *     already exist.
+ *
+ * Inputs :
+ *     Name     - no leading /
+ *     Type     - kType...
+ *     Version  - layout version
+ *     BodySize - bytes after the header
+ *
+ * Returns : true on success, errno EEXIST if somebody else has it.
+ *
+ * Error Conditions : system call failure, logged unless EEXIST
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Make(const char *Name, uint32_t Type, uint32_t Version,
+		     size_t BodySize)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    string  Path    = string("/") + Name;
+    void    *p;
+    int     fd;
+
+    fName  = Name;
+    fSize  = kHeaderSize + BodySize;
+    fError = true;
+
+    fd = shm_open(Path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0)
+    {
+	if (errno != EEXIST)
+	    Logger->Log("# SMSegment %s create: %s\n", Name, strerror(errno));
+	return false;
+    }
+    // umask would otherwise keep other users out.
+    fchmod(fd, 0666);
+
+    if (ftruncate(fd, (off_t) fSize) < 0)
+    {
+	Logger->Log("# SMSegment %s size: %s\n", Name, strerror(errno));
+	close(fd);
+	shm_unlink(Path.c_str());
+	return false;
+    }
+
+    p = mmap(NULL, fSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+	Logger->Log("# SMSegment %s map: %s\n", Name, strerror(errno));
+	shm_unlink(Path.c_str());
+	return false;
+    }
+    fBase = (uint8_t *) p;
+
+    // ftruncate zero filled it.
+    Head()->Type    = Type;
+    Head()->Version = Version;
+    Head()->Size    = fSize;
+    fError = false;
+    SET_DEBUG_STACK;
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Publish
+ *
+ * Description : Magic last, with release ordering, so a consumer
+ *     that sees it also sees the initialized body.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMSegment::Publish(void)
+{
+    if (fBase)
+    {
+	__atomic_store_n(&Head()->Magic, kMagic, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Attach
+ *
+ * Description : Consumer side, map the whole object and check it.
+ *
+ * Inputs :
+ *     Name    - no leading /
+ *     Type    - expected kType...
+ *     Version - expected layout version
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : missing or wrong segment, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Attach(const char *Name, uint32_t Type, uint32_t Version)
+{
+    SET_DEBUG_STACK;
+    CLogger     *Logger = CLogger::GetThis();
+    string      Path    = string("/") + Name;
+    struct stat st;
+    void        *p;
+    int         fd;
+
+    fName  = Name;
+    fError = true;
+
+    fd = shm_open(Path.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+	Logger->Log("# SMSegment %s attach: %s\n", Name, strerror(errno));
+	return false;
+    }
+    if ((fstat(fd, &st) < 0) || ((size_t) st.st_size < kHeaderSize))
+    {
+	Logger->Log("# SMSegment %s too small.\n", Name);
+	close(fd);
+	return false;
+    }
+    fSize = (size_t) st.st_size;
+
+    p = mmap(NULL, fSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+	Logger->Log("# SMSegment %s map: %s\n", Name, strerror(errno));
+	return false;
+    }
+    fBase = (uint8_t *) p;
+
+    if (__atomic_load_n(&Head()->Magic, __ATOMIC_ACQUIRE) != kMagic)
+    {
+	Logger->Log("# SMSegment %s not ready.\n", Name);
+	return false;
+    }
+    if ((Head()->Type != Type) || (Head()->Version != Version) ||
+	(Head()->Size != fSize))
+    {
+	Logger->Log("# SMSegment %s type %u version %u, expected %u %u.\n",
+		    Name, Head()->Type, Head()->Version, Type, Version);
+	return false;
+    }
+    fError = false;
+    SET_DEBUG_STACK;
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Notify
+ *
+ * Description : Bump Wake, then look at Waiters. A consumer bumps
+ *     Waiters before it reads Wake, all sequentially consistent, so
+ *     either we see the waiter or it sees the new Wake and does not
+ *     sleep.
+ *
+ * Inputs : NONE
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMSegment::Notify(void)
+{
+    if (!fBase)
+	return;
+
+    if (fEntry >= 0)
+	SMRegistry::GetThis()->Touch(fEntry);
+    __atomic_add_fetch(&Head()->Wake, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&Head()->Waiters, __ATOMIC_SEQ_CST) != 0)
+    {
+	syscall(SYS_futex, &Head()->Wake, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Wait
+ *
+ * Description : Take Wake, test Ready, sleep on the futex while
+ *     Wake has not moved. The deadline is absolute on
+ *     CLOCK_MONOTONIC so spurious wakeups do not stretch it.
+ *
+ * Inputs : TimeoutMS - longest wait, milliseconds
+ *
+ * Returns : Ready at the end
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Wait(uint32_t TimeoutMS)
+{
+    struct timespec Deadline;
+    uint32_t        w;
+    long            rc;
+
+    if (!fBase)
+	return false;
+    if (Ready())
+	return true;
+
+    clock_gettime(CLOCK_MONOTONIC, &Deadline);
+    Deadline.tv_sec  += TimeoutMS / 1000;
+    Deadline.tv_nsec += (long)(TimeoutMS % 1000) * 1000000L;
+    if (Deadline.tv_nsec >= 1000000000L)
+    {
+	Deadline.tv_sec++;
+	Deadline.tv_nsec -= 1000000000L;
+    }
+
+    __atomic_add_fetch(&Head()->Waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;)
+    {
+	w = __atomic_load_n(&Head()->Wake, __ATOMIC_SEQ_CST);
+	if (Ready())
+	    break;
+	// Returns at once with EAGAIN if Wake moved after the load.
+	rc = syscall(SYS_futex, &Head()->Wake, FUTEX_WAIT_BITSET, w,
+		     &Deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+	if ((rc < 0) && ((errno == ETIMEDOUT) || (errno == EINTR)))
+	    break;
+    }
+    __atomic_sub_fetch(&Head()->Waiters, 1, __ATOMIC_SEQ_CST);
+    return Ready();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Open
+ *
+ * Description : Make, or if the name exists wait up to a second
+ *     for its creator to Publish and Attach. A segment still not
+ *     published by then was left by a creator that died half way,
+ *     it is unlinked and made again.
+ *
+ * Inputs :
+ *     Name     - no leading /
+ *     Type     - kType...
+ *     Version  - layout version
+ *     BodySize - bytes after the header
+ *     Created  - set true if this call made it
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : as Make and Attach
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Open(const char *Name, uint32_t Type, uint32_t Version,
+		     size_t BodySize, bool &Created)
+{
+    SET_DEBUG_STACK;
+    const struct timespec Poll = {0, 10000000L};
+    string   Path = string("/") + Name;
+    Header   *h;
+    uint32_t Magic;
+    int      i, fd;
+
+    Created = false;
+    if (Make(Name, Type, Version, BodySize))
+    {
+	Created = true;
+	return true;
+    }
+    if (errno != EEXIST)
+	return false;
+
+    for (i = 0; i < 100; i++)
+    {
+	Magic = 0;
+	fd = shm_open(Path.c_str(), O_RDONLY, 0);
+	if (fd >= 0)
+	{
+	    h = (Header *) mmap(NULL, kHeaderSize, PROT_READ, MAP_SHARED, fd, 0);
+	    close(fd);
+	    if (h != MAP_FAILED)
+	    {
+		Magic = __atomic_load_n(&h->Magic, __ATOMIC_ACQUIRE);
+		munmap(h, kHeaderSize);
+	    }
+	}
+	if (Magic == kMagic)
+	    return Attach(Name, Type, Version);
+	nanosleep(&Poll, NULL);
+    }
+
+    CLogger::GetThis()->Log("# SMSegment %s never published, remade.\n", Name);
+    shm_unlink(Path.c_str());
+    if (Make(Name, Type, Version, BodySize))
+    {
+	Created = true;
+	return true;
+    }
+    return false;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Register
+ *
+ * Description : Producer, list this segment and its record layout
+ *     in the registry.
+ *
+ * Inputs :
+ *     Schema - record layout
+ *     Rate   - Hz, 0 if irregular
+ *
+ * Returns : true if listed
+ *
+ * Error Conditions : logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Register(const SMSchema &Schema, double Rate)
+{
+    SET_DEBUG_STACK;
+    SMRegistry *Registry;
+
+    if (!fBase || !fOwner || (fEntry >= 0))
+	return false;
+    Registry = SMRegistry::GetThis();
+    if (!Registry)
+	return false;
+
+    fEntry = Registry->Add(Name(), Head()->Type, Schema, Rate);
+    if (fEntry < 0)
+    {
+	CLogger::GetThis()->Log("# SMSegment %s not registered.\n", Name());
+	return false;
+    }
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SetRate
+ *
+ * Description : Producer, new nominal rate in the registry.
+ *
+ * Inputs : Rate - Hz, 0 if irregular
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMSegment::SetRate(double Rate)
+{
+    if (fEntry >= 0)
+	SMRegistry::GetThis()->SetRate(fEntry, Rate);
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Expect
+ *
+ * Description : Consumer, compare the registered schema hash and
+ *     record size with ours.
+ *
+ * Inputs : Schema - the layout this side was built with
+ *
+ * Returns : false on a mismatch
+ *
+ * Error Conditions : mismatch sets fError, logged
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSegment::Expect(const SMSchema &Schema)
+{
+    SET_DEBUG_STACK;
+    SMRegistry       *Registry = SMRegistry::GetThis();
+    SMRegistry::Info Entry;
+
+    if (fError)
+	return false;
+    if (!Registry || !Registry->Find(Name(), Entry))
+    {
+	CLogger::GetThis()->Log("# SMSegment %s not registered, %s unchecked.\n",
+				Name(), Schema.Record());
+	return true;
+    }
+    if ((Entry.SchemaHash != Schema.Hash()) ||
+	(Entry.RecordSize != Schema.Size()))
+    {
+	CLogger::GetThis()->Log(
+	    "# SMSegment %s is %s %u bytes hash %08x, expected %s %u %08x.\n",
+	    Name(), Entry.Record, Entry.RecordSize, Entry.SchemaHash,
+	    Schema.Record(), (uint32_t) Schema.Size(), Schema.Hash());
+	fError = true;
+	return false;
+    }
+    return true;
+}
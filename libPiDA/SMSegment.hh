@@ -0,0 +1,245 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMSegment.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Base for the libPiDA shared memory segments. Maps a
+ *     POSIX shared memory object "/<Name>" with a 64 byte header,
+ *
+ *         offset  0  uint32 Magic    kMagic once the body is ready
+ *                 4  uint32 Type     kTypeRing, kTypeSnapshot, ...
+ *                 8  uint32 Version  layout version of that type
+ *                12  uint32 Reserved
+ *                16  uint64 Size     bytes mapped, header included
+ *                24  uint32 Wake     futex word, bumped by Notify
+ *                28  uint32 Waiters  consumers blocked in Wait
+ *
+ *     followed by the body laid out by the derived class. The
+ *     producer creates the segment, any stale copy is unlinked
+ *     first, and unlinks it again when it is destroyed. Consumers
+ *     attach and check Magic and Type before using the body.
+ *
+ *     Unlike SharedMem2 there is no semaphore, the derived classes
+ *     use lock free protocols on words inside the body.
+ *
+ *     Instead of sleeping a fixed time between polls a consumer can
+ *     block in Wait until the producer's next Put, or a timeout.
+ *     The producer bumps Wake on every Put and only makes the
+ *     FUTEX_WAKE system call when Waiters is non zero, so with
+ *     nobody waiting a Put stays free of system calls.
+ *
+ *     A producer may Register the segment with its record layout in
+ *     the machine's SMRegistry, a consumer then Expects the layout
+ *     it was built with and fails at attach time if they differ.
+ *
+ * Restrictions/Limitations :
+ *     Producer and consumers on the same machine, same ABI.
+ *     A consumer keeps the mapping of the producer it attached to,
+ *     if the producer restarts it must attach again.
+ *     A consumer killed inside Wait leaves Waiters counted, the
+ *     producer then makes a harmless FUTEX_WAKE on every Put.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Wake/Waiters futex words, Wait and Notify. 
+ * 17-Oct-26  CBL  Register in, and check against, SMRegistry. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     man shm_overview(7)
+ *     man futex(2)
+ *
+ *******************************************************************
+ */
+#ifndef __SMSEGMENT_hh_
+#define __SMSEGMENT_hh_
+#    include <stdint.h>
+#    include <stddef.h>
+#    include <string>
+#    include "SMSchema.hh"
+
+/// SMSegment - mapped, typed POSIX shared memory object.
+class SMSegment {
+public:
+    /*! Segment types, Header.Type */
+    enum {kTypeRing=1, kTypeSnapshot, kTypeCommand, kTypeRegistry};
+
+    /*! Header.Magic, "PiDA" */
+    static const uint32_t kMagic = 0x41446950;
+
+    /*! Header size, the body starts here. */
+    static const size_t kHeaderSize = 64;
+
+    /// Unmap, the producer also unlinks.
+    virtual ~SMSegment(void);
+
+    /*! true if the segment could not be created or attached. */
+    inline bool CheckError(void) const {return fError;};
+
+    /*! Name without the leading / */
+    inline const char* Name(void) const {return fName.c_str();};
+
+    /*! true in the process that created the segment. */
+    inline bool Owner(void) const {return fOwner;};
+
+    /*!
+     * Description:
+     *   Consumer. Block until there is something to read, the
+     *   producer's next Put, a signal or the timeout.
+     *
+     * Arguments:
+     *   TimeoutMS - longest wait, milliseconds
+     *
+     * Returns:
+     *   true if there is data to read, Ready.
+     *
+     * Errors:
+     *   NONE, false on timeout or signal.
+     */
+    bool Wait(uint32_t TimeoutMS);
+
+    /*!
+     * Description:
+     *   Producer. List the segment in the registry with the layout
+     *   of its records. Each Put then counts and stamps the entry.
+     *
+     * Arguments:
+     *   Schema - record layout
+     *   Rate   - nominal Puts a second, 0 if irregular
+     *
+     * Returns:
+     *   true if listed
+     *
+     * Errors:
+     *   No registry or registry full, logged. The segment works
+     *   regardless.
+     */
+    bool Register(const SMSchema &Schema, double Rate);
+
+    /*! Producer, change the rate in the registry entry. */
+    void SetRate(double Rate);
+
+    /*!
+     * Description:
+     *   Consumer. Check the producer's registered layout against
+     *   the one this side was built with.
+     *
+     * Arguments:
+     *   Schema - expected record layout
+     *
+     * Returns:
+     *   false, and CheckError true, if the producer registered a
+     *   different layout. true if they match or the producer did
+     *   not register, the latter logged.
+     *
+     * Errors:
+     *   logged
+     */
+    bool Expect(const SMSchema &Schema);
+
+protected:
+    /*! Layout at offset 0. */
+    struct Header {
+	uint32_t Magic;
+	uint32_t Type;
+	uint32_t Version;
+	uint32_t Reserved;
+	uint64_t Size;
+	uint32_t Wake;
+	uint32_t Waiters;
+    };
+
+    SMSegment(void);
+
+    /*!
+     * Description:
+     *   Producer side. Create and map Name with BodySize bytes of
+     *   zeroed body. The segment is not visible to Attach until
+     *   Publish.
+     *
+     * Arguments:
+     *   Name     - segment name, no leading /
+     *   Type     - kType...
+     *   Version  - layout version
+     *   BodySize - bytes after the header
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   shm_open, ftruncate or mmap failure, logged, sets fError.
+     */
+    bool Create(const char *Name, uint32_t Type, uint32_t Version,
+		size_t BodySize);
+
+    /*! Producer side, body initialized, let consumers in. */
+    void Publish(void);
+
+    /*!
+     * Description:
+     *   Consumer side. Map an existing segment read/write and
+     *   check it is a published segment of the right type.
+     *
+     * Arguments:
+     *   Name    - segment name, no leading /
+     *   Type    - expected kType...
+     *   Version - expected layout version
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   Missing, unpublished or mismatched segment, sets fError.
+     */
+    bool Attach(const char *Name, uint32_t Type, uint32_t Version);
+
+    /*!
+     * Description:
+     *   Shared segments with no single producer. Create Name if it
+     *   does not exist, otherwise wait for whoever created it to
+     *   Publish and Attach. Never unlinked.
+     *
+     * Arguments:
+     *   Name, Type, Version, BodySize - as Create
+     *   Created - true if this call made it, initialize the body
+     *             and Publish.
+     *
+     * Returns:
+     *   true on success
+     *
+     * Errors:
+     *   as Create and Attach.
+     */
+    bool Open(const char *Name, uint32_t Type, uint32_t Version,
+	      size_t BodySize, bool &Created);
+
+    /*! Producer, after each Put, wake anybody in Wait. */
+    void Notify(void);
+
+    /*! Consumer, true if this reader has data to take. */
+    virtual bool Ready(void) const = 0;
+
+    /*! Start of the body. */
+    inline uint8_t* Body(void) const {return fBase + kHeaderSize;};
+
+    /*! Bytes in the body. */
+    inline size_t BodySize(void) const {return fSize - kHeaderSize;};
+
+    bool        fError;
+
+private:
+    std::string fName;
+    bool        fOwner;
+    uint8_t     *fBase;
+    size_t      fSize;
+    int         fEntry;     // registry entry, -1 if not registered
+
+    bool Make(const char *Name, uint32_t Type, uint32_t Version,
+	      size_t BodySize);
+
+    /*! Header at the start of the mapping. */
+    inline Header* Head(void) const {return (Header *) fBase;};
+};
+#endif
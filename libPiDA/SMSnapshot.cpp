@@ -0,0 +1,280 @@
+/********************************************************************
+ *
+ * Module Name : SMSnapshot.cpp
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Latest record with a generation counter.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Seqlock, no semaphore. 
+ * 17-Oct-26  CBL  Notify after each Put. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *     H. Boehm, "Can Seqlocks Get Along With Programming Language
+ *     Memory Models?", MSPC 2012, for the fence placement.
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <ctime>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SMSnapshot.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMSnapshot producer constructor
+ *
+ * Description : Create the segment, publish.
+ *
+ * Inputs :
+ *     Name       - segment name
+ *     RecordSize - bytes in the record
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true on failure.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMSnapshot::SMSnapshot(const char *Name, size_t RecordSize) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    fSnap       = NULL;
+    fRecord     = NULL;
+    fRecordSize = RecordSize;
+    fLast       = 0;
+    fSkipped    = 0;
+    fTorn       = 0;
+
+    if (!Create(Name, kTypeSnapshot, kVersion, kSnapHeaderSize + RecordSize))
+    {
+	return;
+    }
+    fSnap   = (SnapHeader *) Body();
+    fRecord = Body() + kSnapHeaderSize;
+    fSnap->RecordSize = (uint32_t) RecordSize;
+    fSnap->Seq.store(0, std::memory_order_relaxed);
+    Publish();
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SMSnapshot consumer constructor
+ *
+ * Description : Attach to the segment.
+ *
+ * Inputs : Name - segment name
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : CheckError true on failure.
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SMSnapshot::SMSnapshot(const char *Name) : SMSegment()
+{
+    SET_DEBUG_STACK;
+    fSnap       = NULL;
+    fRecord     = NULL;
+    fRecordSize = 0;
+    fLast       = 0;
+    fSkipped    = 0;
+    fTorn       = 0;
+
+    if (!Attach(Name, kTypeSnapshot, kVersion))
+    {
+	return;
+    }
+    fSnap       = (SnapHeader *) Body();
+    fRecord     = Body() + kSnapHeaderSize;
+    fRecordSize = fSnap->RecordSize;
+    if (kSnapHeaderSize + fRecordSize > BodySize())
+    {
+	CLogger::GetThis()->Log("# SMSnapshot %s bad geometry.\n", Name);
+	fSnap  = NULL;
+	fError = true;
+    }
+    SET_DEBUG_STACK;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Put
+ *
+ * Description : Seq odd, copy, Seq even. A reader that saw the
+ *     odd value or a different even value throws its copy away.
+ *     No waiting, no system calls apart from the clock unless a
+ *     consumer is blocked in Wait.
+ *
+ * Inputs : Record - RecordSize bytes
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SMSnapshot::Put(const void *Record)
+{
+    struct timespec now;
+    uint64_t s;
+
+    if (!fSnap)
+	return;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    s = fSnap->Seq.load(std::memory_order_relaxed);
+    fSnap->Seq.store(s+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(fRecord, Record, fRecordSize);
+    fSnap->UpdateTime.store((uint64_t) now.tv_sec*1000000000ULL + now.tv_nsec,
+			    std::memory_order_relaxed);
+    fSnap->Seq.store(s+2, std::memory_order_release);
+    Notify();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Get
+ *
+ * Description : Compare the generation with the last one taken,
+ *     only copy if it moved. The copy is kept if Seq was even and
+ *     unchanged across it, otherwise retry, at most kMaxRetry
+ *     times.
+ *
+ * Inputs : Record - RecordSize bytes, user supplied
+ *
+ * Returns : true if a new record was copied
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SMSnapshot::Get(void *Record)
+{
+    uint64_t s1, s2, g;
+    uint32_t i;
+
+    if (!fSnap)
+	return false;
+
+    for (i = 0; ; i++)
+    {
+	s1 = fSnap->Seq.load(std::memory_order_acquire);
+	if ((s1>>1) == fLast)
+	    return false;
+	if ((s1 & 1) == 0)
+	{
+	    memcpy(Record, fRecord, fRecordSize);
+	    std::atomic_thread_fence(std::memory_order_acquire);
+	    s2 = fSnap->Seq.load(std::memory_order_relaxed);
+	    if (s2 == s1)
+		break;
+	}
+	fTorn++;
+	if (i >= kMaxRetry)
+	    return false;
+    }
+    g = s1>>1;
+
+    // Nothing to skip on the first read.
+    if ((fLast > 0) && (g > fLast+1))
+	fSkipped += g - fLast - 1;
+    fLast = g;
+    return true;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Generation
+ *
+ * Description : Puts so far.
+ *
+ * Inputs : NONE
+ *
+ * Returns : generation
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint64_t SMSnapshot::Generation(void) const
+{
+    return fSnap ? (fSnap->Seq.load(std::memory_order_acquire)>>1) : 0;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : UpdateTime
+ *
+ * Description : Time of the last Put.
+ *
+ * Inputs : NONE
+ *
+ * Returns : CLOCK_REALTIME, zero before the first Put
+ *
+ * Error Conditions : NONE
+ *
+ * Unit Tested on:
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+struct timespec SMSnapshot::UpdateTime(void) const
+{
+    struct timespec rv = {0, 0};
+    uint64_t ns;
+    if (fSnap)
+    {
+	ns = fSnap->UpdateTime.load(std::memory_order_relaxed);
+	rv.tv_sec  = (time_t)(ns / 1000000000ULL);
+	rv.tv_nsec = (long)  (ns % 1000000000ULL);
+    }
+    return rv;
+}
@@ -0,0 +1,139 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SMSnapshot.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Shared memory segment holding the latest copy of
+ *     one fixed size record, e.g. a GGA, with a generation counter
+ *     the producer bumps on every Put. There is no LAM, each reader
+ *     remembers the last generation it took, so any number of
+ *     readers see every update without clearing a flag under each
+ *     other. 
+ *
+ *     Body layout, after the SMSegment header,
+ *
+ *         offset  0  uint64 Seq         2g+1 while Put g+1 is copying,
+ *                                       2g+2 when it is done
+ *                 8  uint64 UpdateTime  ns, CLOCK_REALTIME of the
+ *                                       last Put
+ *                16  uint32 RecordSize
+ *                64  record
+ *
+ *     The record is a seqlock, there is no semaphore. The producer
+ *     makes Seq odd, copies, makes it even. A reader copies between
+ *     two loads of Seq and retries if they differ or were odd. The
+ *     producer never waits on a reader, a reader that dies mid copy
+ *     leaves nothing held, and a reader only retries while a Put is
+ *     in progress. The generation is Seq/2.
+ *
+ * Restrictions/Limitations :
+ *     One producer per segment.
+ *     Get gives up after kMaxRetry torn copies and returns false.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Seqlock in place of the semaphore, version 2. 
+ * 17-Oct-26  CBL  Put wakes consumers blocked in Wait. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SMSNAPSHOT_hh_
+#define __SMSNAPSHOT_hh_
+#    include <atomic>
+#    include "SMSegment.hh"
+
+/// SMSnapshot - latest record plus a generation counter.
+class SMSnapshot : public SMSegment {
+public:
+    /*! Snapshot layout version, Header.Version */
+    static const uint32_t kVersion = 2;
+
+    /*! Torn copies Get tolerates before giving up. */
+    static const uint32_t kMaxRetry = 1000;
+
+    /// Producer.
+    SMSnapshot(const char *Name, size_t RecordSize);
+
+    /// Consumer, the first Get returns whatever is there.
+    SMSnapshot(const char *Name);
+
+    /*!
+     * Description:
+     *   Producer. Replace the record and bump the generation.
+     *   Never blocks.
+     *
+     * Arguments:
+     *   Record - RecordSize bytes
+     *
+     * Returns:
+     *   NONE
+     *
+     * Errors:
+     *   NONE, ignored if the segment is not valid.
+     */
+    void Put(const void *Record);
+
+    /*!
+     * Description:
+     *   Consumer. Copy the record out if it changed since this
+     *   reader last took it.
+     *
+     * Arguments:
+     *   Record - RecordSize bytes, user supplied
+     *
+     * Returns:
+     *   true if a new record was copied, false if nothing changed
+     *   (Record is left alone, or partly overwritten if the retries
+     *   ran out).
+     *
+     * Errors:
+     *   NONE, Torn counts the retries.
+     */
+    bool Get(void *Record);
+
+    /*! Consumer, true if there is an update not yet taken. */
+    inline bool IsNew(void) const {return Generation() != fLast;};
+
+    /*! Puts so far. */
+    uint64_t Generation(void) const;
+
+    /*! Updates this reader never saw, overwritten between Gets. */
+    inline uint64_t Skipped(void) const {return fSkipped;};
+
+    /*! Copies this reader threw away because a Put overlapped them. */
+    inline uint64_t Torn(void) const {return fTorn;};
+
+    /*! Time of the last Put, CLOCK_REALTIME. */
+    struct timespec UpdateTime(void) const;
+
+    inline size_t RecordSize(void) const {return fRecordSize;};
+
+protected:
+    /*! Wait returns when there is a generation this reader has not taken. */
+    inline bool Ready(void) const {return IsNew();};
+
+private:
+    /*! Body header, see the layout above. */
+    struct SnapHeader {
+	std::atomic<uint64_t> Seq;
+	std::atomic<uint64_t> UpdateTime;
+	uint32_t RecordSize;
+    };
+    static const size_t kSnapHeaderSize = 64;
+
+    SnapHeader  *fSnap;
+    uint8_t     *fRecord;
+    size_t      fRecordSize;
+    uint64_t    fLast;      // generation this reader last took
+    uint64_t    fSkipped;
+    uint64_t    fTorn;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		  "SMSnapshot needs lock free 64 bit atomics");
+};
+#endif
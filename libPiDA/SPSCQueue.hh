@@ -0,0 +1,111 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SPSCQueue.hh
+ *
+ * Author/Date : C.B. Lirakis / 17-Oct-26
+ *
+ * Description : Bounded lock free single producer, single consumer
+ *     ring. One thread may Push and one other thread may Pop, no
+ *     locks, no system calls and no allocation after construction.
+ *     Push never blocks, it fails when the ring is full and the
+ *     caller decides what to do (count it).
+ *
+ *     head is written only by the consumer and tail only by the
+ *     producer. The producer publishes a slot with a release store
+ *     of tail after copying into it, the consumer acquires tail
+ *     before copying out, and the same the other way for head.
+ *     They live on separate cache lines so the two threads do not
+ *     fight over one line.
+ *
+ * Restrictions/Limitations :
+ *     N must be a power of two. The indices run freely and are
+ *     masked, so all N slots are usable.
+ *     T must be trivially copyable.
+ *
+ * Change Descriptions :
+ * 17-Oct-26  CBL  Moved to libPiDA, GTOP uses it too. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SPSCQUEUE_hh_
+#define __SPSCQUEUE_hh_
+#    include <stddef.h>
+#    include <atomic>
+#    include <type_traits>
+
+/// SPSCQueue - lock free single producer single consumer ring.
+template <typename T, size_t N>
+class SPSCQueue {
+    static_assert((N >= 2) && ((N & (N-1)) == 0),
+		  "SPSCQueue size must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+		  "SPSCQueue element must be trivially copyable");
+public:
+    /// Default Constructor
+    SPSCQueue(void) : fHead(0), fTail(0) {};
+
+    /*!
+     * Description:
+     *   Producer side, copy one element in.
+     *
+     * Arguments:
+     *   v - element to add
+     *
+     * Returns:
+     *   true if added, false if the ring is full.
+     *
+     * Errors:
+     *   NONE
+     */
+    inline bool Push(const T &v)
+    {
+	size_t t = fTail.load(std::memory_order_relaxed);
+	if (t - fHead.load(std::memory_order_acquire) >= N)
+	    return false;
+	fData[t & (N-1)] = v;
+	fTail.store(t+1, std::memory_order_release);
+	return true;
+    };
+
+    /*!
+     * Description:
+     *   Consumer side, copy the oldest element out.
+     *
+     * Arguments:
+     *   v - returned element
+     *
+     * Returns:
+     *   true if an element was returned, false if empty.
+     *
+     * Errors:
+     *   NONE
+     */
+    inline bool Pop(T &v)
+    {
+	size_t h = fHead.load(std::memory_order_relaxed);
+	if (h == fTail.load(std::memory_order_acquire))
+	    return false;
+	v = fData[h & (N-1)];
+	fHead.store(h+1, std::memory_order_release);
+	return true;
+    };
+
+    /*! Approximate number of elements waiting, exact from either end. */
+    inline size_t Size(void) const
+	{return fTail.load(std::memory_order_acquire) -
+		fHead.load(std::memory_order_acquire);};
+
+    /*! Maximum number of elements held. */
+    inline static size_t Capacity(void) {return N;};
+
+private:
+    alignas(64) std::atomic<size_t> fHead;  // next to Pop, consumer
+    alignas(64) std::atomic<size_t> fTail;  // next to Push, producer
+    alignas(64) T                   fData[N];
+};
+#endif